@@ -0,0 +1,139 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include "Civil.h"
+#include "Column.h"
+
+namespace chronos {
+// Calendar arithmetic on moments, in UTC, for intervals that aren't a fixed
+// number of seconds, such as a month.
+//
+// The time of day and the picoseconds are kept as they are, and only the date
+// moves. Adding months keeps the day of the month, except that a day past the
+// end of the new month is clamped to its last day, so that January 31 plus a
+// month is the last day of February. Years are 12 months, so a leap day plus
+// a year is February 28. Clamping means that adding a month and then another
+// can differ from adding two at once.
+//
+// Adding weekdays counts only Monday through Friday. A moment on a weekend is
+// first moved to the Friday before, when adding, or the Monday after, when
+// subtracting, so that one weekday after a Saturday is the Monday after it,
+// and one before it is the Friday before. Adding none leaves it where it is.
+//
+// As with ScalarUnit arithmetic, special values are unchanged, and results
+// beyond the range saturate to the infinity in their direction.
+
+namespace details {
+// More months, years, or weekdays than this pass beyond the range from
+// anywhere in it, so they needn't be counted.
+constexpr const int64_t MaxCalendarCount = int64_t{1} << 48;
+
+constexpr int64_t saturateCalendarCount(int64_t count) noexcept {
+  return std::clamp(count, -MaxCalendarCount - 1, MaxCalendarCount + 1);
+}
+
+// Gets the day a number of months from the given one, which is out of range
+// on the side of the count if it's too large.
+constexpr int64_t addMonthsToDays(int64_t days, int64_t months) noexcept {
+  if (months > MaxCalendarCount) return MaxCivilDays + 1;
+  if (months < -MaxCalendarCount) return -MaxCivilDays - 2;
+  CivilDate date = civilFromDays(days);
+  int64_t total = date.year * 12 + (date.month - 1) + months;
+  int64_t year = total / 12;
+  int month = static_cast<int>(total % 12) + 1;
+  if (month < 1) --year, month += 12;
+  if (year > MaxCivilYear || year < -MaxCivilYear)
+    return daysFromCivilSaturated(year, month, 1);
+  return daysFromCivil(
+      year, month, std::min(date.day, daysInMonth(year, month)));
+}
+
+// Gets the day a number of weekdays from the given one. 0001-01-01 was a
+// Monday, so the remainder by 7 is the day of the week, from Monday as 0.
+constexpr int64_t addWeekdaysToDays(int64_t days, int64_t count) noexcept {
+  if (count > MaxCalendarCount) return MaxCivilDays + 1;
+  if (count < -MaxCalendarCount) return -MaxCivilDays - 2;
+  int64_t weekday = days % 7;
+  if (weekday < 0) weekday += 7;
+  if (count > 0) {
+    if (weekday >= 5) days -= weekday - 4, weekday = 4;
+    int64_t rest = count % 5;
+    days += count / 5 * 7 + (weekday + rest >= 5 ? rest + 2 : rest);
+  } else if (count < 0) {
+    if (weekday >= 5) days += 7 - weekday, weekday = 0;
+    int64_t rest = -count % 5;
+    days -= -count / 5 * 7 + (weekday - rest < 0 ? rest + 2 : rest);
+  }
+  return days;
+}
+
+// Moves the date of a value by a shift of its days, keeping the time of day.
+template<typename Shift>
+constexpr UnitValue shiftDate(UnitValue sss, const Shift& shift) noexcept {
+  if (SecondsTraits<>::toCategory(sss.s) != Category::Num) return sss;
+  UnitSeconds secondOfDay = 0;
+  int64_t days = splitDays(floorSeconds(sss), secondOfDay);
+  return valueFromDays(shift(days), secondOfDay, sss.ss);
+}
+
+// Moves the dates of the n values of a column. Moments in a column tend to
+// come in runs on the same day, as when they're sorted or are events as they
+// happened, so the shift of the last day is kept, and the civil date is only
+// worked out again when the day changes.
+template<typename Shift>
+void shiftDates(UnitSeconds* s, UnitPicos* ss, std::size_t n,
+    const Shift& shift) noexcept {
+  int64_t fromDay = 0, toDay = shift(0);
+  for (std::size_t i = 0; i < n; ++i) {
+    if (SecondsTraits<>::toCategory(s[i]) != Category::Num) continue;
+    UnitValue sss{s[i], ss[i]};
+    UnitSeconds secondOfDay = 0;
+    int64_t days = splitDays(floorSeconds(sss), secondOfDay);
+    if (days != fromDay) fromDay = days, toDay = shift(days);
+    sss = valueFromDays(toDay, secondOfDay, sss.ss);
+    s[i] = sss.s, ss[i] = sss.ss;
+  }
+}
+} // namespace details
+
+template<typename Scalar>
+constexpr Moment<Scalar> addMonths(
+    const Moment<Scalar>& item, int64_t months) noexcept {
+  using namespace details;
+  return Moment<Scalar>(shiftDate(item.value(),
+      [months](int64_t days) { return addMonthsToDays(days, months); }));
+}
+
+template<typename Scalar>
+constexpr Moment<Scalar> addYears(
+    const Moment<Scalar>& item, int64_t years) noexcept {
+  return addMonths(item, details::saturateCalendarCount(years) * 12);
+}
+
+template<typename Scalar>
+constexpr Moment<Scalar> addWeekdays(
+    const Moment<Scalar>& item, int64_t count) noexcept {
+  using namespace details;
+  return Moment<Scalar>(shiftDate(item.value(),
+      [count](int64_t days) { return addWeekdaysToDays(days, count); }));
+}
+
+// The same, for every moment of a column at once.
+inline void addMonths(MomentColumn& column, int64_t months) noexcept {
+  using namespace details;
+  shiftDates(column.seconds(), column.subseconds(), column.size(),
+      [months](int64_t days) { return addMonthsToDays(days, months); });
+}
+
+inline void addYears(MomentColumn& column, int64_t years) noexcept {
+  addMonths(column, details::saturateCalendarCount(years) * 12);
+}
+
+inline void addWeekdays(MomentColumn& column, int64_t count) noexcept {
+  using namespace details;
+  shiftDates(column.seconds(), column.subseconds(), column.size(),
+      [count](int64_t days) { return addWeekdaysToDays(days, count); });
+}
+
+} // namespace chronos
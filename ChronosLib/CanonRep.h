@@ -1,10 +1,25 @@
 #pragma once
-#include <Ratio>
+#include <ratio>
 #include <algorithm>
 #include "Core.h"
+#include "StreamGuard.h"
 
 namespace chronos {
 namespace details {
+// Gets the finest power of 10 per second, up to picoseconds, whose fractions
+// fit in the type.
+template<typename Fractions>
+constexpr UnitPicos finestFractionsPerSecond() noexcept {
+  UnitPicos perSecond = PicosPerSecond;
+  while (perSecond - 1 > std::numeric_limits<Fractions>::max())
+    perSecond /= 10;
+  return perSecond;
+}
+
+template<typename Fractions>
+using DefaultFractionsToSeconds =
+    std::ratio<finestFractionsPerSecond<Fractions>(), 1>;
+
 // Canonical representation of linear time.
 //
 // Stores a signed count of seconds and subseconds, both 64 bits by default.
@@ -28,8 +43,15 @@ namespace details {
 // picoseconds). When they differ, this class scales them appropriately.
 // However the values are stored, they are always presented externally as
 // seconds and picoseconds. Smaller representations increase the likelihood of
-// overflowing to infinity, and a biased epoch may be necessary in order to
-// represent recent dates.
+// overflowing to infinity.
+//
+// Since small wholes can't reach recent dates from the de facto epoch, the
+// wholes may instead count from Epoch, which is given in seconds from the de
+// facto one and must be a multiple of the seconds per whole. The bias is a
+// constant, so it folds into the scaling at compile time. For example,
+// Unix32Rep uses 32-bit wholes centered between 1970 and 2106, covering that
+// whole span at nanosecond resolution in 8 bytes. The fractions keep the sign
+// of the unbiased value, so they're unaffected.
 //
 // The wholes and fractions can be specialized to use different sizes (or even
 // omitted) and how they are scaled is controlled by the two ratio
@@ -47,6 +69,15 @@ namespace details {
 // 127. However, any choice for this value that is not a power of 10 would
 // potentially cause rounding errors.
 //
+// Values are rounded to the nearest representable one when set, with ties
+// going away from zero, so that negative values round just like positive ones.
+// Every representable value reads back exactly. When a whole is more than a
+// second, a value that falls between wholes is rounded to the nearest whole,
+// losing its fractions, since the fractions can only hold what's under a
+// second. Both ratios must be integral, and the fractions must be no finer than
+// picoseconds. By default, FractionsToSeconds is the finest power of 10 that
+// fits in Fractions, so CanonRep<int32_t, int32_t> counts nanoseconds.
+//
 // NOTE: The ability to choose smaller (or void) representations is not fully
 // implemented or well-tested. It's a tuning feature, not a fundamental one.
 //
@@ -58,27 +89,59 @@ namespace details {
 // RepAdapter is specialized to work with it, as well.
 //
 // TODO: Modify to allow Wholes or Fractions to be void (or equivalent) and
-// ensure that it still works correctly. Finish the scaling code.
+// ensure that it still works correctly.
 template<typename Wholes = UnitSeconds, typename Fractions = UnitPicos,
     typename SecondsToWholes = std::ratio<1, 1>,
-    typename FractionsToSeconds = std::ratio<PicosPerSecond, 1>>
-class CanonRep : public SecondsTraits<Wholes> {
+    typename FractionsToSeconds = DefaultFractionsToSeconds<Fractions>,
+    UnitSeconds Epoch = 0>
+class CanonRep {
 public:
   using CanonRepT =
-      CanonRep<Wholes, Fractions, SecondsToWholes, FractionsToSeconds>;
+      CanonRep<Wholes, Fractions, SecondsToWholes, FractionsToSeconds, Epoch>;
   using WholesT = Wholes;
   using FractionsT = Fractions;
   using SecondsToWholesV = SecondsToWholes;
   using FractionsToSecondsV = FractionsToSeconds;
-
-  static constexpr const FractionsT maxFractions =
-      std::numeric_limits<Fractions>::max();
-  static constexpr const UnitPicos fractionsPerSecond =
-      std::min(PicosPerSecond - 1, static_cast<UnitPicos>(maxFractions)) + 1;
-  static constexpr const bool usesUnitSeconds =
-      std::is_same_v<UnitSeconds, Wholes>;
+  using Traits = SecondsTraits<Wholes>;
+
+  // The traits are mirrored instead of inherited. ScalarUnit derives from
+  // SecondsTraits<>, and two empty bases of the same type can't share an
+  // address, so inheriting them here would pad every scalar by 8 bytes or more.
+  static constexpr const Wholes InfP = Traits::InfP;
+  static constexpr const Wholes Max = Traits::Max;
+  static constexpr const Wholes Min = Traits::Min;
+  static constexpr const Wholes InfN = Traits::InfN;
+  static constexpr const Wholes NaN = Traits::NaN;
+
+  // Scaling constants.
+  static constexpr const UnitSeconds SecondsPerWhole = SecondsToWholes::num;
+  static constexpr const UnitPicos FractionsPerSecond = FractionsToSeconds::num;
+  static constexpr const bool exactFractions =
+      PicosPerSecond % FractionsPerSecond == 0;
+  static constexpr const UnitPicos PicosPerFraction =
+      PicosPerSecond / FractionsPerSecond;
+  static constexpr const UnitSeconds EpochSeconds = Epoch;
+  static constexpr const UnitSeconds EpochWholes = Epoch / SecondsPerWhole;
+  static constexpr const bool usesUnitSeconds = std::is_same_v<UnitSeconds,
+      Wholes> && SecondsPerWhole == 1 && Epoch == 0;
   static constexpr const bool usesUnitPicos =
-      std::is_same_v<UnitPicos, Fractions>;
+      std::is_same_v<UnitPicos, Fractions> && PicosPerFraction == 1;
+  // However they're scaled or biased, the wholes only grow with the value, and
+  // the fractions never take it past the next whole, so the raw fields order
+  // just as the values do.
+  static constexpr const bool rawComparable = true;
+
+  // The numeric range of the wholes, which is narrower than the traits allow
+  // when the seconds they scale up to, after adding the epoch, wouldn't fit.
+  // Without an epoch, the range is symmetric.
+  static constexpr const Wholes MaxWholes =
+      static_cast<Wholes>(std::min<UnitSeconds>(Max,
+          (SecondsTraits<>::Max - std::max<UnitSeconds>(Epoch, 0)) /
+              SecondsPerWhole));
+  static constexpr const Wholes MinWholes =
+      static_cast<Wholes>(-std::min<UnitSeconds>(Max,
+          (SecondsTraits<>::Max + std::min<UnitSeconds>(Epoch, 0)) /
+              SecondsPerWhole));
 
   static_assert(
       std::numeric_limits<Wholes>::is_signed, "Wholes must be signed");
@@ -88,6 +151,16 @@ public:
       std::numeric_limits<Fractions>::is_signed, "Fractions must be signed");
   static_assert(
       std::numeric_limits<Fractions>::is_integer, "Fractions must be integral");
+  static_assert(SecondsToWholes::den == 1 && SecondsPerWhole > 0,
+      "Wholes must be a whole number of seconds");
+  static_assert(FractionsToSeconds::den == 1 && FractionsPerSecond > 0 &&
+          FractionsPerSecond <= PicosPerSecond,
+      "Fractions must be a whole number per second, up to picoseconds");
+  static_assert(FractionsPerSecond - 1 <= std::numeric_limits<Fractions>::max(),
+      "Fractions must hold up to a second's worth");
+  static_assert(Epoch % SecondsPerWhole == 0 &&
+          Epoch > SecondsTraits<>::Min && Epoch < SecondsTraits<>::Max,
+      "Epoch must be a whole number of wholes");
 
 private:
   // Fields.
@@ -112,7 +185,7 @@ public:
   // Properties.
   constexpr UnitSeconds seconds() const noexcept { return calcSeconds(); }
   constexpr void seconds(UnitSeconds s) noexcept {
-    *this = create(s, fractions());
+    *this = create(s, subseconds());
   }
 
   constexpr UnitPicos subseconds() const noexcept { return calcPicos(); }
@@ -128,9 +201,18 @@ public:
   }
   constexpr void value(const UnitValue& sss) noexcept { *this = create(sss); }
 
+  // Whether the value is negative, which, with an epoch, depends on more than
+  // the sign of the wholes.
+  constexpr bool isNegative() const noexcept {
+    if constexpr (Epoch == 0)
+      return m_wholes < 0 || m_fractions < 0;
+    else
+      return calcSeconds() < 0 || m_fractions < 0;
+  }
+
   // Internal properties.
   constexpr Wholes wholes() const noexcept { return m_wholes; }
-  constexpr void wholes(Fractions f) noexcept { m_wholes = f; }
+  constexpr void wholes(Wholes w) noexcept { m_wholes = w; }
 
   constexpr Fractions fractions() const noexcept { return m_fractions; }
   constexpr void fractions(Fractions f) noexcept { m_fractions = f; }
@@ -161,65 +243,115 @@ private:
     UnitSeconds s = sss.s;
     UnitPicos ss = sss.ss;
     // Nobody puts NaN in a corner.
-    if (s == SecondsTraits<>::NaN) return createRaw(NaN, 0);
+    if (s == SecondsTraits<>::NaN) return CanonRep(Raw::raw, NaN, 0);
     // Roll over excess subseconds.
-    if (ss <= -PicosPerSecond || ss >= PicosPerSecond)
-      if (addSafely(s, ss / PicosPerSecond, s))
-        return createRaw(s, ss % PicosPerSecond);
-      else
-        return createRaw((s < 0) ? InfN : InfP, 0);
-    // Saturate to infinity, with scaling.
-    if (s > Max) return createRaw(InfP, 0);
-    if (s < Min) return createRaw(InfN, 0);
-    return createRaw(s, ss);
+    if (ss <= -PicosPerSecond || ss >= PicosPerSecond) {
+      if (!addSafely(s, ss / PicosPerSecond, s)) return saturate(ss < 0);
+      ss %= PicosPerSecond;
+    }
+    // Scale the subseconds, which may round up to a whole second.
+    UnitPicos f = calcFractions(ss);
+    if (f == FractionsPerSecond || f == -FractionsPerSecond) {
+      if (!addSafely(s, f / FractionsPerSecond, s)) return saturate(f < 0);
+      f = 0;
+    }
+    // Scale the seconds and take out the epoch, then saturate to infinity.
+    UnitSeconds w = calcWholes(s, f);
+    if constexpr (Epoch != 0) {
+      if (!addSafely(w, -EpochWholes, w)) return saturate(EpochWholes > 0);
+    }
+    if (w > MaxWholes) return saturate(false);
+    if (w < MinWholes) return saturate(true);
+    return CanonRep(
+        Raw::raw, static_cast<Wholes>(w), static_cast<Fractions>(f));
   }
 
-  static constexpr CanonRep createRaw(UnitSeconds s, UnitPicos ss) noexcept {
-    Wholes w = calcWholes(s);
-    Fractions f = calcFractions(ss);
-    return CanonRep(Raw::raw, w, f);
+  static constexpr CanonRep saturate(bool neg) noexcept {
+    return CanonRep(Raw::raw, neg ? InfN : InfP, 0);
   }
 
-  static constexpr Wholes calcWholes(UnitSeconds s) noexcept {
-    // TODO: Scale.
-    return static_cast<Wholes>(s);
+  // Divides, rounding to the nearest, with ties away from zero.
+  static constexpr int64_t divRound(int64_t n, int64_t d) noexcept {
+    int64_t q = n / d, r = n % d;
+    if (2 * (r < 0 ? -r : r) >= d) q += (n < 0) ? -1 : 1;
+    return q;
+  }
+
+  // Multiplies, then divides, rounding as above. The product is 128 bits.
+  static constexpr int64_t mulDivRound(
+      int64_t n, int64_t m, int64_t d) noexcept {
+    int64_t lo, hi = mul128(n, m, lo), q = 0;
+    int64_t r = div128(hi, lo, d, q);
+    if (2 * (r < 0 ? -r : r) >= d) q += (n < 0) ? -1 : 1;
+    return q;
+  }
+
+  // Scales seconds to wholes. Rounding a value that falls between wholes
+  // uses up the fractions, so they're cleared.
+  static constexpr UnitSeconds calcWholes(
+      UnitSeconds s, UnitPicos& f) noexcept {
+    if constexpr (SecondsPerWhole == 1)
+      return s;
+    else {
+      UnitSeconds w = s / SecondsPerWhole, r = s % SecondsPerWhole;
+      if (!r) return w;
+      // Round away when the remainder, plus the fractions, is at least half a
+      // whole. Since the fractions are under a second, they can only tip the
+      // balance when the remainder is within a second of half.
+      UnitSeconds gap = SecondsPerWhole - 2 * (r < 0 ? -r : r);
+      bool away = gap <= 0 ||
+          (gap == 1 && 2 * (f < 0 ? -f : f) >= FractionsPerSecond);
+      f = 0;
+      return away ? w + ((s < 0) ? -1 : 1) : w;
+    }
   }
 
   constexpr UnitSeconds calcSeconds() const noexcept {
     UnitSeconds s = m_wholes;
-    // If necessary, scale infinities up.
+    // If necessary, scale infinities up and numbers by the whole, then put
+    // back the epoch.
     if constexpr (!usesUnitSeconds) {
-      if (m_wholes > Max)
+      if (m_wholes > MaxWholes)
         s = SecondsTraits<>::InfP;
-      else if (m_wholes < Min) {
+      else if (m_wholes < MinWholes) {
         if (m_wholes == NaN)
           s = SecondsTraits<>::NaN;
         else
           s = SecondsTraits<>::InfN;
-      }
+      } else
+        s = s * SecondsPerWhole + Epoch;
     }
     return s;
   }
 
-  static constexpr Fractions calcFractions(UnitPicos p) {
-    if constexpr (usesUnitPicos)
-      return static_cast<Fractions>(p);
-    else {
-      // TODO: Scale.
-      return static_cast<Fractions>(p);
-    }
+  // Scales subseconds, which must be under a second, to fractions.
+  static constexpr UnitPicos calcFractions(UnitPicos p) noexcept {
+    if constexpr (PicosPerFraction == 1 && exactFractions)
+      return p;
+    else if constexpr (exactFractions)
+      return divRound(p, PicosPerFraction);
+    else
+      return mulDivRound(p, FractionsPerSecond, PicosPerSecond);
   }
 
   constexpr UnitPicos calcPicos() const noexcept {
-    UnitPicos p = m_fractions;
-    if constexpr (!usesUnitPicos) {
-      // TODO: Scale.
-    }
-    return p;
+    UnitPicos f = m_fractions;
+    if constexpr (PicosPerFraction == 1 && exactFractions)
+      return f;
+    else if constexpr (exactFractions)
+      return f * PicosPerFraction;
+    else
+      return mulDivRound(f, PicosPerSecond, FractionsPerSecond);
   }
 };
 
 using DefaultBaseRep = CanonRep<UnitSeconds, UnitPicos>;
+
+// Seconds and nanoseconds, in 32 bits each, for moments from the Unix epoch
+// through early 2106. The wholes are centered on the middle of that span.
+using Unix32Rep = CanonRep<int32_t, int32_t, std::ratio<1, 1>,
+    DefaultFractionsToSeconds<int32_t>,
+    UnixEpochSeconds + SecondsTraits<int32_t>::Max>;
 } // namespace details
 } // namespace chronos
 
@@ -230,29 +362,35 @@ using DefaultBaseRep = CanonRep<UnitSeconds, UnitPicos>;
 // layering the const-only class as the  base, with the child taking the type
 // to return.
 template<typename Wholes, typename Fractions, typename SecondsToWholes,
-    typename FractionsToSeconds>
+    typename FractionsToSeconds, chronos::UnitSeconds Epoch>
 class std::numeric_limits<chronos::details::CanonRep<Wholes, Fractions,
-    SecondsToWholes, FractionsToSeconds>> {
+    SecondsToWholes, FractionsToSeconds, Epoch>> {
 public:
   using CanonRepT = chronos::details::CanonRep<Wholes, Fractions,
-      SecondsToWholes, FractionsToSeconds>;
+      SecondsToWholes, FractionsToSeconds, Epoch>;
   using SecondsT = typename CanonRepT::WholesT;
   using FractionsT = typename CanonRepT::FractionsT;
 
+  // With an epoch, the extremes may be on the same side of it, in which case
+  // the fractions can't take the opposite sign.
   [[nodiscard]] static constexpr CanonRepT(min)() noexcept {
-    return CanonRepT(
-        CanonRepT::Raw::raw, CanonRepT::Min, FractionsToSeconds::Num - 1);
+    return CanonRepT(CanonRepT::Raw::raw, CanonRepT::MinWholes,
+        (CanonRepT::MinWholes + CanonRepT::EpochWholes > 0)
+            ? 0
+            : -static_cast<FractionsT>(CanonRepT::FractionsPerSecond - 1));
   }
 
   [[nodiscard]] static constexpr CanonRepT(max)() noexcept {
-    return CanonRepT(
-        CanonRepT::Raw::raw, CanonRepT::Max, FractionsToSeconds::Num - 1);
+    return CanonRepT(CanonRepT::Raw::raw, CanonRepT::MaxWholes,
+        (CanonRepT::MaxWholes + CanonRepT::EpochWholes < 0)
+            ? 0
+            : static_cast<FractionsT>(CanonRepT::FractionsPerSecond - 1));
   }
 
   [[nodiscard]] static constexpr CanonRepT lowest() noexcept { return (min)(); }
 
   [[nodiscard]] static constexpr CanonRepT epsilon() noexcept {
-    return CanonRepT(CanonRepT::Raw::raw, 0, FractionsToSeconds::Num - 1);
+    return CanonRepT(CanonRepT::Raw::raw, 0, 1);
   }
 
   [[nodiscard]] static constexpr CanonRepT round_error() noexcept {
@@ -270,8 +408,7 @@ public:
   }
 
   [[nodiscard]] static constexpr CanonRepT signaling_NaN() noexcept {
-    return CanonRepT(
-        CanonRepT::Raw::raw, CanonRepT::NaN, FractionsToSeconds::Num - 1);
+    return CanonRepT(CanonRepT::Raw::raw, CanonRepT::NaN, 1);
   }
 
   static constexpr float_denorm_style has_denorm = denorm_present;
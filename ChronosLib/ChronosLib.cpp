@@ -5,6 +5,7 @@
 #include "framework.h"
 
 // Include all headers in hierarchical order.
+#include "WideMath.h"
 #include "Util.h"
 #include "Core.h"
 #include "StreamGuard.h"
@@ -14,3 +15,21 @@
 #include "ScalarUnitChild.h"
 #include "Duration.h"
 #include "Moment.h"
+#include "PackedRep.h"
+#include "WideRep.h"
+#include "NanosRep.h"
+#include "ColumnOps.h"
+#include "Column.h"
+#include "Sort.h"
+#include "KeyEncoding.h"
+#include "Hash.h"
+#include "Civil.h"
+#include "Parse.h"
+#include "Format.h"
+#include "Literals.h"
+#include "Calendar.h"
+#include "TimeZone.h"
+#include "LeapSeconds.h"
+#include "Clock.h"
+#include "CoarseClock.h"
+#include "Interop.h"
@@ -0,0 +1,274 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "Moment.h"
+
+namespace chronos {
+// Civil dates and times of day, in the proleptic Gregorian calendar, as counts
+// of days and seconds from the de facto epoch, 0001-01-01. Times are in UTC,
+// so days always have 86,400 seconds.
+//
+// The conversions are the Euclidean affine functions of Neri and Schneider,
+// which replace the divisions by the lengths of years and months with
+// multiplications and shifts, and have no branches other than for January and
+// February. They cover every day that SecondsTraits can reach.
+
+// A date. Months and days are counted from 1.
+struct CivilDate {
+  int64_t year;
+  int month;
+  int day;
+};
+
+// A date and time of day, down to the picosecond.
+struct CivilTime {
+  int64_t year;
+  int month;
+  int day;
+  int hour;
+  int minute;
+  int second;
+  UnitPicos picos;
+};
+
+namespace details {
+// Leap years are divisible by 4, but not by 100 unless by 400. Of the years
+// divisible by 4, those divisible by 100 are the ones divisible by 25, and of
+// those, the ones divisible by 400 are the ones divisible by 16. So the only
+// remainder that isn't a mask is by 25, which compiles to a multiply.
+constexpr bool isLeapYear(int64_t year) noexcept {
+  return (year % 25 ? year & 3 : year & 15) == 0;
+}
+
+// Gets the number of days in a month, from 1 to 12, of the given year.
+constexpr int daysInMonth(int64_t year, int month) noexcept {
+  if (month == 2) return isLeapYear(year) ? 29 : 28;
+  return 30 + ((month + (month >> 3)) & 1);
+}
+
+// The calendar is computed on days from 0000-03-01, so that the leap day comes
+// last in the year, shifted forward by whole 400-year eras, which always have
+// the same number of days, so that every reachable day is positive. Then the
+// arithmetic can be unsigned, where division is always floored.
+constexpr const int64_t DaysPerEra = 146'097;
+constexpr const uint64_t CivilShiftEras = uint64_t{1} << 30;
+constexpr const uint64_t CivilShiftYears = CivilShiftEras * 400;
+constexpr const uint64_t CivilShiftDays = CivilShiftEras * DaysPerEra + 306;
+
+// Splits a count of days from 0000-03-01 into the years since then, counting
+// from January, and the month and day. In 32 bits, the count must be below
+// 2^30, or 4 times it plus 3 overflows. The batch form stays far below that.
+template<typename Count>
+constexpr void splitMarchDays(
+    Count days, Count& year, uint32_t& month, uint32_t& day) noexcept {
+  // Centuries, then years of the century, each from 4 times the days, so that
+  // the quarter days from the leap years come out in the fractions. Setting
+  // the low bits is 4 times the remaining days plus 3, as the formula needs.
+  constexpr auto Era = static_cast<Count>(DaysPerEra);
+  Count n1 = 4 * days + 3;
+  Count century = n1 / Era;
+  auto n2 = static_cast<uint32_t>(n1 % Era) | 3;
+  // 2^32 / 1,461, the days in 4 years, rounded up, so that the high half is
+  // the year of the century and the low half is a fraction of the year.
+  uint64_t p2 = uint64_t{2'939'745} * n2;
+  auto yearOfCentury = static_cast<uint32_t>(p2 >> 32);
+  uint32_t dayOfYear = static_cast<uint32_t>(p2) / (2'939'745 * 4);
+  // Months from March have 153 days every 5, which in 16-bit fractions is a
+  // slope of 2,141, with the intercept chosen to land the month in the high
+  // half and the day, times the slope, in the low.
+  uint32_t n3 = 2'141 * dayOfYear + 197'913;
+  uint32_t marchMonth = n3 >> 16;
+  bool january = dayOfYear >= 306;
+  year = static_cast<Count>(100 * century + yearOfCentury + january);
+  month = january ? marchMonth - 12 : marchMonth;
+  day = (n3 & 0xFFFF) / 2'141 + 1;
+}
+
+// Gets the days from 0001-01-01 to a valid date.
+constexpr int64_t daysFromCivil(int64_t year, int month, int day) noexcept {
+  bool january = month <= 2;
+  uint64_t y = static_cast<uint64_t>(year) + CivilShiftYears - january;
+  auto m = static_cast<uint32_t>(january ? month + 12 : month);
+  uint64_t century = y / 100;
+  // Days before March of the year, then before the month, which from March has
+  // 153 days every 5 months, or 979 every 32 in the slope used here.
+  uint64_t yearDays = 1'461 * y / 4 - century + century / 4;
+  uint32_t monthDays = (979 * m - 2'919) / 32;
+  return static_cast<int64_t>(yearDays + monthDays +
+      static_cast<uint64_t>(day - 1) - CivilShiftDays);
+}
+
+// Gets the date that's the given number of days from 0001-01-01, reversing
+// daysFromCivil.
+constexpr CivilDate civilFromDays(int64_t days) noexcept {
+  uint64_t year = 0;
+  uint32_t month = 0, day = 0;
+  splitMarchDays(
+      static_cast<uint64_t>(days) + CivilShiftDays, year, month, day);
+  return CivilDate{static_cast<int64_t>(year - CivilShiftYears),
+      static_cast<int>(month), static_cast<int>(day)};
+}
+
+// Floors a moment's value to the second, so that the fraction is never
+// negative.
+constexpr UnitSeconds floorSeconds(UnitValue& sss) noexcept {
+  if (sss.ss < 0) --sss.s, sss.ss += PicosPerSecond;
+  return sss.s;
+}
+
+// Splits floored seconds into days and the second of the day.
+constexpr int64_t splitDays(
+    UnitSeconds s, UnitSeconds& secondOfDay) noexcept {
+  int64_t days = s / SecondsPerDay;
+  secondOfDay = s % SecondsPerDay;
+  if (secondOfDay < 0) --days, secondOfDay += SecondsPerDay;
+  return days;
+}
+
+// The days that the seconds can reach, past which values are infinite, and
+// the years beyond which dates are sure to be past them.
+constexpr const int64_t MaxCivilDays = SecondsTraits<>::Max / SecondsPerDay;
+constexpr const int64_t MaxCivilYear = MaxCivilDays / 365;
+
+// Gets the days from 0001-01-01 to a valid date, as daysFromCivil does, but
+// for years too far out to count, gets a day past the range on their side.
+constexpr int64_t daysFromCivilSaturated(
+    int64_t year, int month, int day) noexcept {
+  if (year > MaxCivilYear) return MaxCivilDays + 1;
+  if (year < -MaxCivilYear) return -MaxCivilDays - 2;
+  return daysFromCivil(year, month, day);
+}
+
+// Gets the canonical value of a day, a second of the day, and picoseconds
+// that aren't negative, or an infinity if it's out of range. At the edges,
+// the second of the day decides, and at the bottom, the picoseconds can make
+// up the last second, since they're added toward zero.
+constexpr UnitValue valueFromDays(
+    int64_t days, UnitSeconds secondOfDay, UnitPicos picos) noexcept {
+  using T = SecondsTraits<>;
+  constexpr UnitSeconds MaxRest = T::Max % SecondsPerDay;
+  if (days > MaxCivilDays || (days == MaxCivilDays && secondOfDay > MaxRest))
+    return UnitValue{T::InfP, 0};
+  if (days < -MaxCivilDays - 1 || (days == -MaxCivilDays - 1 &&
+          secondOfDay + (picos > 0) < SecondsPerDay - MaxRest))
+    return UnitValue{T::InfN, 0};
+
+  // Whole days before the epoch are one short, so that the product fits.
+  UnitSeconds s = days < 0
+      ? (days + 1) * SecondsPerDay + (secondOfDay - SecondsPerDay)
+      : days * SecondsPerDay + secondOfDay;
+  if (s < 0 && picos) ++s, picos -= PicosPerSecond;
+  return UnitValue{s, picos};
+}
+
+// Adds an offset to floored seconds and their picoseconds, saturating as
+// ScalarUnit arithmetic does. The seconds needn't be in range to begin with.
+constexpr UnitValue shiftFloored(
+    UnitSeconds floor, UnitPicos picos, int64_t offset) noexcept {
+  using T = SecondsTraits<>;
+  if (offset > 0 && floor > T::Max - offset) return UnitValue{T::InfP, 0};
+  if (offset < 0 && floor < T::Min - 1 - offset) return UnitValue{T::InfN, 0};
+  UnitSeconds s = floor + offset;
+  if (s > T::Max) return UnitValue{T::InfP, 0};
+  // The second before the minimum is only in range with a fraction.
+  if (s < T::Min - 1 || (s == T::Min - 1 && !picos))
+    return UnitValue{T::InfN, 0};
+  if (s < 0 && picos) ++s, picos -= PicosPerSecond;
+  return UnitValue{s, picos};
+}
+
+// The batch form converts in 32 bits when the floored seconds are from 0 to
+// 2^39, which is into the year 17,422. After a shift by 7, the seconds fit,
+// and 86,400 is 675 shifted by 7.
+constexpr const int CivilBatchBits = 39;
+constexpr const std::size_t CivilBatchBlock = 16;
+// The most days the batch form gives splitMarchDays, about 6.4 million.
+constexpr const uint64_t CivilBatchMaxDays =
+    (((uint64_t{1} << CivilBatchBits) - 1) >> 7) / 675 + 306;
+static_assert(CivilBatchMaxDays < uint64_t{1} << 30,
+    "The batch form's days must fit splitMarchDays in 32 bits");
+
+constexpr void civilDateLane(UnitSeconds s, UnitPicos ss, int64_t* years,
+    uint8_t* months, uint8_t* days, std::size_t i) noexcept {
+  if (SecondsTraits<>::toCategory(s) != Category::Num) {
+    years[i] = 0, months[i] = 0, days[i] = 0;
+    return;
+  }
+  UnitSeconds secondOfDay = 0;
+  CivilDate date = civilFromDays(splitDays(s - (ss < 0), secondOfDay));
+  years[i] = date.year;
+  months[i] = static_cast<uint8_t>(date.month);
+  days[i] = static_cast<uint8_t>(date.day);
+}
+} // namespace details
+
+// Gets the date and time of day of a moment, or returns false if it's one of
+// the special values.
+template<typename Scalar>
+constexpr bool toCivil(const Moment<Scalar>& item, CivilTime& out) noexcept {
+  using namespace details;
+  UnitValue sss = item.value();
+  if (SecondsTraits<>::toCategory(sss.s) != Category::Num) return false;
+  UnitSeconds secondOfDay = 0;
+  CivilDate date = civilFromDays(splitDays(floorSeconds(sss), secondOfDay));
+  auto rest = static_cast<int>(secondOfDay);
+  out = CivilTime{date.year, date.month, date.day, rest / 3'600,
+      rest / 60 % 60, rest % 60, sss.ss};
+  return true;
+}
+
+// Gets the moment of a date and time of day. If any field is out of range,
+// including a second of 60, it's NaN. Years too far out for the seconds give
+// an infinity of their sign, as overflowing arithmetic does.
+template<typename Scalar = details::DefaultScalarUnit>
+constexpr Moment<Scalar> fromCivil(const CivilTime& t) noexcept {
+  using namespace details;
+  if (t.month < 1 || t.month > 12 || t.day < 1 ||
+      t.day > daysInMonth(t.year, t.month) || t.hour < 0 || t.hour > 23 ||
+      t.minute < 0 || t.minute > 59 || t.second < 0 || t.second > 59 ||
+      t.picos < 0 || t.picos >= PicosPerSecond)
+    return Moment<Scalar>(Category::NaN);
+
+  UnitSeconds secondOfDay =
+      t.hour * SecondsPerHour + t.minute * SecondsPerMinute + t.second;
+  return Moment<Scalar>(valueFromDays(
+      daysFromCivilSaturated(t.year, t.month, t.day), secondOfDay, t.picos));
+}
+
+// Gets the dates of n moments, given as the canonical seconds and picoseconds
+// of a MomentColumn, into separate arrays for the years, months, and days.
+// Special values get zeros, which no date has for its month. Blocks of moments
+// within a wide window of present dates are converted in 32-bit lanes, which
+// the compiler vectorizes. Any others are converted one at a time.
+inline void civilDates(const UnitSeconds* s, const UnitPicos* ss,
+    int64_t* years, uint8_t* months, uint8_t* days, std::size_t n) noexcept {
+  using namespace details;
+  std::size_t i = 0;
+  for (; i + CivilBatchBlock <= n; i += CivilBatchBlock) {
+    uint64_t bits = 0;
+    for (std::size_t j = i; j < i + CivilBatchBlock; ++j)
+      bits |= static_cast<uint64_t>(s[j]) - (ss[j] < 0);
+    if (bits >> CivilBatchBits) {
+      for (std::size_t j = i; j < i + CivilBatchBlock; ++j)
+        civilDateLane(s[j], ss[j], years, months, days, j);
+      continue;
+    }
+    // Staged through local arrays, so that the compiler needn't worry about
+    // the outputs overlapping the inputs.
+    uint32_t year[CivilBatchBlock], month[CivilBatchBlock],
+        day[CivilBatchBlock];
+    for (std::size_t j = 0; j < CivilBatchBlock; ++j) {
+      auto shifted = static_cast<uint32_t>(
+          (static_cast<uint64_t>(s[i + j]) - (ss[i + j] < 0)) >> 7);
+      splitMarchDays(shifted / 675 + 306, year[j], month[j], day[j]);
+    }
+    for (std::size_t j = 0; j < CivilBatchBlock; ++j) {
+      years[i + j] = year[j];
+      months[i + j] = static_cast<uint8_t>(month[j]);
+      days[i + j] = static_cast<uint8_t>(day[j]);
+    }
+  }
+  for (; i < n; ++i) civilDateLane(s[i], ss[i], years, months, days, i);
+}
+
+} // namespace chronos
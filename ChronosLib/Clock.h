@@ -0,0 +1,294 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include "LeapSeconds.h"
+#include "Moment.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+namespace chronos {
+// Clocks that read the current moment.
+//
+// The kernel's clocks are read with clock_gettime, where there is one, and
+// their nanoseconds, which are always in range and never negative, are scaled
+// to picoseconds and stored as they are, with nothing to divide or check.
+// Elsewhere, the standard library's clocks stand in for them.
+//
+// TscClock reads the processor's time stamp counter instead, which takes a
+// few nanoseconds rather than a few tens, and converts ticks to picoseconds
+// by a fixed-point multiply, at a rate calibrated against a kernel clock.
+
+enum class ClockSource {
+  Realtime, // POSIX time, as the system clock has it.
+  Tai, // TAI. The kernel's clock is only used if something such as NTP or
+       // PTP has told it the offset, since it's otherwise the same as
+       // Realtime. If not, the compiled-in leap seconds are used.
+  Monotonic, // Never steps, and counts from an unspecified point, such as
+             // boot, so only differences between its moments mean anything.
+};
+
+namespace details {
+#ifdef CLOCK_TAI
+constexpr const bool HasKernelTai = true;
+#else
+constexpr const bool HasKernelTai = false;
+#endif
+
+inline constexpr LeapSeconds BuiltinLeapSeconds{};
+
+// Whether the kernel's TAI clock has been told the offset. Until then, the
+// offset is 0. That's checked once, by reading it and the system clock, which
+// are a moment apart, so only an offset of more than a second counts.
+inline bool hasKernelTaiOffset() noexcept {
+#ifdef CLOCK_TAI
+  static const bool has = [] {
+    timespec realtime{}, tai{};
+    clock_gettime(CLOCK_REALTIME, &realtime);
+    clock_gettime(CLOCK_TAI, &tai);
+    return tai.tv_sec - realtime.tv_sec > 1;
+  }();
+  return has;
+#else
+  return false;
+#endif
+}
+
+// Reads a kernel clock as seconds and nanoseconds.
+inline void readClock(
+    ClockSource source, int64_t& s, int64_t& nanos) noexcept {
+#ifdef CLOCK_REALTIME
+  clockid_t id = CLOCK_REALTIME;
+  if (source == ClockSource::Monotonic) id = CLOCK_MONOTONIC;
+#ifdef CLOCK_TAI
+  if (source == ClockSource::Tai) id = CLOCK_TAI;
+#endif
+  timespec ts{};
+  clock_gettime(id, &ts);
+#else
+  timespec ts{};
+  if (source == ClockSource::Monotonic) {
+    auto since = std::chrono::steady_clock::now().time_since_epoch();
+    auto count = std::chrono::duration_cast<std::chrono::nanoseconds>(since)
+                     .count();
+    ts.tv_sec = static_cast<std::time_t>(count / NanosPerSecond);
+    ts.tv_nsec = static_cast<long>(count % NanosPerSecond);
+  } else {
+    std::timespec_get(&ts, TIME_UTC);
+  }
+#endif
+  s = static_cast<int64_t>(ts.tv_sec);
+  nanos = static_cast<int64_t>(ts.tv_nsec);
+}
+
+// Time stamp counter access, where there is one.
+inline uint64_t readTsc() noexcept {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+// Whether the counter ticks at a constant rate through every power state and
+// frequency change, as CPUID leaf 0x80000007 reports in bit 8 of EDX.
+inline bool hasInvariantTsc() noexcept {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  int regs[4]{};
+  __cpuid(regs, 0x8000'0000);
+  if (static_cast<unsigned>(regs[0]) < 0x8000'0007) return false;
+  __cpuid(regs, 0x8000'0007);
+  return regs[3] & (1 << 8);
+#elif defined(__x86_64__) || defined(__i386__)
+  unsigned a = 0, b = 0, c = 0, d = 0;
+  if (!__get_cpuid(0x8000'0007, &a, &b, &c, &d)) return false;
+  return d & (1u << 8);
+#else
+  return false;
+#endif
+}
+} // namespace details
+
+// Reads the current moment from a kernel clock.
+template<ClockSource Source = ClockSource::Realtime>
+inline Moment<> now() noexcept {
+  using namespace details;
+  if constexpr (Source == ClockSource::Tai) {
+    if (!HasKernelTai || !hasKernelTaiOffset())
+      return BuiltinLeapSeconds.toTai(now<ClockSource::Realtime>());
+  }
+  int64_t s = 0, nanos = 0;
+  readClock(Source, s, nanos);
+  UnitSeconds epoch = Source == ClockSource::Monotonic ? 0 : UnixEpochSeconds;
+  return Moment<>(UnitValue{epoch + s, nanos * 1'000});
+}
+
+// Reads the current moment from the time stamp counter, at a rate calibrated
+// against a kernel clock, which it also starts from.
+//
+// Calibrating when it's made takes about 10 ms. After that, once a period
+// has passed since it was last calibrated, the next reading calibrates it
+// again against the reference, from which the rate is refined over the whole
+// period, and the clock is moved to where the reference is, so that it can't
+// drift further than it does in a period. That moves it forward or back by as
+// much as it had drifted, so even with a monotonic reference, readings on
+// either side can be out of order by that much. If the rate over a period is
+// far off the last one, as when the system clock is set, the old rate is kept.
+//
+// Where the counter isn't invariant, or there's none, it just reads the
+// reference. It isn't safe to share, so it's meant to be kept per thread.
+class TscClock {
+public:
+  // The period is kept from 1 ms to an hour.
+  explicit TscClock(ClockSource reference = ClockSource::Realtime,
+      const Duration<>& period = Duration<>(1)) noexcept
+      : m_reference(reference), m_invariant(details::hasInvariantTsc()) {
+    using namespace details;
+    UnitValue p = period.value();
+    if (SecondsTraits<>::toCategory(p.s) != Category::Num || p.s < 0 ||
+        p.ss < 0)
+      p = UnitValue{1, 0};
+    m_periodPicos = std::clamp<WidePair>(toWidePicos(p),
+                        WidePair{0, MinPeriodPicos},
+                        WidePair{0, MaxPeriodPicos})
+                        .lo;
+    if (!m_invariant) return;
+
+    const Duration<> calibration(0, CalibrationPicos);
+    uint64_t ticks = 0;
+    UnitValue at{};
+    sample(m_anchorTicks, m_anchor);
+    do {
+      sample(ticks, at);
+    } while (Moment<>(at) - Moment<>(m_anchor) < calibration &&
+        ticks > m_anchorTicks);
+    if (!setRate(ticks, at)) m_invariant = false;
+    m_anchorTicks = ticks, m_anchor = at;
+  }
+
+  // Whether the counter is used, rather than the reference.
+  bool invariant() const noexcept { return m_invariant; }
+
+  // The rate, in picoseconds per tick, with 32 bits of fraction.
+  uint64_t scale() const noexcept { return m_scale; }
+
+  Moment<> now() noexcept {
+    if (!m_invariant) return readReference();
+    uint64_t ticks = details::readTsc() - m_anchorTicks;
+    if (ticks >= m_periodTicks) {
+      recalibrate();
+      ticks = details::readTsc() - m_anchorTicks;
+    }
+    return Moment<>(fromTicks(ticks));
+  }
+
+  // Calibrates now, rather than waiting for the period to pass, and returns
+  // how far the clock had drifted, as what it read less what the reference
+  // did.
+  Duration<> recalibrate() noexcept {
+    if (!m_invariant) return Duration<>();
+    uint64_t ticks = 0;
+    UnitValue at{};
+    sample(ticks, at);
+    Duration<> drift =
+        Moment<>(fromTicks(ticks - m_anchorTicks)) - Moment<>(at);
+    setRate(ticks, at);
+    m_anchorTicks = ticks, m_anchor = at;
+    return drift;
+  }
+
+private:
+  static constexpr const uint64_t MinPeriodPicos = PicosPerSecond / 1'000;
+  static constexpr const uint64_t MaxPeriodPicos =
+      PicosPerSecond * SecondsPerHour;
+  static constexpr const int SampleTries = 5;
+  // A new rate more than this many parts per 2^32 off the old is ignored,
+  // which is about 240 ppm, or 21 s a day.
+  static constexpr const uint64_t MaxRateChange = uint64_t{1} << 20;
+  static constexpr const UnitPicos CalibrationPicos = PicosPerSecond / 100;
+
+  ClockSource m_reference;
+  bool m_invariant;
+  uint64_t m_periodPicos = 0;
+  // Readings start from the anchor, where the counter was last calibrated.
+  uint64_t m_anchorTicks = 0;
+  UnitValue m_anchor{};
+  uint64_t m_scale = 0;
+  uint64_t m_periodTicks = 0;
+
+  Moment<> readReference() const noexcept {
+    switch (m_reference) {
+    case ClockSource::Tai: return chronos::now<ClockSource::Tai>();
+    case ClockSource::Monotonic: return chronos::now<ClockSource::Monotonic>();
+    default: return chronos::now<ClockSource::Realtime>();
+    }
+  }
+
+  // Reads the reference between two reads of the counter, taking the one
+  // that's most tightly bracketed of a few tries, as of the midpoint.
+  void sample(uint64_t& ticks, UnitValue& at) const noexcept {
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < SampleTries; ++i) {
+      uint64_t before = details::readTsc();
+      Moment<> reading = readReference();
+      uint64_t after = details::readTsc();
+      if (after - before < best) {
+        best = after - before;
+        ticks = before + best / 2;
+        at = reading.value();
+      }
+    }
+  }
+
+  // The anchor is never negative, nor is the product, which is within a
+  // period, so the sum splits without any signs to fix. Only calibrating
+  // after a long idle can see more than the 2^63 picoseconds, or about 100
+  // days, that fit.
+  UnitValue fromTicks(uint64_t ticks) const noexcept {
+    WidePair product = wideMul(ticks, m_scale);
+    if (product.hi >> 31) return UnitValue{SecondsTraits<>::InfP, 0};
+    uint64_t picos = (product.hi << 32 | product.lo >> 32) +
+        static_cast<uint64_t>(m_anchor.ss);
+    return UnitValue{
+        m_anchor.s + static_cast<UnitSeconds>(picos / PicosPerSecond),
+        static_cast<UnitPicos>(picos % PicosPerSecond)};
+  }
+
+  // Sets the rate from the anchor to a later sample, returning false if it
+  // can't be measured or, once there's a rate, if it's too far off.
+  bool setRate(uint64_t ticks, const UnitValue& at) noexcept {
+    using namespace details;
+    Duration<> elapsed = Moment<>(at) - Moment<>(m_anchor);
+    if (ticks <= m_anchorTicks || elapsed <= Duration<>() ||
+        elapsed > Duration<>(SecondsPerHour * 2))
+      return false;
+    WidePair picos = toWidePicos(elapsed.value()), rest{};
+    WidePair scale = wideDiv(WidePair{picos.hi << 32 | picos.lo >> 32,
+                                 picos.lo << 32},
+        WidePair{0, ticks - m_anchorTicks}, rest);
+    if (scale.hi || !scale.lo) return false;
+    if (m_scale) {
+      uint64_t change = scale.lo > m_scale ? scale.lo - m_scale
+                                           : m_scale - scale.lo;
+      if (wideMul(change, uint64_t{1} << 32) >
+          wideMul(m_scale, MaxRateChange))
+        return false;
+    }
+    m_scale = scale.lo;
+    WidePair periodTicks = wideDiv(
+        WidePair{m_periodPicos >> 32, m_periodPicos << 32},
+        WidePair{0, m_scale}, rest);
+    m_periodTicks = periodTicks.hi ? UINT64_MAX : periodTicks.lo;
+    return true;
+  }
+};
+
+} // namespace chronos
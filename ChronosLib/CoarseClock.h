@@ -0,0 +1,139 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "Clock.h"
+
+namespace chronos {
+// A clock for callers that read the time far more often than it changes at
+// the precision they need, such as timestamping log lines to the millisecond.
+//
+// A background thread reads a kernel clock once per interval, truncates the
+// moment to the precision, and publishes it to a slot on a cache line of its
+// own. Readers load it with no system call and no lock, under a sequence
+// counter, so a reading is never torn, and only has to be retried if it was
+// being written at the time. A reading lags the kernel clock by up to the
+// interval, plus however late the thread is woken.
+//
+// Stopping, which the destructor also does, wakes the thread and joins it,
+// after which readers read the kernel clock themselves, at its usual cost.
+class CoarseClock {
+public:
+  // The interval is kept from 1 us to an hour. A precision that isn't
+  // positive leaves moments as the kernel clock has them.
+  explicit CoarseClock(ClockSource source = ClockSource::Realtime,
+      const Duration<>& interval = Duration<>(0, PicosPerSecond / 1'000),
+      const Duration<>& precision = Duration<>(0, PicosPerSecond / 1'000))
+      : m_source(source), m_precision(precision.value()) {
+    using T = SecondsTraits<>;
+    UnitValue i = interval.value();
+    if (T::toCategory(i.s) != Category::Num || i.s < 0 || i.ss < 0)
+      i = UnitValue{0, PicosPerSecond / 1'000};
+    int64_t nanos =
+        std::min<UnitSeconds>(i.s, SecondsPerHour) * NanosPerSecond +
+        i.ss / 1'000;
+    m_interval = std::chrono::nanoseconds(
+        std::clamp<int64_t>(nanos, 1'000, SecondsPerHour * NanosPerSecond));
+    if (T::toCategory(m_precision.s) != Category::Num || m_precision.s < 0 ||
+        m_precision.ss < 0)
+      m_precision = UnitValue{0, 0};
+
+    publish(read().value());
+    m_thread = std::thread([this] { run(); });
+  }
+
+  CoarseClock(const CoarseClock&) = delete;
+  CoarseClock& operator=(const CoarseClock&) = delete;
+
+  ~CoarseClock() { stop(); }
+
+  // Gets the last moment published, or reads the kernel clock if stopped.
+  Moment<> now() const noexcept {
+    for (;;) {
+      uint64_t seq = m_slot.seq.load(std::memory_order_acquire);
+      UnitValue sss{m_slot.s.load(std::memory_order_relaxed),
+          m_slot.ss.load(std::memory_order_relaxed)};
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (seq & 1 || m_slot.seq.load(std::memory_order_relaxed) != seq)
+        continue;
+      // NaN, which no clock reads, marks the slot as no longer kept up.
+      if (sss.s == SecondsTraits<>::NaN) return read();
+      return Moment<>(sss);
+    }
+  }
+
+  // Stops the thread and waits for it. It's safe to call more than once, but
+  // not from more than one thread at a time.
+  void stop() noexcept {
+    if (!m_thread.joinable()) return;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+    publish(UnitValue{SecondsTraits<>::NaN, 0});
+  }
+
+  bool running() const noexcept { return m_thread.joinable(); }
+
+private:
+  // Only the thread writes the slot while it runs, so there's one writer.
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> seq{0};
+    std::atomic<UnitSeconds> s{0};
+    std::atomic<UnitPicos> ss{0};
+  };
+
+  Slot m_slot;
+  alignas(64) ClockSource m_source;
+  UnitValue m_precision;
+  std::chrono::nanoseconds m_interval{};
+  std::mutex m_mutex;
+  std::condition_variable m_wake;
+  bool m_stopping = false;
+  std::thread m_thread;
+
+  // Reads the kernel clock, truncated to the precision. Kernel clocks never
+  // read negative moments, so truncating is toward the past.
+  Moment<> read() const noexcept {
+    Moment<> moment;
+    switch (m_source) {
+    case ClockSource::Tai: moment = chronos::now<ClockSource::Tai>(); break;
+    case ClockSource::Monotonic:
+      moment = chronos::now<ClockSource::Monotonic>();
+      break;
+    default: moment = chronos::now<ClockSource::Realtime>(); break;
+    }
+    UnitValue sss = moment.value();
+    if (m_precision.s) {
+      sss.s -= sss.s % m_precision.s;
+      sss.ss = 0;
+    } else if (m_precision.ss) {
+      sss.ss -= sss.ss % m_precision.ss;
+    }
+    return Moment<>(sss);
+  }
+
+  void publish(UnitValue sss) noexcept {
+    uint64_t seq = m_slot.seq.load(std::memory_order_relaxed);
+    m_slot.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_slot.s.store(sss.s, std::memory_order_relaxed);
+    m_slot.ss.store(sss.ss, std::memory_order_relaxed);
+    m_slot.seq.store(seq + 2, std::memory_order_release);
+  }
+
+  void run() noexcept {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_wake.wait_for(lock, m_interval, [this] { return m_stopping; }))
+      publish(read().value());
+  }
+};
+
+} // namespace chronos
@@ -0,0 +1,266 @@
+#pragma once
+#include <algorithm>
+#include <new>
+#include <span>
+#include <vector>
+#include "ColumnOps.h"
+#include "Moment.h"
+
+namespace chronos {
+namespace details {
+// Allocator for the arrays of a column. They're aligned to a cache line, which
+// is also the width of the widest vectors, so that no load straddles two lines.
+template<typename T>
+struct ColumnAllocator {
+  using value_type = T;
+
+  static constexpr std::align_val_t Alignment{64};
+
+  constexpr ColumnAllocator() noexcept = default;
+  template<typename U>
+  constexpr ColumnAllocator(const ColumnAllocator<U>&) noexcept {}
+
+  T* allocate(std::size_t n) {
+    return static_cast<T*>(::operator new(n * sizeof(T), Alignment));
+  }
+
+  void deallocate(T* p, std::size_t) noexcept {
+    ::operator delete(p, Alignment);
+  }
+
+  template<typename U>
+  constexpr bool operator==(const ColumnAllocator<U>&) const noexcept {
+    return true;
+  }
+};
+
+// Column of scalar values, stored as structure-of-arrays.
+//
+// The values are kept canonically, as the default scalar would hold them, but
+// with the seconds and the picoseconds in separate arrays, so that the kernels
+// in ColumnOps can work on several values at once. This is the base for
+// MomentColumn and DurationColumn, which expose the operations that make sense
+// for their elements, just as ScalarUnitChild does for single values.
+//
+// Operations between two columns apply to the values at matching positions.
+// The columns are expected to be the same size. If they're not, only the
+// positions that both have are combined. A column updated in place keeps the
+// values past the end of the other as they were, while a result written
+// elsewhere only has the positions that both have.
+template<typename Element>
+class ScalarColumn {
+public:
+  using ElementT = Element;
+  using Array = std::vector<int64_t, ColumnAllocator<int64_t>>;
+
+  ScalarColumn() noexcept = default;
+  explicit ScalarColumn(std::size_t count) : m_s(count), m_ss(count) {}
+
+  // Copies a range of elements, such as a vector of them.
+  template<typename It>
+  ScalarColumn(It first, It last) {
+    for (; first != last; ++first) push_back(*first);
+  }
+
+  std::size_t size() const noexcept { return m_s.size(); }
+  bool empty() const noexcept { return m_s.empty(); }
+  void reserve(std::size_t count) {
+    m_s.reserve(count);
+    m_ss.reserve(count);
+  }
+  void resize(std::size_t count) {
+    m_s.resize(count);
+    m_ss.resize(count);
+  }
+  void clear() noexcept {
+    m_s.clear();
+    m_ss.clear();
+  }
+
+  // The raw arrays, for passing to other bulk code. Values written through
+  // these must be canonical.
+  const UnitSeconds* seconds() const noexcept { return m_s.data(); }
+  UnitSeconds* seconds() noexcept { return m_s.data(); }
+  const UnitPicos* subseconds() const noexcept { return m_ss.data(); }
+  UnitPicos* subseconds() noexcept { return m_ss.data(); }
+
+  UnitValue value(std::size_t i) const noexcept {
+    return UnitValue{m_s[i], m_ss[i]};
+  }
+
+  Element operator[](std::size_t i) const noexcept {
+    return Element(value(i));
+  }
+
+  template<typename ScalarU>
+  void set(std::size_t i,
+      const typename ScalarChildTraits<Element>::template Other<ScalarU>&
+          item) noexcept {
+    UnitValue sss = canonical(item);
+    m_s[i] = sss.s, m_ss[i] = sss.ss;
+  }
+
+  template<typename ScalarU>
+  void push_back(
+      const typename ScalarChildTraits<Element>::template Other<ScalarU>&
+          item) {
+    UnitValue sss = canonical(item);
+    m_s.push_back(sss.s);
+    m_ss.push_back(sss.ss);
+  }
+
+  void push_back(const Element& item) { push_back<DefaultScalarUnit>(item); }
+
+  // Sets each of out to -1, 0, or +1, as the value at the same position is
+  // less than, equal to, or greater than rhs. See ColumnOps for details.
+  template<typename ScalarU>
+  void compare(
+      const typename ScalarChildTraits<Element>::template Other<ScalarU>& rhs,
+      std::span<int8_t> out) const noexcept {
+    NativeColumnOps::compareValue(m_s.data(), m_ss.data(), canonical(rhs),
+        out.data(), std::min(size(), out.size()));
+  }
+
+  void compare(const Element& rhs, std::span<int8_t> out) const noexcept {
+    compare<DefaultScalarUnit>(rhs, out);
+  }
+
+  // Reductions. Any NaN makes the result NaN. See ColumnOps for details.
+  Element minimum() const noexcept {
+    return Element(NativeColumnOps::minimum(m_s.data(), m_ss.data(), size()));
+  }
+
+  Element maximum() const noexcept {
+    return Element(NativeColumnOps::maximum(m_s.data(), m_ss.data(), size()));
+  }
+
+  CategoryCounts countCategories() const noexcept {
+    return NativeColumnOps::countCategories(m_s.data(), size());
+  }
+
+protected:
+  Array m_s;
+  Array m_ss;
+
+  template<typename T>
+  static UnitValue canonical(const T& item) noexcept {
+    return Element(item).value();
+  }
+
+  // Adds or subtracts a single duration to or from every value.
+  template<typename ScalarU>
+  void addValue(const Duration<ScalarU>& rhs, bool sub) noexcept {
+    UnitValue sss = Duration<>(rhs).value();
+    if (sub) sss = ColumnLane::negate(sss);
+    NativeColumnOps::addValue(
+        m_s.data(), m_ss.data(), sss, m_s.data(), m_ss.data(), size());
+  }
+
+  // Adds or subtracts the values of another column, writing the results to
+  // the given arrays. This column's own arrays are left their size, so any
+  // values past the end of rhs are unchanged, while others are resized to
+  // fit.
+  template<typename ElementU>
+  void combine(const ScalarColumn<ElementU>& rhs, bool sub, Array& s,
+      Array& ss) const {
+    std::size_t n = std::min(size(), rhs.size());
+    if (&s != &m_s) {
+      s.resize(n);
+      ss.resize(n);
+    }
+    auto op = sub ? NativeColumnOps::sub : NativeColumnOps::add;
+    op(m_s.data(), m_ss.data(), rhs.seconds(), rhs.subseconds(), s.data(),
+        ss.data(), n);
+  }
+
+  template<typename>
+  friend class ScalarColumn;
+};
+} // namespace details
+
+// Column of durations.
+class DurationColumn : public details::ScalarColumn<Duration<>> {
+public:
+  using Parent = details::ScalarColumn<Duration<>>;
+  using Parent::Parent;
+
+  // Gets the total, which is exactly what adding the durations up in order
+  // would give.
+  Duration<> sum() const noexcept {
+    return Duration<>(NativeColumnOps::sum(m_s.data(), m_ss.data(), size()));
+  }
+
+  template<typename ScalarU>
+  DurationColumn& operator+=(const Duration<ScalarU>& rhs) noexcept {
+    addValue(rhs, false);
+    return *this;
+  }
+
+  template<typename ScalarU>
+  DurationColumn& operator-=(const Duration<ScalarU>& rhs) noexcept {
+    addValue(rhs, true);
+    return *this;
+  }
+
+  DurationColumn& operator+=(const DurationColumn& rhs) {
+    combine(rhs, false, m_s, m_ss);
+    return *this;
+  }
+
+  DurationColumn& operator-=(const DurationColumn& rhs) {
+    combine(rhs, true, m_s, m_ss);
+    return *this;
+  }
+
+private:
+  friend class MomentColumn;
+};
+
+// Column of moments.
+//
+// Shifting every moment by the same duration, as when applying a time zone
+// offset, and taking the differences between two columns of moments, are
+// single passes through the vector kernels.
+class MomentColumn : public details::ScalarColumn<Moment<>> {
+public:
+  using Parent = details::ScalarColumn<Moment<>>;
+  using Parent::Parent;
+
+  template<typename ScalarU>
+  MomentColumn& operator+=(const Duration<ScalarU>& rhs) noexcept {
+    addValue(rhs, false);
+    return *this;
+  }
+
+  template<typename ScalarU>
+  MomentColumn& operator-=(const Duration<ScalarU>& rhs) noexcept {
+    addValue(rhs, true);
+    return *this;
+  }
+
+  MomentColumn& operator+=(const DurationColumn& rhs) {
+    combine(rhs, false, m_s, m_ss);
+    return *this;
+  }
+
+  MomentColumn& operator-=(const DurationColumn& rhs) {
+    combine(rhs, true, m_s, m_ss);
+    return *this;
+  }
+
+  // Sets out to the durations from each of rhs to the moment at the same
+  // position. The arrays of out are reused, so that repeated batches don't
+  // allocate.
+  void subtract(const MomentColumn& rhs, DurationColumn& out) const {
+    combine(rhs, true, out.m_s, out.m_ss);
+  }
+};
+
+inline DurationColumn operator-(
+    const MomentColumn& lhs, const MomentColumn& rhs) {
+  DurationColumn out;
+  lhs.subtract(rhs, out);
+  return out;
+}
+
+} // namespace chronos
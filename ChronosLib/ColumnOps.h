@@ -0,0 +1,863 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "Core.h"
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace chronos {
+// Bulk arithmetic on columns of canonical values.
+//
+// A column keeps the seconds and the picoseconds of many values in two
+// separate arrays, so that the same operation can be applied to several values
+// at once. These kernels do the work, on raw arrays, with exactly the results
+// that ScalarUnit gives one value at a time, including the handling of special
+// values defined by SecondsTraits::addCategories and the saturation of
+// overflows to infinity. The inputs must be canonical, as ScalarUnit::value
+// returns them: special values have no subseconds, and the signs of the two
+// halves agree.
+//
+// As with WideOps, the best backend is selected at compile time, but all of the
+// ones that the target supports remain available by name, so that they can be
+// tested and benchmarked against each other. The vector backends are only
+// available when the compiler is allowed to emit their instructions, as with
+// -mavx2 or /arch:AVX2.
+//
+// All backends share the same contract:
+//
+// add(sL, ssL, sR, ssR, s, ss, n) sets each of the n values of s and ss to the
+// sum of the values of the left and right. sub does the same for the
+// difference. The outputs may be the same arrays as either input.
+//
+// addValue(sL, ssL, r, s, ss, n) adds the same value, r, to each of the values
+// of the left. To subtract, add the negation.
+//
+// compareValue(sL, ssL, r, out, n) sets each of the n values of out to -1, 0,
+// or +1, as the value of the left is less than, equal to, or greater than r.
+// As with ScalarUnit::operator<=>, NaN on either side compares as greater.
+//
+// sum(s, ss, n) returns the total of the n values, which is exactly what adding
+// them up in order with ScalarUnit::operator+= gives, starting from zero. The
+// numbers are totaled exactly, in as many accumulators as suit the backend,
+// while noting any special values and a bound on the magnitudes. When the bound
+// shows that no running total could have overflowed, the result follows from
+// the exact total and the special values, just as SecondsTraits::addCategories
+// would combine them. Otherwise, the values are added up in order, so that the
+// saturation matches, too.
+//
+// minimum(s, ss, n) and maximum(s, ss, n) return the least and greatest of the
+// n values, unless any is NaN, in which case they return NaN. An empty column
+// gives positive infinity for the minimum and negative for the maximum.
+//
+// countCategories(s, n) returns how many of the n values fall into each
+// Category, indexed by its value.
+enum class ColumnBackend { Scalar, Avx2, Avx512 };
+
+using CategoryCounts = std::array<std::size_t, 4>;
+
+template<ColumnBackend Backend>
+struct ColumnOps {
+  static constexpr bool available = false;
+};
+
+namespace details {
+// The rules for a single value, shared by all backends. The vector backends
+// use these for the leftover values at the end of each array.
+struct ColumnLane {
+  using Traits = SecondsTraits<>;
+
+  static constexpr bool isSpecial(int64_t s) noexcept {
+    return s > Traits::Max || s < Traits::Min;
+  }
+
+  // Negates, as ScalarUnit::operator- does, so NaN stays the same.
+  static constexpr UnitValue negate(UnitValue sss) noexcept {
+    if (sss.s == Traits::NaN) return sss;
+    return UnitValue{-sss.s, -sss.ss};
+  }
+
+  // Adds, as ScalarUnit::operator+= does.
+  static constexpr UnitValue add(UnitValue l, UnitValue r) noexcept {
+    bool specL = isSpecial(l.s), specR = isSpecial(r.s);
+    if (specL | specR) {
+      if (specL & specR)
+        return UnitValue{(l.s == r.s) ? l.s : Traits::NaN, 0};
+      return UnitValue{specL ? l.s : r.s, 0};
+    }
+    // Carry any whole second out of the subseconds.
+    int64_t ss = l.ss + r.ss, sR = r.s;
+    if (ss >= PicosPerSecond)
+      ss -= PicosPerSecond, ++sR;
+    else if (ss <= -PicosPerSecond)
+      ss += PicosPerSecond, --sR;
+    int64_t s = 0;
+    if (!addSafely(l.s, sR, s)) return saturate(sR < 0);
+    // Match the signs.
+    if (ss > 0 && s < 0)
+      ss -= PicosPerSecond, ++s;
+    else if (ss < 0 && s > 0)
+      ss += PicosPerSecond, --s;
+    if (isSpecial(s)) return saturate(s < 0);
+    return UnitValue{s, ss};
+  }
+
+  static constexpr UnitValue saturate(bool neg) noexcept {
+    return UnitValue{neg ? Traits::InfN : Traits::InfP, 0};
+  }
+
+  static constexpr int8_t compare(UnitValue l, UnitValue r) noexcept {
+    if ((l.s == Traits::NaN) | (r.s == Traits::NaN)) return 1;
+    if (l.s != r.s) return (l.s < r.s) ? -1 : 1;
+    return static_cast<int8_t>((l.ss > r.ss) - (l.ss < r.ss));
+  }
+
+  static void add(const int64_t* sL, const int64_t* ssL, const int64_t* sR,
+      const int64_t* ssR, int64_t* s, int64_t* ss, size_t i,
+      size_t n) noexcept {
+    for (; i < n; ++i) {
+      UnitValue sss = add(UnitValue{sL[i], ssL[i]}, UnitValue{sR[i], ssR[i]});
+      s[i] = sss.s, ss[i] = sss.ss;
+    }
+  }
+
+  static void sub(const int64_t* sL, const int64_t* ssL, const int64_t* sR,
+      const int64_t* ssR, int64_t* s, int64_t* ss, size_t i,
+      size_t n) noexcept {
+    for (; i < n; ++i) {
+      UnitValue sss = add(
+          UnitValue{sL[i], ssL[i]}, negate(UnitValue{sR[i], ssR[i]}));
+      s[i] = sss.s, ss[i] = sss.ss;
+    }
+  }
+
+  static void addValue(const int64_t* sL, const int64_t* ssL, UnitValue r,
+      int64_t* s, int64_t* ss, size_t i, size_t n) noexcept {
+    for (; i < n; ++i) {
+      UnitValue sss = add(UnitValue{sL[i], ssL[i]}, r);
+      s[i] = sss.s, ss[i] = sss.ss;
+    }
+  }
+
+  static void compareValue(const int64_t* sL, const int64_t* ssL, UnitValue r,
+      int8_t* out, size_t i, size_t n) noexcept {
+    for (; i < n; ++i) out[i] = compare(UnitValue{sL[i], ssL[i]}, r);
+  }
+
+  // The vector accumulators are drained into this at least this often, in
+  // iterations, so that their picoseconds can't overflow.
+  static constexpr size_t FlushInterval = size_t(1) << 22;
+
+  // Partial sum: the exact total of the numbers seen so far, which special
+  // values were seen, and a bound on the magnitude of the seconds, which is at
+  // least the largest of them. The seconds wrap, as they're only used once the
+  // bound shows that they can't have.
+  struct SumParts {
+    uint64_t s = 0;
+    int64_t ss = 0;
+    uint64_t bound = 0;
+    bool nan = false, infP = false, infN = false;
+
+    constexpr void add(int64_t sR, int64_t ssR) noexcept {
+      nan |= sR == Traits::NaN;
+      infP |= sR == Traits::InfP;
+      infN |= sR == Traits::InfN;
+      if (isSpecial(sR)) sR = 0;
+      s += static_cast<uint64_t>(sR);
+      ss += ssR;
+      bound |= static_cast<uint64_t>(sR < 0 ? -sR : sR);
+    }
+
+    // Carries whole seconds out of the picoseconds.
+    constexpr void flush() noexcept {
+      s += static_cast<uint64_t>(ss / PicosPerSecond);
+      ss %= PicosPerSecond;
+    }
+  };
+
+  static void sum(SumParts& parts, const int64_t* s, const int64_t* ss,
+      size_t i, size_t n) noexcept {
+    for (; i < n; ++i) {
+      parts.add(s[i], ss[i]);
+      if (i % FlushInterval == 0) parts.flush();
+    }
+  }
+
+  static UnitValue fold(
+      const int64_t* s, const int64_t* ss, size_t n) noexcept {
+    UnitValue total{0, 0};
+    for (size_t i = 0; i < n; ++i) total = add(total, UnitValue{s[i], ss[i]});
+    return total;
+  }
+
+  static UnitValue finishSum(SumParts parts, const int64_t* s,
+      const int64_t* ss, size_t n) noexcept {
+    // Every value is under bound + 1 seconds, so no running total can reach
+    // n * (bound + 1). Unless that's in range, start over.
+    parts.flush();
+    if (n && parts.bound >= static_cast<uint64_t>(Traits::Max) / n)
+      return fold(s, ss, n);
+    if (parts.nan || (parts.infP && parts.infN))
+      return UnitValue{Traits::NaN, 0};
+    if (parts.infP || parts.infN) return saturate(parts.infN);
+    auto total = static_cast<int64_t>(parts.s);
+    int64_t picos = parts.ss;
+    if (picos > 0 && total < 0)
+      picos -= PicosPerSecond, ++total;
+    else if (picos < 0 && total > 0)
+      picos += PicosPerSecond, --total;
+    return UnitValue{total, picos};
+  }
+
+  // Partial minimum or maximum, with NaN noted separately.
+  template<bool Greatest>
+  struct ExtremeParts {
+    UnitValue value{Greatest ? Traits::InfN : Traits::InfP, 0};
+    bool nan = false;
+
+    constexpr UnitValue finish() const noexcept {
+      return nan ? UnitValue{Traits::NaN, 0} : value;
+    }
+  };
+
+  template<bool Greatest>
+  static void extreme(ExtremeParts<Greatest>& parts, const int64_t* s,
+      const int64_t* ss, size_t i, size_t n) noexcept {
+    for (; i < n; ++i) {
+      UnitValue sss{s[i], ss[i]};
+      if (sss.s == Traits::NaN)
+        parts.nan = true;
+      else if (Greatest ? parts.value < sss : sss < parts.value)
+        parts.value = sss;
+    }
+  }
+
+  static void countCategories(
+      CategoryCounts& counts, const int64_t* s, size_t i, size_t n) noexcept {
+    for (; i < n; ++i) ++counts[static_cast<size_t>(Traits::toCategory(s[i]))];
+  }
+};
+} // namespace details
+
+// Scalar backend: one value at a time. Works everywhere.
+template<>
+struct ColumnOps<ColumnBackend::Scalar> {
+  static constexpr bool available = true;
+  using Lane = details::ColumnLane;
+
+  static void add(const int64_t* sL, const int64_t* ssL, const int64_t* sR,
+      const int64_t* ssR, int64_t* s, int64_t* ss, size_t n) noexcept {
+    Lane::add(sL, ssL, sR, ssR, s, ss, 0, n);
+  }
+
+  static void sub(const int64_t* sL, const int64_t* ssL, const int64_t* sR,
+      const int64_t* ssR, int64_t* s, int64_t* ss, size_t n) noexcept {
+    Lane::sub(sL, ssL, sR, ssR, s, ss, 0, n);
+  }
+
+  static void addValue(const int64_t* sL, const int64_t* ssL, UnitValue r,
+      int64_t* s, int64_t* ss, size_t n) noexcept {
+    Lane::addValue(sL, ssL, r, s, ss, 0, n);
+  }
+
+  static void compareValue(const int64_t* sL, const int64_t* ssL, UnitValue r,
+      int8_t* out, size_t n) noexcept {
+    Lane::compareValue(sL, ssL, r, out, 0, n);
+  }
+
+  static UnitValue sum(const int64_t* s, const int64_t* ss, size_t n) noexcept {
+    Lane::SumParts parts;
+    Lane::sum(parts, s, ss, 0, n);
+    return Lane::finishSum(parts, s, ss, n);
+  }
+
+  static UnitValue minimum(
+      const int64_t* s, const int64_t* ss, size_t n) noexcept {
+    Lane::ExtremeParts<false> parts;
+    Lane::extreme(parts, s, ss, 0, n);
+    return parts.finish();
+  }
+
+  static UnitValue maximum(
+      const int64_t* s, const int64_t* ss, size_t n) noexcept {
+    Lane::ExtremeParts<true> parts;
+    Lane::extreme(parts, s, ss, 0, n);
+    return parts.finish();
+  }
+
+  static CategoryCounts countCategories(const int64_t* s, size_t n) noexcept {
+    CategoryCounts counts{};
+    Lane::countCategories(counts, s, 0, n);
+    return counts;
+  }
+};
+
+#ifdef __AVX2__
+// AVX2 backend: four values at a time. Lacking mask registers, each condition
+// is a vector of all-ones or all-zeros lanes, which doubles as -1 or 0 for
+// adjusting the seconds.
+template<>
+struct ColumnOps<ColumnBackend::Avx2> {
+  static constexpr bool available = true;
+  using Lane = details::ColumnLane;
+  using Traits = SecondsTraits<>;
+  static constexpr size_t Width = 4;
+
+  static void add(const int64_t* sL, const int64_t* ssL, const int64_t* sR,
+      const int64_t* ssR, int64_t* s, int64_t* ss, size_t n) noexcept {
+    size_t i = 0;
+    for (; i + Width <= n; i += Width)
+      store(s, ss, i,
+          addVec(load(sL + i), load(ssL + i), load(sR + i), load(ssR + i)));
+    Lane::add(sL, ssL, sR, ssR, s, ss, i, n);
+  }
+
+  static void sub(const int64_t* sL, const int64_t* ssL, const int64_t* sR,
+      const int64_t* ssR, int64_t* s, int64_t* ss, size_t n) noexcept {
+    const __m256i nan = _mm256_set1_epi64x(Traits::NaN);
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + Width <= n; i += Width) {
+      __m256i r = load(sR + i);
+      r = _mm256_blendv_epi8(
+          _mm256_sub_epi64(zero, r), nan, _mm256_cmpeq_epi64(r, nan));
+      store(s, ss, i,
+          addVec(load(sL + i), load(ssL + i), r,
+              _mm256_sub_epi64(zero, load(ssR + i))));
+    }
+    Lane::sub(sL, ssL, sR, ssR, s, ss, i, n);
+  }
+
+  static void addValue(const int64_t* sL, const int64_t* ssL, UnitValue r,
+      int64_t* s, int64_t* ss, size_t n) noexcept {
+    const __m256i sR = _mm256_set1_epi64x(r.s);
+    const __m256i ssR = _mm256_set1_epi64x(r.ss);
+    size_t i = 0;
+    for (; i + Width <= n; i += Width)
+      store(s, ss, i, addVec(load(sL + i), load(ssL + i), sR, ssR));
+    Lane::addValue(sL, ssL, r, s, ss, i, n);
+  }
+
+  static void compareValue(const int64_t* sL, const int64_t* ssL, UnitValue r,
+      int8_t* out, size_t n) noexcept {
+    if (r.s == Traits::NaN) {
+      std::memset(out, 1, n);
+      return;
+    }
+    const __m256i sR = _mm256_set1_epi64x(r.s);
+    const __m256i ssR = _mm256_set1_epi64x(r.ss);
+    const __m256i nan = _mm256_set1_epi64x(Traits::NaN);
+    size_t i = 0;
+    for (; i + Width <= n; i += Width) {
+      __m256i s = load(sL + i), ss = load(ssL + i);
+      __m256i eq = _mm256_cmpeq_epi64(s, sR);
+      __m256i gt = _mm256_or_si256(_mm256_cmpgt_epi64(s, sR),
+          _mm256_and_si256(eq, _mm256_cmpgt_epi64(ss, ssR)));
+      __m256i lt = _mm256_or_si256(_mm256_cmpgt_epi64(sR, s),
+          _mm256_and_si256(eq, _mm256_cmpgt_epi64(ssR, ss)));
+      __m256i isNaN = _mm256_cmpeq_epi64(s, nan);
+      gt = _mm256_or_si256(gt, isNaN);
+      lt = _mm256_andnot_si256(isNaN, lt);
+      // Spread the lane masks into bytes of +1 and -1.
+      uint32_t bytes = spread(bits(gt), 0x01) | spread(bits(lt), 0xFF);
+      std::memcpy(out + i, &bytes, sizeof(bytes));
+    }
+    Lane::compareValue(sL, ssL, r, out, i, n);
+  }
+
+  static UnitValue sum(const int64_t* s, const int64_t* ss, size_t n) noexcept {
+    // Two sets of accumulators, so that consecutive adds don't wait on each
+    // other.
+    SumVec acc[2];
+    Lane::SumParts parts;
+    size_t i = 0, sinceFlush = 0;
+    for (; i + 2 * Width <= n; i += 2 * Width) {
+      acc[0].add(load(s + i), load(ss + i));
+      acc[1].add(load(s + i + Width), load(ss + i + Width));
+      if (++sinceFlush == Lane::FlushInterval) {
+        acc[0].drain(parts), acc[1].drain(parts);
+        sinceFlush = 0;
+      }
+    }
+    acc[0].drain(parts), acc[1].drain(parts);
+    Lane::sum(parts, s, ss, i, n);
+    return Lane::finishSum(parts, s, ss, n);
+  }
+
+  static UnitValue minimum(
+      const int64_t* s, const int64_t* ss, size_t n) noexcept {
+    return extreme<false>(s, ss, n);
+  }
+
+  static UnitValue maximum(
+      const int64_t* s, const int64_t* ss, size_t n) noexcept {
+    return extreme<true>(s, ss, n);
+  }
+
+  static CategoryCounts countCategories(const int64_t* s, size_t n) noexcept {
+    const __m256i nan = _mm256_set1_epi64x(Traits::NaN);
+    const __m256i infN = _mm256_set1_epi64x(Traits::InfN);
+    const __m256i infP = _mm256_set1_epi64x(Traits::InfP);
+    // Each all-ones match is -1, so subtracting counts up.
+    __m256i counts[3] = {_mm256_setzero_si256(), _mm256_setzero_si256(),
+        _mm256_setzero_si256()};
+    size_t i = 0;
+    for (; i + Width <= n; i += Width) {
+      __m256i v = load(s + i);
+      counts[0] = _mm256_sub_epi64(counts[0], _mm256_cmpeq_epi64(v, nan));
+      counts[1] = _mm256_sub_epi64(counts[1], _mm256_cmpeq_epi64(v, infN));
+      counts[2] = _mm256_sub_epi64(counts[2], _mm256_cmpeq_epi64(v, infP));
+    }
+    CategoryCounts out{};
+    size_t special = 0;
+    for (int k = 0; k < 3; ++k) {
+      int64_t lanes[Width];
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), counts[k]);
+      out[k + 1] =
+          static_cast<size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+      special += out[k + 1];
+    }
+    out[static_cast<size_t>(Category::Num)] = i - special;
+    Lane::countCategories(out, s, i, n);
+    return out;
+  }
+
+private:
+  struct Vec {
+    __m256i s, ss;
+  };
+
+  // Vector of partial sums, drained into Lane::SumParts.
+  struct SumVec {
+    __m256i s = _mm256_setzero_si256(), ss = _mm256_setzero_si256();
+    __m256i bound = _mm256_setzero_si256();
+    __m256i nan = _mm256_setzero_si256(), infP = _mm256_setzero_si256(),
+            infN = _mm256_setzero_si256();
+
+    void add(__m256i sR, __m256i ssR) noexcept {
+      __m256i isNaN = _mm256_cmpeq_epi64(sR, _mm256_set1_epi64x(Traits::NaN));
+      __m256i isP = _mm256_cmpeq_epi64(sR, _mm256_set1_epi64x(Traits::InfP));
+      __m256i isN = _mm256_cmpeq_epi64(sR, _mm256_set1_epi64x(Traits::InfN));
+      nan = _mm256_or_si256(nan, isNaN);
+      infP = _mm256_or_si256(infP, isP);
+      infN = _mm256_or_si256(infN, isN);
+      sR = _mm256_andnot_si256(
+          _mm256_or_si256(isNaN, _mm256_or_si256(isP, isN)), sR);
+      s = _mm256_add_epi64(s, sR);
+      ss = _mm256_add_epi64(ss, ssR);
+      __m256i sign = _mm256_cmpgt_epi64(_mm256_setzero_si256(), sR);
+      bound = _mm256_or_si256(
+          bound, _mm256_sub_epi64(_mm256_xor_si256(sR, sign), sign));
+    }
+
+    void drain(Lane::SumParts& parts) noexcept {
+      int64_t lanesS[Width], lanesSS[Width], lanesBound[Width];
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanesS), s);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanesSS), ss);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanesBound), bound);
+      for (size_t k = 0; k < Width; ++k) {
+        parts.s += static_cast<uint64_t>(lanesS[k]);
+        parts.ss += lanesSS[k];
+        parts.bound |= static_cast<uint64_t>(lanesBound[k]);
+        parts.flush();
+      }
+      parts.nan |= bits(nan) != 0;
+      parts.infP |= bits(infP) != 0;
+      parts.infN |= bits(infN) != 0;
+      *this = SumVec();
+    }
+  };
+
+  template<bool Greatest>
+  static UnitValue extreme(
+      const int64_t* s, const int64_t* ss, size_t n) noexcept {
+    const __m256i nan = _mm256_set1_epi64x(Traits::NaN);
+    __m256i bestS =
+        _mm256_set1_epi64x(Greatest ? Traits::InfN : Traits::InfP);
+    __m256i bestSS = _mm256_setzero_si256();
+    __m256i anyNaN = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + Width <= n; i += Width) {
+      __m256i sv = load(s + i), ssv = load(ss + i);
+      __m256i isNaN = _mm256_cmpeq_epi64(sv, nan);
+      anyNaN = _mm256_or_si256(anyNaN, isNaN);
+      __m256i hi = Greatest ? sv : bestS, lo = Greatest ? bestS : sv;
+      __m256i hiSS = Greatest ? ssv : bestSS, loSS = Greatest ? bestSS : ssv;
+      __m256i better = _mm256_andnot_si256(isNaN,
+          _mm256_or_si256(_mm256_cmpgt_epi64(hi, lo),
+              _mm256_and_si256(_mm256_cmpeq_epi64(hi, lo),
+                  _mm256_cmpgt_epi64(hiSS, loSS))));
+      bestS = _mm256_blendv_epi8(bestS, sv, better);
+      bestSS = _mm256_blendv_epi8(bestSS, ssv, better);
+    }
+    int64_t lanesS[Width], lanesSS[Width];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanesS), bestS);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanesSS), bestSS);
+    Lane::ExtremeParts<Greatest> parts;
+    Lane::extreme(parts, lanesS, lanesSS, 0, Width);
+    parts.nan = bits(anyNaN) != 0;
+    Lane::extreme(parts, s, ss, i, n);
+    return parts.finish();
+  }
+
+  static __m256i load(const int64_t* p) noexcept {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  }
+
+  static void store(int64_t* s, int64_t* ss, size_t i, Vec v) noexcept {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(s + i), v.s);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(ss + i), v.ss);
+  }
+
+  static uint32_t bits(__m256i mask) noexcept {
+    return static_cast<uint32_t>(
+        _mm256_movemask_pd(_mm256_castsi256_pd(mask)));
+  }
+
+  // Sets each byte whose bit is set to the given value.
+  static uint32_t spread(uint32_t bits, uint32_t byte) noexcept {
+    return ((bits & 1) * byte) | ((bits >> 1 & 1) * byte << 8) |
+        ((bits >> 2 & 1) * byte << 16) | ((bits >> 3 & 1) * byte << 24);
+  }
+
+  static __m256i isSpecial(__m256i s) noexcept {
+    return _mm256_or_si256(
+        _mm256_cmpgt_epi64(s, _mm256_set1_epi64x(Traits::Max)),
+        _mm256_cmpgt_epi64(_mm256_set1_epi64x(Traits::Min), s));
+  }
+
+  // The same steps as ColumnLane::add, but computing every outcome and
+  // blending, instead of branching.
+  static Vec addVec(__m256i sL, __m256i ssL, __m256i sR, __m256i ssR) noexcept {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i p = _mm256_set1_epi64x(PicosPerSecond);
+    const __m256i infP = _mm256_set1_epi64x(Traits::InfP);
+    const __m256i infN = _mm256_set1_epi64x(Traits::InfN);
+
+    // Carry any whole second out of the subseconds.
+    __m256i ss = _mm256_add_epi64(ssL, ssR);
+    __m256i up = _mm256_cmpgt_epi64(ss, _mm256_set1_epi64x(PicosPerSecond - 1));
+    __m256i down =
+        _mm256_cmpgt_epi64(_mm256_set1_epi64x(1 - PicosPerSecond), ss);
+    ss = _mm256_sub_epi64(ss, _mm256_and_si256(up, p));
+    ss = _mm256_add_epi64(ss, _mm256_and_si256(down, p));
+    __m256i r = _mm256_add_epi64(_mm256_sub_epi64(sR, up), down);
+
+    // Add the seconds, noting overflow, which is when the sign of the sum
+    // differs from that of both inputs.
+    __m256i s = _mm256_add_epi64(sL, r);
+    __m256i over = _mm256_cmpgt_epi64(zero,
+        _mm256_and_si256(_mm256_xor_si256(sL, s), _mm256_xor_si256(r, s)));
+
+    // Match the signs.
+    __m256i pos = _mm256_and_si256(
+        _mm256_cmpgt_epi64(ss, zero), _mm256_cmpgt_epi64(zero, s));
+    __m256i neg = _mm256_and_si256(
+        _mm256_cmpgt_epi64(zero, ss), _mm256_cmpgt_epi64(s, zero));
+    ss = _mm256_sub_epi64(ss, _mm256_and_si256(pos, p));
+    ss = _mm256_add_epi64(ss, _mm256_and_si256(neg, p));
+    s = _mm256_add_epi64(_mm256_sub_epi64(s, pos), neg);
+
+    // Saturate, taking the sign from the right on overflow, since both sides
+    // share it.
+    __m256i toP = _mm256_blendv_epi8(
+        _mm256_cmpgt_epi64(s, _mm256_set1_epi64x(Traits::Max)),
+        _mm256_cmpgt_epi64(r, zero), over);
+    __m256i toN = _mm256_blendv_epi8(
+        _mm256_cmpgt_epi64(_mm256_set1_epi64x(Traits::Min), s),
+        _mm256_cmpgt_epi64(zero, r), over);
+    s = _mm256_blendv_epi8(s, infP, toP);
+    s = _mm256_blendv_epi8(s, infN, toN);
+
+    // Special values on either side override all of that.
+    __m256i specL = isSpecial(sL), specR = isSpecial(sR);
+    __m256i both = _mm256_and_si256(specL, specR);
+    __m256i same = _mm256_blendv_epi8(_mm256_set1_epi64x(Traits::NaN), sL,
+        _mm256_cmpeq_epi64(sL, sR));
+    s = _mm256_blendv_epi8(s, sR, specR);
+    s = _mm256_blendv_epi8(s, sL, specL);
+    s = _mm256_blendv_epi8(s, same, both);
+    __m256i cleared = _mm256_or_si256(
+        _mm256_or_si256(toP, toN), _mm256_or_si256(specL, specR));
+    return Vec{s, _mm256_andnot_si256(cleared, ss)};
+  }
+};
+#endif
+
+#ifdef __AVX512F__
+// AVX-512 backend: eight values at a time, with conditions in mask registers.
+template<>
+struct ColumnOps<ColumnBackend::Avx512> {
+  static constexpr bool available = true;
+  using Lane = details::ColumnLane;
+  using Traits = SecondsTraits<>;
+  static constexpr size_t Width = 8;
+
+  static void add(const int64_t* sL, const int64_t* ssL, const int64_t* sR,
+      const int64_t* ssR, int64_t* s, int64_t* ss, size_t n) noexcept {
+    size_t i = 0;
+    for (; i + Width <= n; i += Width)
+      store(s, ss, i,
+          addVec(load(sL + i), load(ssL + i), load(sR + i), load(ssR + i)));
+    Lane::add(sL, ssL, sR, ssR, s, ss, i, n);
+  }
+
+  static void sub(const int64_t* sL, const int64_t* ssL, const int64_t* sR,
+      const int64_t* ssR, int64_t* s, int64_t* ss, size_t n) noexcept {
+    const __m512i nan = _mm512_set1_epi64(Traits::NaN);
+    const __m512i zero = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + Width <= n; i += Width) {
+      __m512i r = load(sR + i);
+      r = _mm512_mask_sub_epi64(
+          r, _mm512_cmpneq_epi64_mask(r, nan), zero, r);
+      store(s, ss, i,
+          addVec(load(sL + i), load(ssL + i), r,
+              _mm512_sub_epi64(zero, load(ssR + i))));
+    }
+    Lane::sub(sL, ssL, sR, ssR, s, ss, i, n);
+  }
+
+  static void addValue(const int64_t* sL, const int64_t* ssL, UnitValue r,
+      int64_t* s, int64_t* ss, size_t n) noexcept {
+    const __m512i sR = _mm512_set1_epi64(r.s);
+    const __m512i ssR = _mm512_set1_epi64(r.ss);
+    size_t i = 0;
+    for (; i + Width <= n; i += Width)
+      store(s, ss, i, addVec(load(sL + i), load(ssL + i), sR, ssR));
+    Lane::addValue(sL, ssL, r, s, ss, i, n);
+  }
+
+  static void compareValue(const int64_t* sL, const int64_t* ssL, UnitValue r,
+      int8_t* out, size_t n) noexcept {
+    if (r.s == Traits::NaN) {
+      std::memset(out, 1, n);
+      return;
+    }
+    const __m512i sR = _mm512_set1_epi64(r.s);
+    const __m512i ssR = _mm512_set1_epi64(r.ss);
+    const __m512i nan = _mm512_set1_epi64(Traits::NaN);
+    size_t i = 0;
+    for (; i + Width <= n; i += Width) {
+      __m512i s = load(sL + i), ss = load(ssL + i);
+      __mmask8 eq = _mm512_cmpeq_epi64_mask(s, sR);
+      __mmask8 isNaN = _mm512_cmpeq_epi64_mask(s, nan);
+      __mmask8 gt = _mm512_cmpgt_epi64_mask(s, sR) |
+          (eq & _mm512_cmpgt_epi64_mask(ss, ssR)) | isNaN;
+      __mmask8 lt = (_mm512_cmpgt_epi64_mask(sR, s) |
+                        (eq & _mm512_cmpgt_epi64_mask(ssR, ss))) &
+          ~isNaN;
+      __m512i cmp = _mm512_mask_set1_epi64(
+          _mm512_maskz_set1_epi64(gt, 1), lt, -1);
+      _mm512_mask_cvtepi64_storeu_epi8(out + i, 0xFF, cmp);
+    }
+    Lane::compareValue(sL, ssL, r, out, i, n);
+  }
+
+  static UnitValue sum(const int64_t* s, const int64_t* ss, size_t n) noexcept {
+    // Two sets of accumulators, so that consecutive adds don't wait on each
+    // other.
+    SumVec acc[2];
+    Lane::SumParts parts;
+    size_t i = 0, sinceFlush = 0;
+    for (; i + 2 * Width <= n; i += 2 * Width) {
+      acc[0].add(load(s + i), load(ss + i));
+      acc[1].add(load(s + i + Width), load(ss + i + Width));
+      if (++sinceFlush == Lane::FlushInterval) {
+        acc[0].drain(parts), acc[1].drain(parts);
+        sinceFlush = 0;
+      }
+    }
+    acc[0].drain(parts), acc[1].drain(parts);
+    Lane::sum(parts, s, ss, i, n);
+    return Lane::finishSum(parts, s, ss, n);
+  }
+
+  static UnitValue minimum(
+      const int64_t* s, const int64_t* ss, size_t n) noexcept {
+    return extreme<false>(s, ss, n);
+  }
+
+  static UnitValue maximum(
+      const int64_t* s, const int64_t* ss, size_t n) noexcept {
+    return extreme<true>(s, ss, n);
+  }
+
+  static CategoryCounts countCategories(const int64_t* s, size_t n) noexcept {
+    const __m512i nan = _mm512_set1_epi64(Traits::NaN);
+    const __m512i infN = _mm512_set1_epi64(Traits::InfN);
+    const __m512i infP = _mm512_set1_epi64(Traits::InfP);
+    CategoryCounts out{};
+    size_t i = 0;
+    for (; i + Width <= n; i += Width) {
+      __m512i v = load(s + i);
+      out[1] += std::popcount(
+          static_cast<unsigned>(_mm512_cmpeq_epi64_mask(v, nan)));
+      out[2] += std::popcount(
+          static_cast<unsigned>(_mm512_cmpeq_epi64_mask(v, infN)));
+      out[3] += std::popcount(
+          static_cast<unsigned>(_mm512_cmpeq_epi64_mask(v, infP)));
+    }
+    out[static_cast<size_t>(Category::Num)] = i - out[1] - out[2] - out[3];
+    Lane::countCategories(out, s, i, n);
+    return out;
+  }
+
+private:
+  struct Vec {
+    __m512i s, ss;
+  };
+
+  // Vector of partial sums, drained into Lane::SumParts.
+  struct SumVec {
+    __m512i s = _mm512_setzero_si512(), ss = _mm512_setzero_si512();
+    __m512i bound = _mm512_setzero_si512();
+    __mmask8 nan = 0, infP = 0, infN = 0;
+
+    void add(__m512i sR, __m512i ssR) noexcept {
+      __mmask8 isNaN =
+          _mm512_cmpeq_epi64_mask(sR, _mm512_set1_epi64(Traits::NaN));
+      __mmask8 isP =
+          _mm512_cmpeq_epi64_mask(sR, _mm512_set1_epi64(Traits::InfP));
+      __mmask8 isN =
+          _mm512_cmpeq_epi64_mask(sR, _mm512_set1_epi64(Traits::InfN));
+      nan |= isNaN, infP |= isP, infN |= isN;
+      sR = _mm512_maskz_mov_epi64(
+          static_cast<__mmask8>(~(isNaN | isP | isN)), sR);
+      s = _mm512_add_epi64(s, sR);
+      ss = _mm512_add_epi64(ss, ssR);
+      const __m512i zero = _mm512_setzero_si512();
+      bound = _mm512_or_si512(bound,
+          _mm512_mask_sub_epi64(
+              sR, _mm512_cmplt_epi64_mask(sR, zero), zero, sR));
+    }
+
+    void drain(Lane::SumParts& parts) noexcept {
+      int64_t lanesS[Width], lanesSS[Width], lanesBound[Width];
+      _mm512_storeu_si512(lanesS, s);
+      _mm512_storeu_si512(lanesSS, ss);
+      _mm512_storeu_si512(lanesBound, bound);
+      for (size_t k = 0; k < Width; ++k) {
+        parts.s += static_cast<uint64_t>(lanesS[k]);
+        parts.ss += lanesSS[k];
+        parts.bound |= static_cast<uint64_t>(lanesBound[k]);
+        parts.flush();
+      }
+      parts.nan |= nan != 0;
+      parts.infP |= infP != 0;
+      parts.infN |= infN != 0;
+      *this = SumVec();
+    }
+  };
+
+  template<bool Greatest>
+  static UnitValue extreme(
+      const int64_t* s, const int64_t* ss, size_t n) noexcept {
+    const __m512i nan = _mm512_set1_epi64(Traits::NaN);
+    __m512i bestS = _mm512_set1_epi64(Greatest ? Traits::InfN : Traits::InfP);
+    __m512i bestSS = _mm512_setzero_si512();
+    __mmask8 anyNaN = 0;
+    size_t i = 0;
+    for (; i + Width <= n; i += Width) {
+      __m512i sv = load(s + i), ssv = load(ss + i);
+      __mmask8 isNaN = _mm512_cmpeq_epi64_mask(sv, nan);
+      anyNaN |= isNaN;
+      __m512i hi = Greatest ? sv : bestS, lo = Greatest ? bestS : sv;
+      __m512i hiSS = Greatest ? ssv : bestSS, loSS = Greatest ? bestSS : ssv;
+      __mmask8 better = (_mm512_cmpgt_epi64_mask(hi, lo) |
+                            (_mm512_cmpeq_epi64_mask(hi, lo) &
+                                _mm512_cmpgt_epi64_mask(hiSS, loSS))) &
+          ~isNaN;
+      bestS = _mm512_mask_mov_epi64(bestS, better, sv);
+      bestSS = _mm512_mask_mov_epi64(bestSS, better, ssv);
+    }
+    int64_t lanesS[Width], lanesSS[Width];
+    _mm512_storeu_si512(lanesS, bestS);
+    _mm512_storeu_si512(lanesSS, bestSS);
+    Lane::ExtremeParts<Greatest> parts;
+    Lane::extreme(parts, lanesS, lanesSS, 0, Width);
+    parts.nan = anyNaN != 0;
+    Lane::extreme(parts, s, ss, i, n);
+    return parts.finish();
+  }
+
+  static __m512i load(const int64_t* p) noexcept {
+    return _mm512_loadu_si512(p);
+  }
+
+  static void store(int64_t* s, int64_t* ss, size_t i, Vec v) noexcept {
+    _mm512_storeu_si512(s + i, v.s);
+    _mm512_storeu_si512(ss + i, v.ss);
+  }
+
+  static __mmask8 isSpecial(__m512i s) noexcept {
+    return _mm512_cmpgt_epi64_mask(s, _mm512_set1_epi64(Traits::Max)) |
+        _mm512_cmplt_epi64_mask(s, _mm512_set1_epi64(Traits::Min));
+  }
+
+  // The same steps as ColumnLane::add, with masked operations in place of
+  // branches.
+  static Vec addVec(__m512i sL, __m512i ssL, __m512i sR, __m512i ssR) noexcept {
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i p = _mm512_set1_epi64(PicosPerSecond);
+    const __m512i one = _mm512_set1_epi64(1);
+
+    // Carry any whole second out of the subseconds.
+    __m512i ss = _mm512_add_epi64(ssL, ssR);
+    __mmask8 up = _mm512_cmpge_epi64_mask(ss, p);
+    __mmask8 down = _mm512_cmple_epi64_mask(ss, _mm512_sub_epi64(zero, p));
+    ss = _mm512_mask_sub_epi64(ss, up, ss, p);
+    ss = _mm512_mask_add_epi64(ss, down, ss, p);
+    __m512i r = _mm512_mask_add_epi64(sR, up, sR, one);
+    r = _mm512_mask_sub_epi64(r, down, r, one);
+
+    // Add the seconds, noting overflow. The ternary logic computes
+    // (sL ^ s) & (r ^ s), whose sign is set on overflow.
+    __m512i s = _mm512_add_epi64(sL, r);
+    __mmask8 over = _mm512_cmplt_epi64_mask(
+        _mm512_ternarylogic_epi64(sL, r, s, 0x42), zero);
+
+    // Match the signs.
+    __mmask8 pos = _mm512_cmpgt_epi64_mask(ss, zero) &
+        _mm512_cmplt_epi64_mask(s, zero);
+    __mmask8 neg = _mm512_cmplt_epi64_mask(ss, zero) &
+        _mm512_cmpgt_epi64_mask(s, zero);
+    ss = _mm512_mask_sub_epi64(ss, pos, ss, p);
+    ss = _mm512_mask_add_epi64(ss, neg, ss, p);
+    s = _mm512_mask_add_epi64(s, pos, s, one);
+    s = _mm512_mask_sub_epi64(s, neg, s, one);
+
+    // Saturate, taking the sign from the right on overflow.
+    __mmask8 toP = (over & _mm512_cmpgt_epi64_mask(r, zero)) |
+        (~over & _mm512_cmpgt_epi64_mask(s, _mm512_set1_epi64(Traits::Max)));
+    __mmask8 toN = (over & _mm512_cmplt_epi64_mask(r, zero)) |
+        (~over & _mm512_cmplt_epi64_mask(s, _mm512_set1_epi64(Traits::Min)));
+    s = _mm512_mask_mov_epi64(s, toP, _mm512_set1_epi64(Traits::InfP));
+    s = _mm512_mask_mov_epi64(s, toN, _mm512_set1_epi64(Traits::InfN));
+
+    // Special values on either side override all of that.
+    __mmask8 specL = isSpecial(sL), specR = isSpecial(sR);
+    __m512i same = _mm512_mask_mov_epi64(_mm512_set1_epi64(Traits::NaN),
+        _mm512_cmpeq_epi64_mask(sL, sR), sL);
+    s = _mm512_mask_mov_epi64(s, specR, sR);
+    s = _mm512_mask_mov_epi64(s, specL, sL);
+    s = _mm512_mask_mov_epi64(s, specL & specR, same);
+    __mmask8 cleared = toP | toN | specL | specR;
+    return Vec{
+        s, _mm512_maskz_mov_epi64(static_cast<__mmask8>(~cleared), ss)};
+  }
+};
+#endif
+
+// The backend chosen for this platform, which is the widest available.
+constexpr const ColumnBackend NativeColumnBackend =
+    ColumnOps<ColumnBackend::Avx512>::available ? ColumnBackend::Avx512
+    : ColumnOps<ColumnBackend::Avx2>::available ? ColumnBackend::Avx2
+                                                : ColumnBackend::Scalar;
+
+using NativeColumnOps = ColumnOps<NativeColumnBackend>;
+} // namespace chronos
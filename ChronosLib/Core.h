@@ -3,7 +3,7 @@
 #include <limits>
 #include <utility>
 #include <compare>
-#include "util.h"
+#include "Util.h"
 
 namespace chronos {
 // Core types.
@@ -34,6 +34,7 @@ struct UnitValue {
     if (auto cmp = s <=> rhs.s; cmp != 0) return cmp;
     return ss <=> rhs.ss;
   }
+  constexpr bool operator==(const UnitValue& rhs) const noexcept = default;
 };
 
 // These constants are for an idealized calendar, with no time zones or leap
@@ -48,15 +49,35 @@ constexpr const UnitSeconds SecondsPerHour = SecondsPerMinute * 60;
 constexpr const UnitSeconds SecondsPerDay = SecondsPerHour * 24;
 constexpr const UnitSeconds SecondsPerYear = SecondsPerDay * 365;
 
+// Seconds from the de facto epoch, 0001-01-01, to the Unix epoch, 1970-01-01,
+// both in the proleptic Gregorian calendar.
+constexpr const UnitSeconds UnixEpochSeconds = 719'162 * SecondsPerDay;
+
+// Precomputed reciprocal for splitting wide picosecond counts into seconds.
+constexpr const WideDivisor PicosPerSecondDivisor{PicosPerSecond};
+
+// Gets the magnitude of a numeric value as a wide count of picoseconds. The
+// sign has to be kept track of separately.
+constexpr WidePair toWidePicos(const UnitValue& sss) noexcept {
+  auto s = static_cast<uint64_t>(sss.s < 0 ? -sss.s : sss.s);
+  auto ss = static_cast<uint64_t>(sss.ss < 0 ? -sss.ss : sss.ss);
+  return wideAdd(wideMul(s, PicosPerSecond), WidePair{0, ss});
+}
+
 // Seconds value categories.
 enum class Category { Num, NaN, InfN, InfP };
 
+namespace details {
+// Function-local statics aren't allowed in constexpr functions before C++23,
+// so this lives out here.
+inline constexpr auto CategoryNames =
+    make_array("Num"sv, "NaN"sv, "-Inf"sv, "+Inf"sv);
+} // namespace details
+
 // TODO: This would be a fine place to try out supporting a conversion more
 // canonically.
 constexpr const auto& asString(const Category& cat) {
-  static constexpr auto CategoryNames =
-      make_array("Num"sv, "NaN"sv, "-Inf"sv, "+Inf"sv);
-  return CategoryNames[static_cast<int>(cat)];
+  return details::CategoryNames[static_cast<int>(cat)];
 }
 
 // These traits define how we partition seconds to make room for NaN, negative
@@ -97,6 +118,24 @@ struct SecondsTraits {
   }
 };
 
+// Gets a key whose unsigned order, comparing hi before lo, is the order of the
+// values, with NaN after everything else, including positive infinity. The
+// seconds are offset from the bottom of their range, shifted down one to make
+// room for NaN at the top. The picoseconds are offset by one second, so that
+// they take up no more than 41 bits.
+constexpr WidePair toOrderKey(const UnitValue& sss) noexcept {
+  constexpr auto Bias = uint64_t(1) << 63;
+  return WidePair{(static_cast<uint64_t>(sss.s) ^ Bias) - 1,
+      static_cast<uint64_t>(sss.ss + PicosPerSecond)};
+}
+
+// Reverses toOrderKey.
+constexpr UnitValue fromOrderKey(const WidePair& key) noexcept {
+  constexpr auto Bias = uint64_t(1) << 63;
+  return UnitValue{static_cast<UnitSeconds>((key.hi + 1) ^ Bias),
+      static_cast<UnitPicos>(key.lo) - PicosPerSecond};
+}
+
 // Details of sniffing out seconds()/subseconds() methods.
 namespace details {
 template<class T, class = void>
@@ -104,7 +143,7 @@ struct has_seconds : std::false_type {};
 
 template<class T>
 struct has_seconds<T,
-    std::void_t<typename decltype(std::declval<T>().seconds())>>
+    std::void_t<decltype(std::declval<T>().seconds())>>
     : std::true_type {};
 
 template<class T, class = void>
@@ -112,9 +151,38 @@ struct has_subseconds : std::false_type {};
 
 template<class T>
 struct has_subseconds<T,
-    std::void_t<typename decltype(std::declval<T>().subseconds())>>
+    std::void_t<decltype(std::declval<T>().subseconds())>>
+    : std::true_type {};
+
+// Adapters may offer tryAdd and trySub, which work on representations
+// directly, and compare, which orders them directly. These are usually for
+// the adapter's own representation, but may be for another. See
+// RepAdapter<Picos128Rep> for details.
+template<class T, class U = T, class = void>
+struct has_direct_arithmetic : std::false_type {};
+
+template<class T, class U>
+struct has_direct_arithmetic<T, U,
+    std::void_t<decltype(std::declval<T&>().tryAdd(std::declval<const U&>())),
+        decltype(std::declval<T&>().trySub(std::declval<const U&>()))>>
     : std::true_type {};
 
+template<class T, class U = T>
+inline constexpr bool has_direct_arithmetic_v =
+    has_direct_arithmetic<T, U>::value;
+
+template<class T, class U = T, class = void>
+struct has_direct_compare : std::false_type {};
+
+template<class T, class U>
+struct has_direct_compare<T, U,
+    std::void_t<decltype(
+        std::declval<const T&>().compare(std::declval<const U&>()))>>
+    : std::true_type {};
+
+template<class T, class U = T>
+inline constexpr bool has_direct_compare_v = has_direct_compare<T, U>::value;
+
 }; // namespace details
 
 // Sniff out chronological scalars by their unique attributes.
@@ -134,6 +202,22 @@ struct is_scalar_unit : std::bool_constant<details::has_seconds<T>::value &&
 template<class T>
 constexpr bool is_scalar_unit_v = is_scalar_unit<T>::value;
 
+// Whether a representation's raw fields, compared from the most significant
+// down, order the same as the values they stand for, once NaN, which is the
+// SecondsTraits NaN of the most significant field, is set aside. Reps declare
+// this with a static rawComparable constant. Their adapters can then compare
+// values of the same rep without converting either, which is what ordered
+// containers and heaps of them spend most of their time doing.
+template<class Rep, class = void>
+struct is_raw_comparable : std::false_type {};
+
+template<class Rep>
+struct is_raw_comparable<Rep, std::void_t<decltype(Rep::rawComparable)>>
+    : std::bool_constant<Rep::rawComparable> {};
+
+template<class Rep>
+inline constexpr bool is_raw_comparable_v = is_raw_comparable<Rep>::value;
+
 // TODO: Update the natvis file.
 
 } // namespace chronos
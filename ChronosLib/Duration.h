@@ -28,18 +28,19 @@ public:
   using Parent::Parent;
   using Parent::operator=;
   using Parent::operator<=>;
+  using Parent::operator==;
 };
 
 template<typename ScalarT, typename ScalarU>
-constexpr const Duration<> operator+(
+constexpr const Duration<details::CommonScalar<ScalarT, ScalarU>> operator+(
     const Duration<ScalarT>& lhs, const Duration<ScalarU>& rhs) noexcept {
-  return Duration<>(lhs) += rhs;
+  return Duration<details::CommonScalar<ScalarT, ScalarU>>(lhs) += rhs;
 }
 
 template<typename ScalarT, typename ScalarU>
-constexpr const Duration<> operator-(
+constexpr const Duration<details::CommonScalar<ScalarT, ScalarU>> operator-(
     const Duration<ScalarT>& lhs, const Duration<ScalarU>& rhs) noexcept {
-  return Duration<>(lhs) -= rhs;
+  return Duration<details::CommonScalar<ScalarT, ScalarU>>(lhs) -= rhs;
 }
 
 template<typename ScalarT, typename U,
@@ -66,6 +67,94 @@ constexpr const Duration<> operator/(
   return Duration<>(lhs) /= rhs;
 }
 
+// Result of dividing one duration by another: the number of times the divisor
+// goes in, encoded like seconds, and what's left over. See
+// ScalarUnit::divide for details.
+struct DurationDiv {
+  UnitSeconds quot;
+  Duration<> rem;
+};
+
+template<typename ScalarT, typename ScalarU>
+constexpr DurationDiv div(
+    const Duration<ScalarT>& lhs, const Duration<ScalarU>& rhs) noexcept {
+  DurationDiv result{0, Duration<>(lhs)};
+  result.quot = Duration<>(lhs).divide(rhs, result.rem);
+  return result;
+}
+
+template<typename ScalarT, typename ScalarU>
+constexpr UnitSeconds operator/(
+    const Duration<ScalarT>& lhs, const Duration<ScalarU>& rhs) noexcept {
+  return div(lhs, rhs).quot;
+}
+
+template<typename ScalarT, typename ScalarU>
+constexpr const Duration<> operator%(
+    const Duration<ScalarT>& lhs, const Duration<ScalarU>& rhs) noexcept {
+  return Duration<>(lhs) %= rhs;
+}
+
+// Divides durations by a fixed divisor, as when bucketing by a fixed width.
+//
+// The results are the same as for div, but a reciprocal is precomputed so that
+// each division takes a few multiplies instead of a wide hardware divide. This
+// fast path covers divisors of less than 2^64 picoseconds, which is over 213
+// days. Larger divisors, and special values on either side, fall back to the
+// general division.
+template<typename Scalar = details::DefaultScalarUnit>
+class DurationDivisor {
+public:
+  constexpr explicit DurationDivisor(const Duration<Scalar>& divisor) noexcept
+      : m_divisor(divisor), m_fast(isFast(divisor.value())),
+        m_neg(divisor.value().s < 0 || divisor.value().ss < 0),
+        m_recip(m_fast ? toWidePicos(divisor.value()).lo : 1) {}
+
+  constexpr const Duration<Scalar>& divisor() const noexcept {
+    return m_divisor;
+  }
+
+  template<typename ScalarU>
+  constexpr DurationDiv div(const Duration<ScalarU>& lhs) const noexcept {
+    UnitValue sss = lhs.value();
+    if (!m_fast || SecondsTraits<>::toCategory(sss.s) != Category::Num)
+      return chronos::div(lhs, m_divisor);
+    bool negL(sss.s < 0 || sss.ss < 0), outNeg(negL != m_neg);
+    uint64_t r = 0;
+    WidePair q = m_recip.divu(toWidePicos(sss), r);
+    if (q.hi || q.lo > static_cast<uint64_t>(SecondsTraits<>::Max))
+      return DurationDiv{outNeg ? SecondsTraits<>::InfN : SecondsTraits<>::InfP,
+          Duration<>(Category::NaN)};
+    auto count = static_cast<UnitSeconds>(q.lo);
+    auto s = static_cast<UnitSeconds>(r / PicosPerSecond);
+    auto ss = static_cast<UnitPicos>(r % PicosPerSecond);
+    return DurationDiv{outNeg ? -count : count,
+        negL ? Duration<>(-s, -ss) : Duration<>(s, ss)};
+  }
+
+  template<typename ScalarU>
+  constexpr UnitSeconds count(const Duration<ScalarU>& lhs) const noexcept {
+    return div(lhs).quot;
+  }
+
+  template<typename ScalarU>
+  constexpr Duration<> remainder(const Duration<ScalarU>& lhs) const noexcept {
+    return div(lhs).rem;
+  }
+
+private:
+  Duration<Scalar> m_divisor;
+  bool m_fast;
+  bool m_neg;
+  WideDivisor m_recip;
+
+  static constexpr bool isFast(const UnitValue& sss) noexcept {
+    if (SecondsTraits<>::toCategory(sss.s) != Category::Num) return false;
+    WidePair d = toWidePicos(sss);
+    return !d.hi && d.lo;
+  }
+};
+
 // TODO: Add float support.
 
 // TODO: Figure out why this hack is needed. Minimally, see if it can be moved
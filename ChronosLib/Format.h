@@ -0,0 +1,284 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+#include <version>
+#include "Civil.h"
+#include "Moment.h"
+#ifdef __cpp_lib_format
+#include <format>
+#endif
+
+namespace chronos {
+// Formatting into caller buffers, in the manner of std::to_chars, for writers
+// that can't afford streams. Nothing is allocated.
+//
+// Durations and scalar units are written as decimal seconds, such as -1.250,
+// with a minus sign when negative. Moments are written as ISO 8601 timestamps
+// in UTC, such as 2024-02-29T12:34:56.789Z, which parseMoment reads back.
+// Years outside 0000 to 9999 get a sign and as many digits as they need. The
+// special values are written as their categories: NaN, -Inf, and +Inf.
+//
+// The fraction is truncated, toward zero for durations and toward the past
+// for moments, to the precision, which is a number of digits from 0 to 12.
+// The named ones are the usual choices, but any in the range may be cast.
+enum class Precision { Seconds = 0, Millis = 3, Micros = 6, Nanos = 9,
+  Picos = 12 };
+
+// The most that each form can take, for sizing buffers.
+constexpr const std::size_t MaxDecimalChars = 33;
+constexpr const std::size_t MaxIsoChars = 42;
+
+namespace details {
+// "00" through "99", so that digits can be written two at a time.
+inline constexpr auto DigitPairs = [] {
+  std::array<char, 200> pairs{};
+  for (int i = 0; i < 100; ++i) {
+    pairs[2 * i] = static_cast<char>('0' + i / 10);
+    pairs[2 * i + 1] = static_cast<char>('0' + i % 10);
+  }
+  return pairs;
+}();
+
+constexpr char* writePair(char* out, uint64_t value) noexcept {
+  out[0] = DigitPairs[2 * value];
+  out[1] = DigitPairs[2 * value + 1];
+  return out + 2;
+}
+
+// Writes exactly count digits, with leading zeros, from the last one back.
+constexpr char* writeFixed(char* out, uint64_t value, int count) noexcept {
+  char* end = out + count;
+  for (char* p = end; count > 0; count -= 2) {
+    if (count == 1) {
+      p[-1] = static_cast<char>('0' + value);
+      break;
+    }
+    writePair(p -= 2, value % 100);
+    value /= 100;
+  }
+  return end;
+}
+
+constexpr int countDigits(uint64_t value) noexcept {
+  // Estimate from the bit width, as the log of 2 in base 10 times 4096, then
+  // correct for the powers of ten between powers of two.
+  int estimate = std::bit_width(value) * 1'233 >> 12;
+  return estimate + (value >= PowersOfTen[estimate]);
+}
+
+constexpr char* writeUnsigned(char* out, uint64_t value) noexcept {
+  return writeFixed(out, value, std::max(countDigits(value), 1));
+}
+
+constexpr int fractionDigits(Precision precision) noexcept {
+  return std::clamp(static_cast<int>(precision), 0, 12);
+}
+
+// Writes the point and the first digits of the picoseconds, if there are to
+// be any.
+constexpr char* writeFraction(
+    char* out, uint64_t picos, int digits) noexcept {
+  if (!digits) return out;
+  *out++ = '.';
+  return writeFixed(out, picos / PowersOfTen[12 - digits], digits);
+}
+
+// Writes the category of a special value, returning null if it isn't one.
+constexpr char* writeCategory(char* out, UnitSeconds s) noexcept {
+  Category cat = SecondsTraits<>::toCategory(s);
+  if (cat == Category::Num) return nullptr;
+  for (char c : asString(cat)) *out++ = c;
+  return out;
+}
+
+constexpr char* writeDecimal(
+    char* out, UnitValue sss, int digits) noexcept {
+  if (char* end = writeCategory(out, sss.s)) return end;
+  bool negative = sss.s < 0 || sss.ss < 0;
+  if (negative) *out++ = '-';
+  auto s = static_cast<uint64_t>(negative ? -sss.s : sss.s);
+  auto ss = static_cast<uint64_t>(negative ? -sss.ss : sss.ss);
+  return writeFraction(writeUnsigned(out, s), ss, digits);
+}
+
+// Writes the date and time of day, through the seconds, of floored seconds.
+constexpr char* writeIsoPrefix(char* out, UnitSeconds s) noexcept {
+  UnitSeconds rest = 0;
+  CivilDate date = civilFromDays(splitDays(s, rest));
+
+  if (date.year >= 0 && date.year <= 9'999) {
+    out = writeFixed(out, static_cast<uint64_t>(date.year), 4);
+  } else {
+    *out++ = date.year < 0 ? '-' : '+';
+    auto year = static_cast<uint64_t>(date.year < 0 ? -date.year : date.year);
+    out = writeFixed(out, year, std::max(countDigits(year), 4));
+  }
+  *out++ = '-';
+  out = writePair(out, static_cast<uint64_t>(date.month));
+  *out++ = '-';
+  out = writePair(out, static_cast<uint64_t>(date.day));
+  *out++ = 'T';
+  out = writePair(out, static_cast<uint64_t>(rest / SecondsPerHour));
+  *out++ = ':';
+  out = writePair(
+      out, static_cast<uint64_t>(rest / SecondsPerMinute % 60));
+  *out++ = ':';
+  return writePair(out, static_cast<uint64_t>(rest % 60));
+}
+
+constexpr char* writeIsoSuffix(
+    char* out, UnitPicos picos, int digits) noexcept {
+  out = writeFraction(out, static_cast<uint64_t>(picos), digits);
+  *out++ = 'Z';
+  return out;
+}
+
+constexpr char* writeIso(char* out, UnitValue sss, int digits) noexcept {
+  if (char* end = writeCategory(out, sss.s)) return end;
+  out = writeIsoPrefix(out, floorSeconds(sss));
+  return writeIsoSuffix(out, sss.ss, digits);
+}
+
+// Writes straight into the caller's buffer if it's sure to be big enough.
+// Otherwise, writes to a scratch buffer, then copies only if it fits.
+template<std::size_t MaxChars, typename Writer>
+constexpr std::to_chars_result writeChecked(
+    char* first, char* last, const Writer& writer) noexcept {
+  if (last - first >= static_cast<std::ptrdiff_t>(MaxChars))
+    return std::to_chars_result{writer(first), std::errc()};
+  char scratch[MaxChars]{};
+  char* end = writer(scratch);
+  if (end - scratch > last - first)
+    return std::to_chars_result{last, std::errc::value_too_large};
+  return std::to_chars_result{std::copy(scratch, end, first), std::errc()};
+}
+} // namespace details
+
+template<typename Rep, template<typename> class Adapter>
+constexpr std::to_chars_result toChars(char* first, char* last,
+    const details::ScalarUnit<Rep, Adapter>& item,
+    Precision precision = Precision::Picos) noexcept {
+  using namespace details;
+  return writeChecked<MaxDecimalChars>(first, last, [&](char* out) {
+    return writeDecimal(out, item.value(), fractionDigits(precision));
+  });
+}
+
+template<typename Scalar>
+constexpr std::to_chars_result toChars(char* first, char* last,
+    const Duration<Scalar>& item,
+    Precision precision = Precision::Picos) noexcept {
+  using namespace details;
+  return writeChecked<MaxDecimalChars>(first, last, [&](char* out) {
+    return writeDecimal(out, item.value(), fractionDigits(precision));
+  });
+}
+
+template<typename Scalar>
+constexpr std::to_chars_result toChars(char* first, char* last,
+    const Moment<Scalar>& item,
+    Precision precision = Precision::Picos) noexcept {
+  using namespace details;
+  return writeChecked<MaxIsoChars>(first, last, [&](char* out) {
+    return writeIso(out, item.value(), fractionDigits(precision));
+  });
+}
+
+// Formats moments as toChars does, but remembers the date and time of day of
+// the last whole second it wrote, so that moments in the same second as the
+// one before, which is most of them when logging at high rates, only need
+// their fractions written. It's meant to be kept per thread, such as by a log
+// writer, since it isn't safe to share.
+class IsoFormatter {
+public:
+  // The longest date and time of day, which the cache is padded out to, so
+  // that it's copied with a single fixed-size move.
+  static constexpr const std::size_t MaxPrefixChars = 32;
+
+  template<typename Scalar>
+  std::to_chars_result toChars(char* first, char* last,
+      const Moment<Scalar>& item,
+      Precision precision = Precision::Picos) noexcept {
+    using namespace details;
+    return writeChecked<MaxIsoChars>(first, last, [&](char* out) {
+      return write(out, item.value(), fractionDigits(precision));
+    });
+  }
+
+private:
+  // NaN can't be the floor of any second, so nothing matches at first. The
+  // special values are never cached.
+  UnitSeconds m_seconds = SecondsTraits<>::NaN;
+  std::size_t m_size = 0;
+  char m_prefix[MaxPrefixChars]{};
+
+  char* write(char* out, UnitValue sss, int digits) noexcept {
+    using namespace details;
+    if (char* end = writeCategory(out, sss.s)) return end;
+    UnitSeconds s = floorSeconds(sss);
+    if (s != m_seconds) {
+      m_seconds = s;
+      m_size = static_cast<std::size_t>(writeIsoPrefix(m_prefix, s) - m_prefix);
+    }
+    // There's always room for MaxIsoChars, so the padding fits, and what's
+    // past the prefix is written over.
+    static_assert(MaxPrefixChars <= MaxIsoChars);
+    std::memcpy(out, m_prefix, MaxPrefixChars);
+    return writeIsoSuffix(out + m_size, sss.ss, digits);
+  }
+};
+
+#ifdef __cpp_lib_format
+namespace details {
+// Formatter for std::format, which takes the precision as "{:.3}" does for
+// floating point, and otherwise formats as toChars does.
+template<typename Unit>
+struct ScalarFormatter {
+  Precision m_precision = Precision::Picos;
+
+  constexpr auto parse(std::format_parse_context& ctx) {
+    auto it = ctx.begin();
+    if (it != ctx.end() && *it == '.') {
+      int digits = 0, count = 0;
+      for (++it; it != ctx.end() && *it >= '0' && *it <= '9'; ++it, ++count)
+        digits = digits * 10 + (*it - '0');
+      if (!count || count > 2 || digits > 12)
+        throw std::format_error("chronos: precision must be from 0 to 12");
+      m_precision = static_cast<Precision>(digits);
+    }
+    if (it != ctx.end() && *it != '}')
+      throw std::format_error("chronos: only a precision may be given");
+    return it;
+  }
+
+  template<typename FormatContext>
+  auto format(const Unit& item, FormatContext& ctx) const {
+    char buffer[MaxIsoChars];
+    auto result = toChars(buffer, buffer + sizeof(buffer), item, m_precision);
+    return std::copy(buffer, result.ptr, ctx.out());
+  }
+};
+} // namespace details
+#endif
+
+} // namespace chronos
+
+#ifdef __cpp_lib_format
+template<typename Rep, template<typename> class Adapter>
+struct std::formatter<chronos::details::ScalarUnit<Rep, Adapter>>
+    : public chronos::details::ScalarFormatter<
+          chronos::details::ScalarUnit<Rep, Adapter>> {};
+
+template<typename Scalar>
+struct std::formatter<chronos::Duration<Scalar>>
+    : public chronos::details::ScalarFormatter<chronos::Duration<Scalar>> {};
+
+template<typename Scalar>
+struct std::formatter<chronos::Moment<Scalar>>
+    : public chronos::details::ScalarFormatter<chronos::Moment<Scalar>> {};
+#endif
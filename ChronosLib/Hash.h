@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include "Moment.h"
+
+namespace chronos {
+// Hashes of moments and durations, for unordered containers.
+//
+// The hash is of the canonical value, so values that are equal hash equally,
+// whatever their representation, and all NaNs hash alike, even though they
+// never compare equal. Values that are close together, or evenly spaced,
+// which is what timestamps usually are, spread across all the bits, so the
+// low bits alone make a good bucket index for tables with a power-of-two size.
+
+namespace details {
+// Constants with no obvious pattern, from the fractional parts of the golden
+// ratio and the square root of three. The picoseconds seed is larger than any
+// picoseconds value, of either sign, so its factor is never zero.
+constexpr const uint64_t HashSecondsSeed = 0x9E37'79B9'7F4A'7C15;
+constexpr const uint64_t HashPicosSeed = 0xBB67'AE85'84CA'A73B;
+} // namespace details
+
+// Gets the hash of a canonical value. The seeded fields are multiplied wide
+// and the halves of the product folded together, so that every bit of each
+// field reaches every bit of the hash.
+constexpr std::size_t hashValue(const UnitValue& sss) noexcept {
+  using namespace details;
+  WidePair p = wideMul(static_cast<uint64_t>(sss.s) ^ HashSecondsSeed,
+      static_cast<uint64_t>(sss.ss) ^ HashPicosSeed);
+  return static_cast<std::size_t>(p.hi ^ p.lo);
+}
+
+// Hash for any scalar unit, moment, or duration. It's transparent, so with
+// std::equal_to<> as the key equality, an unordered container keyed by one
+// representation can be searched with another without converting:
+//
+//   std::unordered_set<Moment<>, ScalarHash, std::equal_to<>> seen;
+//   seen.contains(Moment<details::ScalarUnit<details::Unix32Rep>>(...));
+struct ScalarHash {
+  using is_transparent = void;
+
+  template<typename Unit,
+      typename std::enable_if_t<is_scalar_unit_v<Unit>, int> = 0>
+  constexpr std::size_t operator()(const Unit& item) const noexcept {
+    return hashValue(item.value());
+  }
+};
+
+} // namespace chronos
+
+template<typename Rep, template<typename> class Adapter>
+struct std::hash<chronos::details::ScalarUnit<Rep, Adapter>>
+    : public chronos::ScalarHash {};
+
+template<typename Scalar>
+struct std::hash<chronos::Duration<Scalar>> : public chronos::ScalarHash {};
+
+template<typename Scalar>
+struct std::hash<chronos::Moment<Scalar>> : public chronos::ScalarHash {};
@@ -0,0 +1,340 @@
+#pragma once
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <limits>
+#include <ratio>
+#include <type_traits>
+#include "Civil.h"
+#include "Column.h"
+#include "Literals.h"
+#if __has_include(<sys/time.h>)
+#include <sys/time.h>
+#endif
+
+namespace chronos {
+// Conversions to and from std::chrono, timespec, and timeval.
+//
+// A std::chrono duration converts exactly when its period is a whole number
+// of picoseconds, as every standard one is, from hours to picoseconds, and
+// the scaling is fixed when compiling. Periods that divide a second, such as
+// nanoseconds, split into seconds and a fraction by division by a constant,
+// which compiles to multiplies. Going the other way, the count is truncated
+// toward zero, as std::chrono::duration_cast does. Counts too large for the
+// seconds give an infinity of their sign, and values too large for the count
+// saturate at its limits. The special values take the same places in integer
+// counts that they do in SecondsTraits, both ways: the maximum for +Inf, so
+// that duration::max() means forever, its negation for -Inf, and the minimum
+// for NaN. Floating-point counts use their own NaN and infinities.
+//
+// Time points are offsets from their clock's epoch, which is ChronoEpoch.
+// Only system_clock's is known, as the Unix epoch, and any other clock's is
+// taken to be 0001-01-01, as it is for the monotonic clock in Clock.h.
+//
+// A timespec or timeval is a moment from the Unix epoch or a duration, as
+// the template argument says. The seconds are floored and the fraction is
+// truncated toward the past, which keeps the nanoseconds or microseconds
+// from 0 up, as POSIX has them.
+
+template<typename Clock>
+struct ChronoEpoch {
+  static constexpr const UnitSeconds seconds = 0;
+};
+
+template<>
+struct ChronoEpoch<std::chrono::system_clock> {
+  static constexpr const UnitSeconds seconds = UnixEpochSeconds;
+};
+
+namespace details {
+template<typename T>
+struct IsChronoDuration : std::false_type {};
+
+template<typename Rep, typename Period>
+struct IsChronoDuration<std::chrono::duration<Rep, Period>> : std::true_type {
+};
+
+template<typename T>
+struct IsTimePoint : std::false_type {};
+
+template<typename Clock, typename Dur>
+struct IsTimePoint<std::chrono::time_point<Clock, Dur>> : std::true_type {};
+
+template<typename Rep>
+constexpr void checkChronoRep() noexcept {
+  static_assert(std::is_floating_point_v<Rep> ||
+          (std::is_integral_v<Rep> && std::is_signed_v<Rep> &&
+              sizeof(Rep) <= sizeof(int64_t)),
+      "The count must be floating point or a signed integer of 64 bits or "
+      "fewer");
+}
+
+// Ticks per second, when the period divides a second into whole picoseconds,
+// or else zero.
+template<typename Period>
+constexpr uint64_t ticksPerSecond() noexcept {
+  constexpr uint64_t picos = picosPerUnit<Period>();
+  if (picos >= PicosPerSecond || PicosPerSecond % picos) return 0;
+  return PicosPerSecond / picos;
+}
+
+template<typename Rep>
+constexpr Rep chronoSpecial(Category cat) noexcept {
+  using L = std::numeric_limits<Rep>;
+  if constexpr (std::is_floating_point_v<Rep>) {
+    if (cat == Category::NaN) return L::quiet_NaN();
+    return cat == Category::InfP ? L::infinity() : -L::infinity();
+  } else {
+    if (cat == Category::NaN) return L::min();
+    return cat == Category::InfP ? L::max() : -L::max();
+  }
+}
+
+template<typename Rep, typename Period>
+constexpr Duration<> fromChronoCount(Rep count) noexcept {
+  using T = SecondsTraits<>;
+  checkChronoRep<Rep>();
+  constexpr uint64_t picos = picosPerUnit<Period>();
+  if constexpr (std::is_floating_point_v<Rep>) {
+    if (std::isnan(count)) return Duration<>(Category::NaN);
+    auto s = static_cast<double>(count) * static_cast<double>(picos) /
+        static_cast<double>(PicosPerSecond);
+    if (s >= static_cast<double>(T::Max)) return Duration<>(Category::InfP);
+    if (s <= static_cast<double>(T::Min)) return Duration<>(Category::InfN);
+    return Duration<>(s);
+  } else {
+    using L = std::numeric_limits<Rep>;
+    if (count == L::max()) return Duration<>(Category::InfP);
+    if (count == -L::max()) return Duration<>(Category::InfN);
+    if (count == L::min()) return Duration<>(Category::NaN);
+    constexpr uint64_t ticks = ticksPerSecond<Period>();
+    auto c = static_cast<int64_t>(count);
+    if constexpr (ticks > 1) {
+      // With at least 2 ticks a second, the seconds are always in range.
+      constexpr auto Ticks = static_cast<int64_t>(ticks);
+      return Duration<>(UnitValue{
+          c / Ticks, static_cast<UnitPicos>(c % Ticks * int64_t(picos))});
+    } else {
+      return Duration<>(fromCount<Period>(c));
+    }
+  }
+}
+
+template<typename Rep, typename Period>
+constexpr Rep toChronoCount(const UnitValue& sss) noexcept {
+  using L = std::numeric_limits<Rep>;
+  checkChronoRep<Rep>();
+  constexpr uint64_t picos = picosPerUnit<Period>();
+  Category cat = SecondsTraits<>::toCategory(sss.s);
+  if (cat != Category::Num) return chronoSpecial<Rep>(cat);
+  if constexpr (std::is_floating_point_v<Rep>) {
+    return static_cast<Rep>(
+        (static_cast<double>(sss.s) * static_cast<double>(PicosPerSecond) +
+            static_cast<double>(sss.ss)) /
+        static_cast<double>(picos));
+  } else {
+    constexpr uint64_t ticks = ticksPerSecond<Period>();
+    constexpr auto Max = static_cast<uint64_t>(L::max());
+    // Seconds this far from zero can't overflow the count. Past them, the
+    // count is worked out from all the picoseconds.
+    if constexpr (ticks != 0) {
+      constexpr auto Safe = static_cast<UnitSeconds>(Max / ticks) - 1;
+      if (sss.s <= Safe && sss.s >= -Safe)
+        return static_cast<Rep>(sss.s * static_cast<int64_t>(ticks) +
+            sss.ss / static_cast<UnitPicos>(picos));
+    }
+    WidePair rest{};
+    WidePair count = wideDiv(toWidePicos(sss), WidePair{0, picos}, rest);
+    bool neg = sss.s < 0 || sss.ss < 0;
+    if (count.hi || count.lo > Max) return neg ? -L::max() : L::max();
+    auto mag = static_cast<Rep>(count.lo);
+    return neg ? static_cast<Rep>(-mag) : mag;
+  }
+}
+} // namespace details
+
+template<typename Rep, typename Period>
+constexpr Duration<> fromChrono(
+    const std::chrono::duration<Rep, Period>& item) noexcept {
+  return details::fromChronoCount<Rep, Period>(item.count());
+}
+
+template<typename Clock, typename Dur>
+constexpr Moment<> fromChrono(
+    const std::chrono::time_point<Clock, Dur>& item) noexcept {
+  return Moment<>(ChronoEpoch<Clock>::seconds) +
+      fromChrono(item.time_since_epoch());
+}
+
+// Converts to a std::chrono duration or time point, such as
+// toChrono<std::chrono::nanoseconds>(duration).
+template<typename To, typename Scalar,
+    typename std::enable_if_t<details::IsChronoDuration<To>::value, int> = 0>
+constexpr To toChrono(const Duration<Scalar>& item) noexcept {
+  using namespace details;
+  return To(toChronoCount<typename To::rep, typename To::period>(
+      item.value()));
+}
+
+template<typename To, typename Scalar,
+    typename std::enable_if_t<details::IsTimePoint<To>::value, int> = 0>
+constexpr To toChrono(const Moment<Scalar>& item) noexcept {
+  using Epoch = ChronoEpoch<typename To::clock>;
+  return To(toChrono<typename To::duration>(
+      Moment<>(item) - Moment<>(Epoch::seconds)));
+}
+
+namespace details {
+// Gets the value of POSIX seconds and a fraction of them, from an epoch.
+// It's NaN if the fraction is out of range, as POSIX calls it invalid.
+constexpr UnitValue fromPosixParts(int64_t s, int64_t fraction,
+    int64_t perSecond, UnitSeconds epoch) noexcept {
+  if (fraction < 0 || fraction >= perSecond)
+    return UnitValue{SecondsTraits<>::NaN, 0};
+  return shiftFloored(s, fraction * (PicosPerSecond / perSecond), epoch);
+}
+
+// Splits a value into POSIX seconds from an epoch and a fraction, saturating
+// at the limits of the seconds, or returns false if it's NaN.
+template<typename Seconds>
+constexpr bool toPosixParts(UnitValue sss, int64_t perSecond,
+    UnitSeconds epoch, Seconds& s, int64_t& fraction) noexcept {
+  using L = std::numeric_limits<Seconds>;
+  Category cat = SecondsTraits<>::toCategory(sss.s);
+  if (cat == Category::NaN) return false;
+  UnitSeconds floor = cat == Category::Num ? floorSeconds(sss) : 0;
+  // Moments near the start of time are further from the epoch than int64_t
+  // reaches, so the limits are checked before subtracting. Epochs are never
+  // negative, so neither check can overflow.
+  if (cat == Category::InfP ||
+      (floor > epoch && floor - epoch > static_cast<int64_t>(L::max()))) {
+    s = L::max(), fraction = perSecond - 1;
+  } else if (cat == Category::InfN ||
+      floor < static_cast<int64_t>(L::min()) + epoch) {
+    s = L::min(), fraction = 0;
+  } else {
+    s = static_cast<Seconds>(floor - epoch);
+    fraction = sss.ss / (PicosPerSecond / perSecond);
+  }
+  return true;
+}
+
+// The epoch of POSIX times, for moments, or none, for durations.
+template<typename Unit>
+struct PosixEpoch;
+
+template<typename Scalar>
+struct PosixEpoch<Moment<Scalar>> {
+  static constexpr const UnitSeconds seconds = UnixEpochSeconds;
+};
+
+template<typename Scalar>
+struct PosixEpoch<Duration<Scalar>> {
+  static constexpr const UnitSeconds seconds = 0;
+};
+} // namespace details
+
+// Converts from a timespec, as a moment from the Unix epoch by default, or
+// as a duration.
+template<typename Unit = Moment<>>
+constexpr Unit fromTimespec(const timespec& ts) noexcept {
+  using namespace details;
+  return Unit(fromPosixParts(static_cast<int64_t>(ts.tv_sec),
+      static_cast<int64_t>(ts.tv_nsec), NanosPerSecond,
+      PosixEpoch<Unit>::seconds));
+}
+
+// Converts to a timespec, or returns false if it's NaN. Infinities and values
+// out of range saturate.
+template<typename Unit>
+constexpr bool toTimespec(const Unit& item, timespec& out) noexcept {
+  using namespace details;
+  int64_t nanos = 0;
+  if (!toPosixParts(item.value(), NanosPerSecond,
+          PosixEpoch<Unit>::seconds, out.tv_sec, nanos))
+    return false;
+  out.tv_nsec = static_cast<decltype(out.tv_nsec)>(nanos);
+  return true;
+}
+
+#if __has_include(<sys/time.h>)
+template<typename Unit = Moment<>>
+constexpr Unit fromTimeval(const timeval& tv) noexcept {
+  using namespace details;
+  return Unit(fromPosixParts(static_cast<int64_t>(tv.tv_sec),
+      static_cast<int64_t>(tv.tv_usec), MicrosPerSecond,
+      PosixEpoch<Unit>::seconds));
+}
+
+template<typename Unit>
+constexpr bool toTimeval(const Unit& item, timeval& out) noexcept {
+  using namespace details;
+  int64_t micros = 0;
+  if (!toPosixParts(item.value(), MicrosPerSecond,
+          PosixEpoch<Unit>::seconds, out.tv_sec, micros))
+    return false;
+  out.tv_usec = static_cast<decltype(out.tv_usec)>(micros);
+  return true;
+}
+#endif
+
+namespace details {
+// Bulk conversions test blocks of this many timespecs at a time. A block
+// whose seconds are all from 1970 to well past any present time, with
+// nanoseconds in range, is converted with no checks, which the compiler
+// vectorizes.
+constexpr const std::size_t TimespecBlock = 16;
+constexpr const uint64_t TimespecFastSeconds = uint64_t{1} << 40;
+} // namespace details
+
+// Converts n timespecs, such as the receive timestamps that recvmmsg gives
+// for a batch of messages, to moments from the Unix epoch, in the seconds and
+// picoseconds of a MomentColumn.
+inline void fromTimespecs(const timespec* in, UnitSeconds* s, UnitPicos* ss,
+    std::size_t n) noexcept {
+  using namespace details;
+  std::size_t i = 0;
+  for (; i + TimespecBlock <= n; i += TimespecBlock) {
+    bool fast = true;
+    for (std::size_t j = i; j < i + TimespecBlock; ++j)
+      fast &= (static_cast<uint64_t>(in[j].tv_sec) < TimespecFastSeconds) &
+          (static_cast<uint64_t>(in[j].tv_nsec) <
+              static_cast<uint64_t>(NanosPerSecond));
+    if (fast) {
+      for (std::size_t j = i; j < i + TimespecBlock; ++j) {
+        s[j] = UnixEpochSeconds + static_cast<UnitSeconds>(in[j].tv_sec);
+        ss[j] = static_cast<UnitPicos>(in[j].tv_nsec) * 1'000;
+      }
+      continue;
+    }
+    for (std::size_t j = i; j < i + TimespecBlock; ++j) {
+      UnitValue sss = fromTimespec(in[j]).value();
+      s[j] = sss.s, ss[j] = sss.ss;
+    }
+  }
+  for (; i < n; ++i) {
+    UnitValue sss = fromTimespec(in[i]).value();
+    s[i] = sss.s, ss[i] = sss.ss;
+  }
+}
+
+// The same, replacing the contents of a column.
+inline void fromTimespecs(
+    const timespec* in, std::size_t n, MomentColumn& out) {
+  out.resize(n);
+  fromTimespecs(in, out.seconds(), out.subseconds(), n);
+}
+
+// Converts n moments of a column to timespecs from the Unix epoch, as
+// toTimespec does, with NaN as the zero timespec.
+inline void toTimespecs(const UnitSeconds* s, const UnitPicos* ss,
+    timespec* out, std::size_t n) noexcept {
+  for (std::size_t i = 0; i < n; ++i) {
+    if (!toTimespec(Moment<>(UnitValue{s[i], ss[i]}), out[i]))
+      out[i] = timespec{};
+  }
+}
+
+} // namespace chronos
@@ -0,0 +1,260 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "Moment.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
+namespace chronos {
+// Binary keys for moments and durations whose byte order, as memcmp sees it,
+// is the order of the values, so that sorted stores, such as LSM trees, can
+// range-scan them without decoding. Values that are equal have identical
+// keys. NaN comes after everything else, as it does for <=>, and all NaNs
+// have the same key.
+//
+// There are two forms. The fixed form is the order key (see toOrderKey),
+// big-endian, in KeySize bytes. The compact form takes from one byte, for the
+// special values, to MaxCompactKeySize bytes. It's 12 bytes for moments from
+// this era to the picosecond and 7 for whole seconds. Neither form can be
+// mistaken for a prefix of a longer key of the same form, so either can lead
+// a composite key.
+
+constexpr const std::size_t KeySize = 16;
+constexpr const std::size_t MaxCompactKeySize = 15;
+
+namespace details {
+inline uint64_t byteSwap(uint64_t value) noexcept {
+#ifdef _MSC_VER
+  return _byteswap_uint64(value);
+#else
+  return __builtin_bswap64(value);
+#endif
+}
+
+// Big-endian byte access. See useByteLoops for when the loops run.
+constexpr void storeBigEndian(uint64_t value, uint8_t* out) noexcept {
+  if (useByteLoops()) {
+    for (int i = 0; i < 8; ++i)
+      out[i] = static_cast<uint8_t>(value >> (56 - 8 * i));
+    return;
+  }
+  value = byteSwap(value);
+  std::memcpy(out, &value, sizeof(value));
+}
+
+constexpr uint64_t loadBigEndian(const uint8_t* in) noexcept {
+  uint64_t value = 0;
+  if (useByteLoops()) {
+    for (int i = 0; i < 8; ++i) value = value << 8 | in[i];
+    return value;
+  }
+  std::memcpy(&value, in, sizeof(value));
+  return byteSwap(value);
+}
+
+// Whether the value is one the default scalar could hold, so that decoding
+// arbitrary bytes can't produce a value that breaks the invariants.
+constexpr bool isCanonical(const UnitValue& sss) noexcept {
+  using T = SecondsTraits<>;
+  if (T::toCategory(sss.s) != Category::Num) return sss.ss == 0;
+  if (sss.ss <= -PicosPerSecond || sss.ss >= PicosPerSecond) return false;
+  return sss.s > 0 ? sss.ss >= 0 : sss.s == 0 || sss.ss <= 0;
+}
+
+// The compact form starts with a tag. The special values are nothing but
+// their tags, at either end of the range. Otherwise, the tag gives the sign
+// and the length of the seconds, floored so that the picoseconds are never
+// negative, which follow in as few big-endian bytes as two's complement
+// allows. Longer negative seconds are further below zero and longer positive
+// ones further above, so the tags order them.
+//
+// The picoseconds come last, seven bits to a byte from the top, so that
+// trailing zero bits cost nothing. The low bit of each byte is set if more
+// follow, which orders a shorter run before a longer one that it's a prefix
+// of, just as the zero bits it leaves out would.
+constexpr const uint8_t CompactTagInfN = 0x00;
+constexpr const uint8_t CompactTagZero = 0x80;
+constexpr const uint8_t CompactTagInfP = 0xFE;
+constexpr const uint8_t CompactTagNaN = 0xFF;
+// Picoseconds fit in 40 bits, which are left-aligned in six groups of seven.
+constexpr const int CompactPicosShift = 2;
+constexpr const int CompactGroups = 6;
+constexpr const int CompactTopGroupShift = 35;
+// The low bit of each of the top six bytes of a word.
+constexpr const uint64_t CompactMoreBits = 0x0101'0101'0101'0000;
+// The seven bits above them.
+constexpr const uint64_t CompactGroupBits = 0xFEFE'FEFE'FEFE'0000;
+
+// Moves the six groups between the low 42 bits of a word and the top seven
+// bits of each of its top six bytes. BMI2 does each in one instruction.
+constexpr uint64_t depositCompactGroups(uint64_t rest) noexcept {
+#ifdef __BMI2__
+  if (!std::is_constant_evaluated()) return _pdep_u64(rest, CompactGroupBits);
+#endif
+  uint64_t word = 0;
+  for (int g = 0; g < CompactGroups; ++g)
+    word |= (rest >> (CompactTopGroupShift - 7 * g) & 0x7F) << (57 - 8 * g);
+  return word;
+}
+
+constexpr uint64_t extractCompactGroups(uint64_t word) noexcept {
+#ifdef __BMI2__
+  if (!std::is_constant_evaluated()) return _pext_u64(word, CompactGroupBits);
+#endif
+  uint64_t rest = 0;
+  for (int g = 0; g < CompactGroups; ++g)
+    rest |= (word >> (57 - 8 * g) & 0x7F) << (CompactTopGroupShift - 7 * g);
+  return rest;
+}
+
+// Spreads the picoseconds into their groups, as the top six bytes of a word,
+// and sets count to how many of those bytes are needed.
+constexpr uint64_t spreadCompactPicos(uint64_t picos, int& count) noexcept {
+  uint64_t rest = picos << CompactPicosShift;
+  count = rest ? CompactGroups - std::countr_zero(rest) / 7 : 1;
+  uint64_t more = CompactMoreBits & ~(~uint64_t(0) >> (8 * (count - 1)));
+  return depositCompactGroups(rest) | more;
+}
+
+// Gathers the picoseconds from the top six bytes of a word, setting count to
+// how many of those bytes they took. Returns false if the bytes aren't the
+// picoseconds of a key.
+constexpr bool gatherCompactPicos(
+    uint64_t word, int& count, UnitPicos& picos) noexcept {
+  uint64_t ends = ~word & CompactMoreBits;
+  if (!ends) return false;
+  count = std::countl_zero(ends) / 8 + 1;
+  word &= ~(~uint64_t(0) >> (8 * count));
+  uint64_t rest = extractCompactGroups(word);
+  // Only zero itself ends in a zero group.
+  if (count > 1 && !(word >> (57 - 8 * (count - 1)) & 0x7F)) return false;
+  if (rest & ((uint64_t(1) << CompactPicosShift) - 1)) return false;
+  picos = static_cast<UnitPicos>(rest >> CompactPicosShift);
+  return picos < PicosPerSecond;
+}
+} // namespace details
+
+// Gets the fixed form of the key.
+template<typename Unit>
+constexpr std::array<uint8_t, KeySize> encodeKey(const Unit& item) noexcept {
+  WidePair key = toOrderKey(item.value());
+  std::array<uint8_t, KeySize> out{};
+  details::storeBigEndian(key.hi, out.data());
+  details::storeBigEndian(key.lo, out.data() + 8);
+  return out;
+}
+
+// Reads the fixed form of the key from KeySize bytes. Returns false, leaving
+// out alone, if they aren't a key.
+template<typename Unit>
+constexpr bool decodeKey(const uint8_t* in, Unit& out) noexcept {
+  UnitValue sss = fromOrderKey(WidePair{
+      details::loadBigEndian(in), details::loadBigEndian(in + 8)});
+  if (!details::isCanonical(sss)) return false;
+  out = Unit(sss);
+  return true;
+}
+
+// Writes the compact form of the key, returning its length. There must be
+// room for MaxCompactKeySize bytes.
+template<typename Unit>
+constexpr std::size_t encodeCompactKey(
+    const Unit& item, uint8_t* out) noexcept {
+  using namespace details;
+  UnitValue sss = item.value();
+  switch (SecondsTraits<>::toCategory(sss.s)) {
+  case Category::NaN: *out = CompactTagNaN; return 1;
+  case Category::InfP: *out = CompactTagInfP; return 1;
+  case Category::InfN: *out = CompactTagInfN; return 1;
+  default: break;
+  }
+  UnitSeconds s = sss.s;
+  auto picos = static_cast<uint64_t>(sss.ss);
+  if (sss.ss < 0) --s, picos += PicosPerSecond;
+
+  // All eight bytes of the seconds are written, shifted up, and then all
+  // but the first len of them are written over.
+  auto bits = static_cast<uint64_t>(s);
+  int len = static_cast<int>(std::bit_width(s < 0 ? ~bits : bits) + 7) / 8;
+  if (s < 0) len = std::max(len, 1);
+  out[0] = static_cast<uint8_t>(
+      s < 0 ? CompactTagZero - len : CompactTagZero + len);
+  storeBigEndian(len ? bits << (64 - 8 * len) : 0, out + 1);
+
+  int count = 0;
+  uint8_t groups[8]{};
+  storeBigEndian(spreadCompactPicos(picos, count), groups);
+  std::copy_n(groups, CompactGroups, out + 1 + len);
+  return static_cast<std::size_t>(1 + len + count);
+}
+
+// Reads the compact form of the key from the start of size bytes, returning
+// its length. Returns zero, leaving out alone, if they don't start with a key.
+template<typename Unit>
+constexpr std::size_t decodeCompactKey(
+    const uint8_t* in, std::size_t size, Unit& out) noexcept {
+  using namespace details;
+  using T = SecondsTraits<>;
+  if (!size) return 0;
+  switch (in[0]) {
+  case CompactTagNaN: out = Unit(UnitValue{T::NaN, 0}); return 1;
+  case CompactTagInfP: out = Unit(UnitValue{T::InfP, 0}); return 1;
+  case CompactTagInfN: out = Unit(UnitValue{T::InfN, 0}); return 1;
+  default: break;
+  }
+  int len = in[0] - CompactTagZero;
+  bool negative = len < 0;
+  if (negative) len = -len;
+  if (len > 8 || size <= static_cast<std::size_t>(len) + 1) return 0;
+  const uint8_t* p = in + 1;
+  // The seconds must be as short as they can be, for keys to be unique. A
+  // single byte is enough for anything from -256 to 255.
+  if (negative ? len > 1 && p[0] == 0xFF : len && !p[0]) return 0;
+  uint64_t bits = negative ? ~uint64_t(0) : 0;
+  if (len == 8) {
+    bits = loadBigEndian(p);
+  } else if (len && size > 8) {
+    bits = bits << (8 * len) | loadBigEndian(p) >> (64 - 8 * len);
+  } else {
+    for (int i = 0; i < len; ++i) bits = bits << 8 | p[i];
+  }
+  auto s = static_cast<UnitSeconds>(bits);
+  p += len;
+
+  // What follows, up to the most the picoseconds could take, is read as a
+  // word, with zeros past the end. When the key ends the bytes, which is
+  // usual, the word is read from two bytes back, to keep to a single load.
+  auto left = static_cast<std::size_t>(in + size - p);
+  uint64_t word = 0;
+  if (left >= 8) {
+    word = loadBigEndian(p) & ~uint64_t(0xFFFF);
+  } else if (left >= CompactGroups && len) {
+    word = loadBigEndian(p - 2) << 16;
+  } else {
+    uint8_t groups[8]{};
+    std::copy_n(p, std::min<std::size_t>(left, CompactGroups), groups);
+    word = loadBigEndian(groups);
+  }
+  int count = 0;
+  UnitPicos picos = 0;
+  if (!gatherCompactPicos(word, count, picos)) return 0;
+  if (static_cast<std::size_t>(count) > left) return 0;
+  p += count;
+
+  if (s < 0 && picos) ++s, picos -= PicosPerSecond;
+  if (s < T::Min || s > T::Max) return 0;
+  out = Unit(UnitValue{s, picos});
+  return static_cast<std::size_t>(p - in);
+}
+
+} // namespace chronos
@@ -0,0 +1,347 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include "Civil.h"
+#include "Column.h"
+
+namespace chronos {
+// Leap seconds, and conversions between the time scales that they separate.
+//
+// Moments are defined in TAI, which has no leap seconds, but civil times, here
+// as in POSIX, have days of exactly 86,400 seconds. UTC is kept near the
+// rotation of the Earth by inserting a leap second, as 23:59:60, at the end of
+// a month, or in principle removing one, so it's TAI less a whole number of
+// seconds that changes at each leap. A POSIX moment is a count of civil
+// seconds, such as fromCivil gives and Format writes, in which the leap second
+// has no number of its own. UTC is the civil time itself, which can read
+// 23:59:60.
+//
+// The table has the offset, TAI - UTC, from each leap on, as the IERS gives it
+// in leap-seconds.list, a copy of which is compiled in. Before the first leap,
+// in 1972, the offset is taken to be the first one, 10 s, as std::chrono's
+// tai_clock does, although UTC then had rubber seconds. After the last, the
+// offset is taken to hold, which it does at least until the list expires.
+//
+// Nearly every moment of interest is past the last leap, which is checked
+// first, so converting one is a comparison and an addition. Any others are
+// found by binary search of the table, which is at most 64 entries.
+
+// Errors from reading leap second lists. None of them leave the table changed.
+enum class LeapError {
+  None,
+  File, // The file couldn't be read.
+  Format, // A line isn't a time and an offset, or a comment.
+  Order, // The times don't increase, or an offset doesn't step by a second.
+  Size, // There are no leaps, or more than the table holds.
+};
+
+namespace details {
+inline constexpr auto LeapErrorNames = make_array("None"sv, "File"sv,
+    "Format"sv, "Order"sv, "Size"sv);
+} // namespace details
+
+constexpr const auto& asString(const LeapError& error) {
+  return details::LeapErrorNames[static_cast<int>(error)];
+}
+
+namespace details {
+// A leap, at which the offset changes, by its POSIX and TAI seconds.
+struct LeapEntry {
+  UnitSeconds posix;
+  UnitSeconds tai;
+  int32_t offset;
+
+  bool operator==(const LeapEntry&) const = default;
+};
+
+// The compiled-in table, from leap-seconds.list, as extended by Bulletin C 72
+// of July 2026, which announced no leap at the end of 2026. Every leap so far
+// has been at the start of January or July.
+struct LeapDate {
+  int year;
+  int month;
+  int32_t offset;
+};
+
+constexpr const LeapDate BuiltinLeaps[] = {{1972, 1, 10}, {1972, 7, 11},
+    {1973, 1, 12}, {1974, 1, 13}, {1975, 1, 14}, {1976, 1, 15}, {1977, 1, 16},
+    {1978, 1, 17}, {1979, 1, 18}, {1980, 1, 19}, {1981, 7, 20}, {1982, 7, 21},
+    {1983, 7, 22}, {1985, 7, 23}, {1988, 1, 24}, {1990, 1, 25}, {1991, 1, 26},
+    {1992, 7, 27}, {1993, 7, 28}, {1994, 7, 29}, {1996, 1, 30}, {1997, 7, 31},
+    {1999, 1, 32}, {2006, 1, 33}, {2009, 1, 34}, {2012, 7, 35}, {2015, 7, 36},
+    {2017, 1, 37}};
+constexpr const CivilDate BuiltinLeapsExpire{2027, 6, 28};
+
+// The list counts seconds from 1900-01-01, as NTP does. Its times are kept
+// within this, which is well past any that it will ever have.
+constexpr const UnitSeconds NtpEpochSeconds =
+    daysFromCivil(1900, 1, 1) * SecondsPerDay;
+constexpr const int64_t MaxNtpSeconds = int64_t{1} << 40;
+
+// Reads a count, after any blanks, from the front of the text.
+inline bool readLeapNumber(std::string_view& text, int64_t& out) noexcept {
+  std::size_t start = text.find_first_not_of(" \t\r");
+  if (start == std::string_view::npos) return false;
+  text.remove_prefix(start);
+  bool negative = !text.empty() && text.front() == '-';
+  if (negative) text.remove_prefix(1);
+  std::size_t count = 0;
+  uint64_t value = 0;
+  for (; count < text.size() && text[count] >= '0' && text[count] <= '9';
+      ++count) {
+    if (value > static_cast<uint64_t>(MaxNtpSeconds)) return false;
+    value = value * 10 + static_cast<uint64_t>(text[count] - '0');
+  }
+  if (!count || value > static_cast<uint64_t>(MaxNtpSeconds)) return false;
+  text.remove_prefix(count);
+  out = negative ? -static_cast<int64_t>(value) : static_cast<int64_t>(value);
+  return true;
+}
+
+// Bulk conversions test blocks of this many moments at a time.
+constexpr const std::size_t LeapBatchBlock = 16;
+} // namespace details
+
+class LeapSeconds {
+public:
+  static constexpr const std::size_t Capacity = 64;
+
+  // The compiled-in table.
+  constexpr LeapSeconds() noexcept {
+    using namespace details;
+    for (const LeapDate& leap : BuiltinLeaps)
+      add(daysFromCivil(leap.year, leap.month, 1) * SecondsPerDay,
+          leap.offset);
+    m_expires = daysFromCivil(BuiltinLeapsExpire.year,
+        BuiltinLeapsExpire.month, BuiltinLeapsExpire.day) * SecondsPerDay;
+  }
+
+  // Reads the text of a leap-seconds.list, which has a line for each leap,
+  // with its NTP seconds and the offset from then on, and the expiration in
+  // a "#@" line. Other comments are skipped. If there's no expiration, the
+  // list is taken to expire at its last leap.
+  LeapError readList(std::string_view text) noexcept {
+    using namespace details;
+    LeapSeconds table = *this;
+    table.m_entries = {};
+    table.m_size = 0;
+    bool expires = false;
+    while (!text.empty()) {
+      std::size_t end = text.find('\n');
+      std::string_view line = text.substr(0, end);
+      text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+      int64_t at = 0, offset = 0;
+      if (line.starts_with("#@")) {
+        line.remove_prefix(2);
+        if (!readLeapNumber(line, at) || at < 0) return LeapError::Format;
+        table.m_expires = at + NtpEpochSeconds;
+        expires = true;
+        continue;
+      }
+      line = line.substr(0, line.find('#'));
+      if (line.find_first_not_of(" \t\r") == std::string_view::npos) continue;
+      if (!readLeapNumber(line, at) || !readLeapNumber(line, offset) ||
+          line.find_first_not_of(" \t\r") != std::string_view::npos ||
+          at < 0 || offset < -MaxLeapOffset || offset > MaxLeapOffset)
+        return LeapError::Format;
+      if (table.m_size == Capacity) return LeapError::Size;
+      UnitSeconds posix = at + NtpEpochSeconds;
+      if (table.m_size) {
+        const LeapEntry& last = table.m_entries[table.m_size - 1];
+        if (posix <= last.posix || posix + offset <= last.tai ||
+            (offset - last.offset != 1 && offset - last.offset != -1))
+          return LeapError::Order;
+      }
+      table.add(posix, static_cast<int32_t>(offset));
+    }
+    if (!table.m_size) return LeapError::Size;
+    if (!expires) table.m_expires = table.m_entries[table.m_size - 1].posix;
+    *this = table;
+    return LeapError::None;
+  }
+
+  LeapError loadList(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return LeapError::File;
+    std::string text((std::istreambuf_iterator<char>(file)),
+        std::istreambuf_iterator<char>());
+    if (file.bad()) return LeapError::File;
+    return readList(text);
+  }
+
+  // Entries in the table, the first of which also has the offset before it.
+  constexpr std::size_t size() const noexcept { return m_size; }
+
+  // When the list stops vouching that there's no leap it doesn't have, as a
+  // POSIX moment.
+  constexpr Moment<> expires() const noexcept { return Moment<>(m_expires); }
+
+  // Gets TAI - UTC, in seconds, at floored POSIX seconds.
+  constexpr int32_t offset(UnitSeconds posix) const noexcept {
+    return m_entries[find(posix, &details::LeapEntry::posix)].offset;
+  }
+
+  template<typename Scalar>
+  constexpr Moment<Scalar> toTai(const Moment<Scalar>& posix) const noexcept {
+    using namespace details;
+    UnitValue sss = posix.value();
+    if (SecondsTraits<>::toCategory(sss.s) != Category::Num) return posix;
+    UnitSeconds floor = floorSeconds(sss);
+    return Moment<Scalar>(shiftFloored(floor, sss.ss, offset(floor)));
+  }
+
+  // Gets the POSIX moment of a TAI one. A moment in an inserted leap second
+  // has none of its own, so it gets 23:59:59 again, with its fraction, as
+  // the system clock reads during one.
+  template<typename Scalar>
+  constexpr Moment<Scalar> toPosix(const Moment<Scalar>& tai) const noexcept {
+    using namespace details;
+    UnitValue sss = tai.value();
+    if (SecondsTraits<>::toCategory(sss.s) != Category::Num) return tai;
+    UnitSeconds floor = floorSeconds(sss);
+    bool leap = false;
+    return Moment<Scalar>(shiftFloored(floor, sss.ss, fromTai(floor, leap)));
+  }
+
+  // Gets the UTC date and time of a TAI moment, which reads 23:59:60 during
+  // an inserted leap second, or returns false if it's a special value.
+  template<typename Scalar>
+  constexpr bool toUtc(const Moment<Scalar>& tai, CivilTime& out)
+      const noexcept {
+    using namespace details;
+    UnitValue sss = tai.value();
+    if (SecondsTraits<>::toCategory(sss.s) != Category::Num) return false;
+    UnitSeconds floor = floorSeconds(sss);
+    bool leap = false;
+    int32_t shift = fromTai(floor, leap);
+    if (!toCivil(Moment<Scalar>(shiftFloored(floor, sss.ss, shift)), out))
+      return false;
+    out.second += leap;
+    return true;
+  }
+
+  // Gets the TAI moment of a UTC date and time, as fromCivil does, except
+  // that a second of 60 is allowed where a leap second was inserted.
+  template<typename Scalar = details::DefaultScalarUnit>
+  constexpr Moment<Scalar> fromUtc(const CivilTime& t) const noexcept {
+    using namespace details;
+    CivilTime held = t;
+    bool leap = t.second == 60;
+    held.second -= leap;
+    Moment<Scalar> posix = fromCivil<Scalar>(held);
+    if (!leap) return toTai(posix);
+    UnitValue sss = posix.value();
+    if (SecondsTraits<>::toCategory(sss.s) != Category::Num) return posix;
+    UnitSeconds floor = floorSeconds(sss);
+    std::size_t i = find(floor + 1, &LeapEntry::posix);
+    if (!i || m_entries[i].posix != floor + 1 ||
+        m_entries[i].offset <= m_entries[i - 1].offset)
+      return Moment<Scalar>(Category::NaN);
+    return Moment<Scalar>(shiftFloored(floor, sss.ss, m_entries[i].offset));
+  }
+
+  // Converts every moment of a column, in place, as the forms above do.
+  void toTai(MomentColumn& column) const noexcept {
+    const details::LeapEntry& last = m_entries[m_size - 1];
+    shiftColumn(column, last.posix, last.offset,
+        [this](UnitSeconds floor) { return offset(floor); });
+  }
+
+  void toPosix(MomentColumn& column) const noexcept {
+    const details::LeapEntry& last = m_entries[m_size - 1];
+    shiftColumn(column, last.tai, -last.offset, [this](UnitSeconds floor) {
+      bool leap = false;
+      return fromTai(floor, leap);
+    });
+  }
+
+  bool operator==(const LeapSeconds&) const = default;
+
+private:
+  // Offsets are far smaller than this, which keeps the TAI times in range.
+  static constexpr const int64_t MaxLeapOffset = int64_t{1} << 20;
+
+  std::array<details::LeapEntry, Capacity> m_entries{};
+  std::size_t m_size = 0;
+  UnitSeconds m_expires = 0;
+
+  constexpr void add(UnitSeconds posix, int32_t offset) noexcept {
+    m_entries[m_size++] = details::LeapEntry{posix, posix + offset, offset};
+  }
+
+  // Gets the last entry at or before floored seconds, by their POSIX or TAI
+  // times, or the first entry if there's none.
+  constexpr std::size_t find(UnitSeconds s,
+      UnitSeconds details::LeapEntry::*field) const noexcept {
+    std::size_t last = m_size - 1;
+    if (s >= m_entries[last].*field) return last;
+    auto first = m_entries.begin();
+    auto it = std::upper_bound(first, first + last, s,
+        [field](UnitSeconds s, const details::LeapEntry& entry) {
+          return s < entry.*field;
+        });
+    return it == first ? 0 : static_cast<std::size_t>(it - first) - 1;
+  }
+
+  // Gets the shift from floored TAI seconds to POSIX ones. In an inserted
+  // leap second, the old offset would give the first second of the next day,
+  // so it's held back a second.
+  constexpr int32_t fromTai(UnitSeconds tai, bool& leap) const noexcept {
+    std::size_t i = find(tai, &details::LeapEntry::tai);
+    const details::LeapEntry& entry = m_entries[i];
+    if (i + 1 < m_size) {
+      const details::LeapEntry& next = m_entries[i + 1];
+      if (tai >= next.tai - (next.offset - entry.offset)) {
+        leap = true;
+        return static_cast<int32_t>(next.posix - 1 - tai);
+      }
+    }
+    return -entry.offset;
+  }
+
+  // Shifts the moments of a column by whole seconds. A block that's all past
+  // the last leap, which in a column of recent times is every block, has the
+  // same shift throughout, and no special values or results out of range, so
+  // it's a single addition that the compiler vectorizes. Others are shifted
+  // one at a time.
+  template<typename Shift>
+  static void shiftColumn(MomentColumn& column, UnitSeconds from,
+      int32_t lastShift, const Shift& shift) noexcept {
+    using namespace details;
+    using T = SecondsTraits<>;
+    UnitSeconds* s = column.seconds();
+    UnitPicos* ss = column.subseconds();
+    std::size_t n = column.size();
+    // Keeping the seconds positive before and after keeps them canonical,
+    // since the picoseconds are left as they are.
+    UnitSeconds lo = std::max<UnitSeconds>(from, 1 - std::min(lastShift, 0));
+    UnitSeconds hi = T::Max - std::max(lastShift, 0);
+    auto lane = [&](std::size_t i) {
+      if (T::toCategory(s[i]) != Category::Num) return;
+      UnitValue sss{s[i], ss[i]};
+      UnitSeconds floor = floorSeconds(sss);
+      sss = shiftFloored(floor, sss.ss, shift(floor));
+      s[i] = sss.s, ss[i] = sss.ss;
+    };
+    std::size_t i = 0;
+    for (; i + LeapBatchBlock <= n; i += LeapBatchBlock) {
+      bool recent = true;
+      for (std::size_t j = i; j < i + LeapBatchBlock; ++j)
+        recent &= (s[j] >= lo) & (s[j] <= hi);
+      if (recent) {
+        for (std::size_t j = i; j < i + LeapBatchBlock; ++j) s[j] += lastShift;
+        continue;
+      }
+      for (std::size_t j = i; j < i + LeapBatchBlock; ++j) lane(j);
+    }
+    for (; i < n; ++i) lane(i);
+  }
+};
+
+} // namespace chronos
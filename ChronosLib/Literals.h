@@ -0,0 +1,150 @@
+#pragma once
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <ratio>
+#include <type_traits>
+#include "Duration.h"
+
+namespace chronos {
+// Exact durations from counts of units, and literals for them.
+//
+// A count of any period that's a whole number of picoseconds, such as
+// std::milli or std::ratio<3'600>, converts exactly, with nothing rounded.
+// Counts too large for the seconds give an infinity of the same sign, as
+// overflowing arithmetic does, except in a constant expression, where they
+// fail to compile, as literals do.
+
+namespace details {
+// Picoseconds in one unit of the period. The ratio arithmetic fails to
+// compile if this would overflow.
+template<typename Period>
+constexpr uint64_t picosPerUnit() noexcept {
+  using Picos = std::ratio_multiply<Period, std::ratio<PicosPerSecond>>;
+  static_assert(Picos::den == 1 && Picos::num > 0,
+      "The period must be a positive whole number of picoseconds");
+  return static_cast<uint64_t>(Picos::num);
+}
+
+// Gets the value of a magnitude of picoseconds, or an infinity if there are
+// too many seconds.
+constexpr UnitValue fromWidePicos(WidePair picos, bool neg) noexcept {
+  using T = SecondsTraits<>;
+  uint64_t ss = 0;
+  WidePair s = PicosPerSecondDivisor.divu(picos, ss);
+  if (s.hi || s.lo > static_cast<uint64_t>(T::Max))
+    return UnitValue{neg ? T::InfN : T::InfP, 0};
+  auto sS = static_cast<UnitSeconds>(s.lo);
+  auto ssS = static_cast<UnitPicos>(ss);
+  return neg ? UnitValue{-sS, -ssS} : UnitValue{sS, ssS};
+}
+
+// Converts a count of units of the period, saturating, even in a constant
+// expression.
+template<typename Period>
+constexpr UnitValue fromCount(int64_t count) noexcept {
+  bool neg = count < 0;
+  auto mag = neg ? 0 - static_cast<uint64_t>(count)
+                 : static_cast<uint64_t>(count);
+  return fromWidePicos(wideMul(mag, picosPerUnit<Period>()), neg);
+}
+
+// These aren't constexpr, so calling one while evaluating a literal, or any
+// other constant expression, stops the compile, and the error names the
+// problem.
+inline void durationLiteralIsMalformed() noexcept {}
+inline void durationLiteralIsNotExact() noexcept {}
+inline void durationLiteralIsOutOfRange() noexcept {}
+} // namespace details
+
+// Makes a duration of count units of the period, such as
+// durationOf<std::milli>(250) for a quarter of a second.
+template<typename Period = std::ratio<1>>
+constexpr Duration<> durationOf(int64_t count) noexcept {
+  UnitValue sss = details::fromCount<Period>(count);
+  if (std::is_constant_evaluated() &&
+      SecondsTraits<>::toCategory(sss.s) != Category::Num)
+    details::durationLiteralIsOutOfRange();
+  return Duration<>(sss);
+}
+
+namespace details {
+
+// Reads the characters of a literal as decimal digits, with an optional point
+// and digit separators, and converts the count of units they spell out.
+template<typename Period, char... Chars>
+consteval Duration<> durationLiteral() noexcept {
+  constexpr char text[] = {Chars...};
+  uint64_t digits = 0;
+  int places = 0;
+  bool point = false;
+  for (char c : text) {
+    if (c == '\'') continue;
+    if (c == '.' && !point) {
+      point = true;
+      continue;
+    }
+    if (c < '0' || c > '9') durationLiteralIsMalformed();
+    auto digit = static_cast<uint64_t>(c - '0');
+    if (digits > (std::numeric_limits<uint64_t>::max() - digit) / 10)
+      durationLiteralIsOutOfRange();
+    digits = digits * 10 + digit;
+    places += point;
+  }
+  // Zeros at the end of the fraction don't make it any less exact.
+  for (; places && digits % 10 == 0; --places) digits /= 10;
+  if (places >= static_cast<int>(std::size(PowersOfTen)))
+    durationLiteralIsNotExact();
+
+  WidePair rest{};
+  WidePair picos = wideDiv(wideMul(digits, picosPerUnit<Period>()),
+      WidePair{0, PowersOfTen[places]}, rest);
+  if (rest.lo) durationLiteralIsNotExact();
+  UnitValue sss = fromWidePicos(picos, false);
+  if (sss.s == SecondsTraits<>::InfP) durationLiteralIsOutOfRange();
+  return Duration<>(sss);
+}
+} // namespace details
+
+// Duration literals, such as 250_ms, 1.5_s, or 1'000_ps. They're evaluated
+// only at compile time, and it's a compile error for one not to be a whole
+// number of picoseconds or to be too large. Negative durations are negated
+// literals, such as -5_min.
+inline namespace literals {
+template<char... Chars>
+consteval Duration<> operator""_h() noexcept {
+  return details::durationLiteral<std::ratio<3'600>, Chars...>();
+}
+
+template<char... Chars>
+consteval Duration<> operator""_min() noexcept {
+  return details::durationLiteral<std::ratio<60>, Chars...>();
+}
+
+template<char... Chars>
+consteval Duration<> operator""_s() noexcept {
+  return details::durationLiteral<std::ratio<1>, Chars...>();
+}
+
+template<char... Chars>
+consteval Duration<> operator""_ms() noexcept {
+  return details::durationLiteral<std::milli, Chars...>();
+}
+
+template<char... Chars>
+consteval Duration<> operator""_us() noexcept {
+  return details::durationLiteral<std::micro, Chars...>();
+}
+
+template<char... Chars>
+consteval Duration<> operator""_ns() noexcept {
+  return details::durationLiteral<std::nano, Chars...>();
+}
+
+template<char... Chars>
+consteval Duration<> operator""_ps() noexcept {
+  return details::durationLiteral<std::pico, Chars...>();
+}
+} // namespace literals
+
+} // namespace chronos
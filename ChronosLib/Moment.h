@@ -23,37 +23,46 @@ public:
   using Parent::Parent;
   using Parent::operator=;
   using Parent::operator<=>;
+  using Parent::operator==;
   Parent operator-() = delete;
   template<typename U>
   Parent operator*=(const U&) = delete;
+  template<typename U>
+  Parent operator/=(const U&) = delete;
+  template<typename U>
+  Parent operator%=(const U&) = delete;
+  template<typename U, typename V>
+  UnitSeconds divide(const U&, V&) const = delete;
 
+  // The duration is added as it is, rather than converted to a moment, since
+  // a representation that's biased toward an epoch may not hold it.
   template<typename ScalarU>
   constexpr Moment& operator+=(const Duration<ScalarU>& rhs) noexcept {
-    return Parent::operator+=(Moment(rhs.value()));
+    return Parent::add(rhs);
   }
 
   template<typename ScalarU>
   constexpr Moment& operator-=(const Duration<ScalarU>& rhs) noexcept {
-    return Parent::operator-=(Moment(rhs.value()));
+    return Parent::subtract(rhs);
   }
 };
 
 template<typename ScalarT, typename ScalarU>
-constexpr const Moment<> operator+(
+constexpr const Moment<details::CommonScalar<ScalarT, ScalarU>> operator+(
     const Moment<ScalarT>& lhs, const Duration<ScalarU>& rhs) noexcept {
-  return Moment<>(lhs) += rhs;
+  return Moment<details::CommonScalar<ScalarT, ScalarU>>(lhs) += rhs;
 }
 
 template<typename ScalarT, typename ScalarU>
-constexpr const Moment<> operator+(
+constexpr const Moment<details::CommonScalar<ScalarT, ScalarU>> operator+(
     const Duration<ScalarT>& lhs, const Moment<ScalarU>& rhs) noexcept {
   return rhs + lhs;
 }
 
 template<typename ScalarT, typename ScalarU>
-constexpr const Moment<> operator-(
+constexpr const Moment<details::CommonScalar<ScalarT, ScalarU>> operator-(
     const Moment<ScalarT>& lhs, const Duration<ScalarU>& rhs) noexcept {
-  return Moment<>(lhs) -= rhs;
+  return Moment<details::CommonScalar<ScalarT, ScalarU>>(lhs) -= rhs;
 }
 
 template<typename ScalarT, typename ScalarU>
@@ -62,12 +71,12 @@ constexpr const Duration<> operator-(
   return Duration<>(lhs.value()) -= Duration<>(rhs.value());
 }
 
+} // namespace chronos
+
 template<typename Scalar>
 class std::numeric_limits<chronos::Moment<Scalar>>
     : public std::numeric_limits<Scalar> {};
 
-} // namespace chronos
-
 // These two enable structured binding.
 template<std::size_t N, typename Scalar>
 struct std::tuple_element<N, chronos::Moment<Scalar>> {
@@ -0,0 +1,326 @@
+#pragma once
+#include "ScalarUnit.h"
+
+namespace chronos {
+namespace details {
+// Representation of linear time as a signed 64-bit count of nanoseconds since
+// an epoch, which is the form that most external sources produce.
+//
+// The epoch is given in seconds from the de facto one, so that a moment can
+// hold, say, nanoseconds since the Unix epoch just as they arrive. The range is
+// about 292 years in each direction from it, so, for moments, the epoch should
+// be near the times of interest: see UnixNanosRep. Durations are relative, so
+// they should keep the default of zero, as a duration that's biased by an epoch
+// centuries away would saturate.
+//
+// The extremes of the count are reserved for the special values, as defined by
+// SecondsTraits<int64_t>, and, since these sort the same way as the values they
+// stand for, the raw count compares correctly for everything but NaN.
+template<UnitSeconds Epoch = 0>
+class Int64NanosRep {
+public:
+  using CountT = int64_t;
+  using Traits = SecondsTraits<CountT>;
+
+  static constexpr const UnitSeconds EpochSeconds = Epoch;
+  static constexpr const bool rawComparable = true;
+
+  constexpr Int64NanosRep() noexcept : m_nanos(0) {}
+  constexpr explicit Int64NanosRep(CountT nanos) noexcept : m_nanos(nanos) {}
+
+  // Gets the raw count of nanoseconds since the epoch.
+  constexpr CountT count() const noexcept { return m_nanos; }
+
+  // Whether the count is numeric. Biasing by Max maps the numeric range onto
+  // [0, 2 * Max], so this is one unsigned compare.
+  constexpr bool isNumber() const noexcept {
+    return static_cast<uint64_t>(m_nanos) + Traits::Max <=
+        2 * static_cast<uint64_t>(Traits::Max);
+  }
+
+  constexpr auto operator<=>(const Int64NanosRep&) const noexcept = default;
+
+  auto dump(std::ostream& os) const -> decltype(os) {
+    auto flagScope = StreamFlagsGuard(os, std::ios::hex);
+    return os << m_nanos << " <" << sizeof(*this) << ">";
+  }
+
+private:
+  CountT m_nanos;
+};
+
+// Nanoseconds since the Unix epoch, covering 1677 to 2262.
+using UnixNanosRep = Int64NanosRep<UnixEpochSeconds>;
+
+} // namespace details
+
+// Adapter for the 64-bit nanosecond representations.
+//
+// Conversion to seconds and picoseconds is a division by a constant, which the
+// compiler turns into a multiply, and setting rounds to the nearest
+// nanosecond, with ties away from zero, just as CanonRep does.
+//
+// Like RepAdapter<Picos128Rep>, this offers tryAdd, trySub, and compare, so
+// that arithmetic between values that share the representation stays in it.
+// Adding or subtracting a count with no epoch, such as a duration, to or from
+// one with an epoch, such as a moment, also stays in it. Anything else goes
+// through the canonical value, so values only widen when they must.
+template<UnitSeconds Epoch>
+struct RepAdapter<details::Int64NanosRep<Epoch>> {
+  using Traits = SecondsTraits<>;
+  using RepT = details::Int64NanosRep<Epoch>;
+  using RepLimits = std::numeric_limits<RepT>;
+  using WholesT = typename RepT::CountT;
+  using FractionsT = typename RepT::CountT;
+  using CountTraits = typename RepT::Traits;
+
+  static constexpr const UnitPicos PicosPerNano =
+      PicosPerSecond / NanosPerSecond;
+
+  RepT m_rep;
+
+  constexpr RepAdapter() noexcept : m_rep() {}
+  explicit constexpr RepAdapter(const UnitValue& sss) noexcept
+      : m_rep(create(sss.s, sss.ss)) {}
+  explicit constexpr RepAdapter(const RepT& rep) noexcept : m_rep(rep) {}
+  constexpr RepAdapter(UnitSeconds s, UnitPicos ss) noexcept
+      : m_rep(create(s, ss)) {}
+  constexpr RepAdapter(const RepAdapter&) noexcept = default;
+
+  constexpr RepAdapter& operator=(const RepAdapter&) noexcept = default;
+
+  constexpr UnitSeconds seconds() const noexcept { return value().s; }
+  constexpr void seconds(UnitSeconds s) noexcept {
+    m_rep = create(s, subseconds());
+  }
+
+  constexpr UnitPicos subseconds() const noexcept { return value().ss; }
+  constexpr void subseconds(UnitPicos ss) noexcept {
+    m_rep = create(seconds(), ss);
+  }
+
+  constexpr UnitValue value() const noexcept {
+    int64_t n = m_rep.count();
+    if (n > CountTraits::Max) return UnitValue{Traits::InfP, 0};
+    if (n == CountTraits::NaN) return UnitValue{Traits::NaN, 0};
+    if (n < CountTraits::Min) return UnitValue{Traits::InfN, 0};
+    UnitSeconds s = n / NanosPerSecond + Epoch;
+    int64_t ns = n % NanosPerSecond;
+    // Moving to the de facto epoch can leave the signs mismatched.
+    if constexpr (Epoch != 0) {
+      if (s > 0 && ns < 0)
+        --s, ns += NanosPerSecond;
+      else if (s < 0 && ns > 0)
+        ++s, ns -= NanosPerSecond;
+    }
+    return UnitValue{s, ns * PicosPerNano};
+  }
+  constexpr void value(const UnitValue& sss) noexcept {
+    m_rep = create(sss.s, sss.ss);
+  }
+  constexpr void value(UnitSeconds s, UnitPicos ss) noexcept {
+    m_rep = create(s, ss);
+  }
+
+  // Values under a second have no whole seconds, so the fraction's sign
+  // counts too.
+  constexpr bool isNegative() const noexcept {
+    UnitValue v = value();
+    return v.s < 0 || v.ss < 0;
+  }
+
+  constexpr void category(Category cat) noexcept {
+    switch (cat) {
+    case Category::Num: value(0, 0); break;
+    case Category::NaN: m_rep = RepT(CountTraits::NaN); break;
+    case Category::InfN: m_rep = RepT(CountTraits::InfN); break;
+    case Category::InfP: m_rep = RepT(CountTraits::InfP); break;
+    }
+  }
+
+  // Adds rhs, but only when both sides and the result are numbers. Otherwise,
+  // returns false without changing anything, so that the caller can apply the
+  // general rules. When there's an epoch, both counts have had it taken out,
+  // so the sum needs it put back once, which takes more than 64 bits.
+  constexpr bool tryAdd(const RepAdapter& rhs) noexcept {
+    if constexpr (Epoch == 0)
+      return tryCombine(rhs.m_rep.count(), false);
+    else
+      return tryCombineWide(rhs.m_rep.count(), false);
+  }
+
+  // Subtracts rhs, as with tryAdd. Here, the epoch cancels out, so it has to
+  // be taken out again.
+  constexpr bool trySub(const RepAdapter& rhs) noexcept {
+    if constexpr (Epoch == 0)
+      return tryCombine(rhs.m_rep.count(), true);
+    else
+      return tryCombineWide(rhs.m_rep.count(), true);
+  }
+
+  // Adds or subtracts a count with no epoch, as for a moment and a duration.
+  // This needs no adjustment, so it stays within 64 bits.
+  template<UnitSeconds EpochU,
+      typename std::enable_if_t<EpochU == 0 && Epoch != 0, int> = 0>
+  constexpr bool tryAdd(
+      const RepAdapter<details::Int64NanosRep<EpochU>>& rhs) noexcept {
+    return tryCombine(rhs.m_rep.count(), false);
+  }
+
+  template<UnitSeconds EpochU,
+      typename std::enable_if_t<EpochU == 0 && Epoch != 0, int> = 0>
+  constexpr bool trySub(
+      const RepAdapter<details::Int64NanosRep<EpochU>>& rhs) noexcept {
+    return tryCombine(rhs.m_rep.count(), true);
+  }
+
+  // Compares with the same results as ScalarUnit, where NaN on either side
+  // compares as greater.
+  constexpr std::partial_ordering compare(const RepAdapter& rhs) const
+      noexcept {
+    int64_t l = m_rep.count(), r = rhs.m_rep.count();
+    if ((l == CountTraits::NaN) | (r == CountTraits::NaN)) return 1 <=> 0;
+    return ((l > r) - (l < r)) <=> 0;
+  }
+
+  auto dump(std::ostream& os) const -> decltype(os) { return m_rep.dump(os); }
+
+private:
+  // The epoch, in nanoseconds, as a sign-extended wide value.
+  static constexpr WidePair EpochNanos() noexcept {
+    int64_t lo, hi = mul128(Epoch, NanosPerSecond, lo);
+    return WidePair{static_cast<uint64_t>(hi), static_cast<uint64_t>(lo)};
+  }
+
+  static constexpr WidePair widen(int64_t n) noexcept {
+    return WidePair{n < 0 ? ~uint64_t(0) : 0, static_cast<uint64_t>(n)};
+  }
+
+  // Whether a wide count is numeric, by the same bias as RepT::isNumber.
+  static constexpr bool isNumber(WidePair n) noexcept {
+    constexpr WidePair max{0, static_cast<uint64_t>(CountTraits::Max)};
+    return wideAdd(n, max) <= wideAdd(max, max);
+  }
+
+  // Adds or subtracts the count r, with no adjustment for the epoch.
+  constexpr bool tryCombine(int64_t r, bool sub) noexcept {
+    // The sum wraps, and overflowed if its sign differs from both inputs.
+    int64_t l = m_rep.count();
+    auto uR = static_cast<uint64_t>(r);
+    uR = sub ? 0 - uR : uR;
+    auto out = static_cast<int64_t>(static_cast<uint64_t>(l) + uR);
+    bool wrapped = ((l ^ out) & (static_cast<int64_t>(uR) ^ out)) < 0;
+    RepT sum(out);
+    if (wrapped | !m_rep.isNumber() | !RepT(r).isNumber() | !sum.isNumber())
+      return false;
+    m_rep = sum;
+    return true;
+  }
+
+  // Adds or subtracts the count r, when both have had the epoch taken out.
+  constexpr bool tryCombineWide(int64_t r, bool sub) noexcept {
+    int64_t l = m_rep.count();
+    WidePair out = sub ? wideSub(wideSub(widen(l), widen(r)), EpochNanos())
+                       : wideAdd(wideAdd(widen(l), widen(r)), EpochNanos());
+    if (!(m_rep.isNumber() & RepT(r).isNumber() & isNumber(out)))
+      return false;
+    m_rep = RepT(static_cast<int64_t>(out.lo));
+    return true;
+  }
+
+  // Divides, rounding to the nearest, with ties away from zero.
+  static constexpr int64_t divRound(int64_t n, int64_t d) noexcept {
+    int64_t q = n / d, r = n % d;
+    if (2 * (r < 0 ? -r : r) >= d) q += (n < 0) ? -1 : 1;
+    return q;
+  }
+
+  // Creates the count, with the same sign rules as CanonRep.
+  static constexpr RepT create(UnitSeconds s, UnitPicos ss) noexcept {
+    if (s < 0 && ss > 0)
+      ss = -ss;
+    else if (s > 0 && ss < 0)
+      s = Traits::NaN;
+    if (s == Traits::NaN) return RepT(CountTraits::NaN);
+    if (s > Traits::Max) return RepT(CountTraits::InfP);
+    if (s < Traits::Min) return RepT(CountTraits::InfN);
+
+    // Scale to nanoseconds since the epoch in 128 bits, which can't overflow,
+    // then saturate unless it fits.
+    int64_t lo, hi = mul128(s, NanosPerSecond, lo);
+    WidePair n = wideSub(
+        wideAdd(WidePair{static_cast<uint64_t>(hi), static_cast<uint64_t>(lo)},
+            widen(divRound(ss, PicosPerNano))),
+        EpochNanos());
+    if (isNumber(n)) return RepT(static_cast<int64_t>(n.lo));
+    return RepT((static_cast<int64_t>(n.hi) < 0) ? CountTraits::InfN
+                                                 : CountTraits::InfP);
+  }
+};
+
+namespace details {
+using Int64NanosScalarUnit = ScalarUnit<Int64NanosRep<>>;
+using UnixNanosScalarUnit = ScalarUnit<UnixNanosRep>;
+} // namespace details
+} // namespace chronos
+
+template<chronos::UnitSeconds Epoch>
+class std::numeric_limits<chronos::details::Int64NanosRep<Epoch>> {
+public:
+  using RepT = chronos::details::Int64NanosRep<Epoch>;
+  using Traits = typename RepT::Traits;
+
+  [[nodiscard]] static constexpr RepT(min)() noexcept {
+    return RepT(Traits::Min);
+  }
+
+  [[nodiscard]] static constexpr RepT(max)() noexcept {
+    return RepT(Traits::Max);
+  }
+
+  [[nodiscard]] static constexpr RepT lowest() noexcept { return (min)(); }
+
+  [[nodiscard]] static constexpr RepT epsilon() noexcept { return RepT(1); }
+
+  [[nodiscard]] static constexpr RepT round_error() noexcept {
+    return (epsilon)();
+  }
+
+  [[nodiscard]] static constexpr RepT denorm_min() noexcept { return RepT(); }
+
+  [[nodiscard]] static constexpr RepT infinity() noexcept {
+    return RepT(Traits::InfP);
+  }
+
+  [[nodiscard]] static constexpr RepT quiet_NaN() noexcept {
+    return RepT(Traits::NaN);
+  }
+
+  [[nodiscard]] static constexpr RepT signaling_NaN() noexcept {
+    return (quiet_NaN)();
+  }
+
+  static constexpr float_denorm_style has_denorm = denorm_absent;
+  static constexpr bool has_denorm_loss = false;
+  static constexpr bool has_infinity = true;
+  static constexpr bool has_quiet_NaN = true;
+  static constexpr bool has_signaling_NaN = false;
+  static constexpr bool is_bounded = true;
+  static constexpr bool is_exact = true;
+  static constexpr bool is_iec559 = false;
+  static constexpr bool is_integer = false;
+  static constexpr bool is_modulo = false;
+  static constexpr bool is_signed = true;
+  static constexpr bool is_specialized = true;
+  static constexpr bool tinyness_before = false;
+  static constexpr bool traps = false;
+  static constexpr float_round_style round_style = round_to_nearest;
+  static constexpr int digits = 63;
+  static constexpr int digits10 = 18;
+  static constexpr int max_digits10 = 19;
+  static constexpr int max_exponent = 0;
+  static constexpr int max_exponent10 = 0;
+  static constexpr int min_exponent = 0;
+  static constexpr int min_exponent10 = 0;
+  static constexpr int radix = 2;
+};
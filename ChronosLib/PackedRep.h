@@ -0,0 +1,246 @@
+#pragma once
+#include "ScalarUnit.h"
+
+namespace chronos {
+namespace details {
+// Packed representation of linear time, as a 96-bit count of 1/64ths of a
+// nanosecond.
+//
+// This is the storage that CanonRep's notes describe as ideal. At 12 bytes,
+// it's three quarters the size of the default, yet it still covers about 19.6
+// billion years in each direction, at a resolution of 15.625 picoseconds.
+// Whole nanoseconds are exact, but finer values are truncated toward zero,
+// both when set and, since 15.625 is not an integer, when retrieved.
+//
+// The count is split into a signed 64-bit high part and an unsigned 32-bit low
+// part. These are stored as 32-bit words so that the alignment, and therefore
+// the size, stays at 12 bytes. The special values are encoded in the high part
+// as SecondsTraits<int64_t> values, with the low part cleared, so the category
+// can be read from the high part alone. It follows that the numeric range is
+// whatever keeps the high part within [Min, Max]. Anything beyond saturates.
+//
+// This class is just storage. The conversions to and from seconds and
+// picoseconds are in its RepAdapter specialization.
+class Packed96Rep {
+public:
+  using HighT = int64_t;
+  using LowT = uint32_t;
+  using Traits = SecondsTraits<HighT>;
+
+  // Each tick is 125/8 picoseconds.
+  static constexpr const int64_t TicksPerSecond = NanosPerSecond * 64;
+  static constexpr const UnitPicos PicosPerTickNum = 125;
+  static constexpr const UnitPicos PicosPerTickDen = 8;
+  // The high part is signed and the low part isn't, just as for the count.
+  static constexpr const bool rawComparable = true;
+
+  constexpr Packed96Rep() noexcept : m_words{0, 0, 0} {}
+  constexpr Packed96Rep(HighT hi, LowT lo) noexcept
+      : m_words{lo, static_cast<uint32_t>(static_cast<uint64_t>(hi)),
+            static_cast<uint32_t>(static_cast<uint64_t>(hi) >> 32)} {}
+
+  constexpr HighT high() const noexcept {
+    return static_cast<HighT>(
+        (static_cast<uint64_t>(m_words[2]) << 32) | m_words[1]);
+  }
+
+  constexpr LowT low() const noexcept { return m_words[0]; }
+
+  // Gets the whole count, sign-extended to 128 bits.
+  constexpr WidePair count() const noexcept {
+    HighT hi = high();
+    return WidePair{static_cast<uint64_t>(hi >> 32),
+        (static_cast<uint64_t>(hi) << 32) | low()};
+  }
+
+  auto dump(std::ostream& os) const -> decltype(os) {
+    auto flagScope = StreamFlagsGuard(os, std::ios::hex);
+    return os << high() << "." << low() << " <" << sizeof(*this) << ">";
+  }
+
+private:
+  // Least significant first.
+  uint32_t m_words[3];
+};
+
+} // namespace details
+
+// Adapter for the packed 96-bit representation.
+//
+// Retrieval divides the magnitude of the count by a precomputed reciprocal of
+// the ticks per second and then restores the sign with masks, so the only
+// branch is the one that sets aside special values.
+template<>
+struct RepAdapter<details::Packed96Rep> {
+  using Traits = SecondsTraits<>;
+  using RepT = details::Packed96Rep;
+  using RepLimits = std::numeric_limits<RepT>;
+  using WholesT = RepT::HighT;
+  using FractionsT = RepT::LowT;
+
+  static constexpr const WideDivisor TickDivisor{RepT::TicksPerSecond};
+
+  RepT m_rep;
+
+  constexpr RepAdapter() noexcept : m_rep() {}
+  explicit constexpr RepAdapter(const UnitValue& sss) noexcept
+      : m_rep(create(sss.s, sss.ss)) {}
+  explicit constexpr RepAdapter(const RepT& rep) noexcept : m_rep(rep) {}
+  constexpr RepAdapter(UnitSeconds s, UnitPicos ss) noexcept
+      : m_rep(create(s, ss)) {}
+  constexpr RepAdapter(const RepAdapter&) noexcept = default;
+
+  constexpr RepAdapter& operator=(const RepAdapter&) noexcept = default;
+
+  constexpr UnitSeconds seconds() const noexcept { return value().s; }
+  constexpr void seconds(UnitSeconds s) noexcept {
+    m_rep = create(s, subseconds());
+  }
+
+  constexpr UnitPicos subseconds() const noexcept { return value().ss; }
+  constexpr void subseconds(UnitPicos ss) noexcept {
+    m_rep = create(seconds(), ss);
+  }
+
+  constexpr UnitValue value() const noexcept {
+    WholesT hi = m_rep.high();
+    if (hi > Traits::Max || hi < Traits::Min) return UnitValue{hi, 0};
+    // Divide the magnitude, then negate both parts if the count was negative.
+    auto mask = static_cast<uint64_t>(hi >> 63);
+    WidePair count = m_rep.count();
+    WidePair mag = wideSub(
+        WidePair{count.hi ^ mask, count.lo ^ mask}, WidePair{mask, mask});
+    uint64_t ticks = 0;
+    uint64_t s = TickDivisor.divu(mag, ticks).lo;
+    uint64_t ss = ticks * RepT::PicosPerTickNum / RepT::PicosPerTickDen;
+    return UnitValue{static_cast<UnitSeconds>((s ^ mask) - mask),
+        static_cast<UnitPicos>((ss ^ mask) - mask)};
+  }
+  constexpr void value(const UnitValue& sss) noexcept {
+    m_rep = create(sss.s, sss.ss);
+  }
+  constexpr void value(UnitSeconds s, UnitPicos ss) noexcept {
+    m_rep = create(s, ss);
+  }
+
+  constexpr bool isNegative() const noexcept { return m_rep.high() < 0; }
+
+  // Compares the raw count, except that NaN on either side compares as
+  // greater.
+  constexpr std::partial_ordering compare(const RepAdapter& rhs) const
+      noexcept {
+    WholesT hiL = m_rep.high(), hiR = rhs.m_rep.high();
+    if (hiL == Traits::NaN || hiR == Traits::NaN) return 1 <=> 0;
+    if (auto cmp = hiL <=> hiR; cmp != 0) return cmp;
+    return m_rep.low() <=> rhs.m_rep.low();
+  }
+
+  constexpr void category(Category cat) noexcept {
+    switch (cat) {
+    case Category::Num: m_rep = RepT(); break;
+    case Category::NaN: m_rep = RepT(Traits::NaN, 0); break;
+    case Category::InfN: m_rep = RepT(Traits::InfN, 0); break;
+    case Category::InfP: m_rep = RepT(Traits::InfP, 0); break;
+    }
+  }
+
+  auto dump(std::ostream& os) const -> decltype(os) { return m_rep.dump(os); }
+
+private:
+  // Creates the packed count, with the same sign rules as CanonRep. Excess
+  // subseconds need no special handling, as the count is wide enough to just
+  // absorb them.
+  static constexpr RepT create(UnitSeconds s, UnitPicos ss) noexcept {
+    if (s < 0 && ss > 0)
+      ss = -ss;
+    else if (s > 0 && ss < 0)
+      s = Traits::NaN;
+    if (s == Traits::NaN) return RepT(Traits::NaN, 0);
+    if (s > Traits::Max) return RepT(Traits::InfP, 0);
+    if (s < Traits::Min) return RepT(Traits::InfN, 0);
+
+    // Scale the subseconds in two steps so that large values can't overflow.
+    int64_t ticks = ss / RepT::PicosPerTickNum * RepT::PicosPerTickDen +
+        ss % RepT::PicosPerTickNum * RepT::PicosPerTickDen /
+            RepT::PicosPerTickNum;
+    int64_t lo, hi = mul128(s, RepT::TicksPerSecond, lo);
+    WidePair count = wideAdd(
+        WidePair{static_cast<uint64_t>(hi), static_cast<uint64_t>(lo)},
+        WidePair{ticks < 0 ? ~uint64_t(0) : 0, static_cast<uint64_t>(ticks)});
+
+    // Saturate unless the high part fits within the traits.
+    auto top = static_cast<int64_t>(count.hi);
+    if (top < -(int64_t(1) << 31)) return RepT(Traits::InfN, 0);
+    if (top >= (int64_t(1) << 31)) return RepT(Traits::InfP, 0);
+    auto high = static_cast<WholesT>((count.hi << 32) | (count.lo >> 32));
+    if (high > Traits::Max) return RepT(Traits::InfP, 0);
+    if (high < Traits::Min) return RepT(Traits::InfN, 0);
+    return RepT(high, static_cast<FractionsT>(count.lo));
+  }
+};
+
+namespace details {
+using Packed96ScalarUnit = ScalarUnit<Packed96Rep>;
+} // namespace details
+} // namespace chronos
+
+template<>
+class std::numeric_limits<chronos::details::Packed96Rep> {
+public:
+  using RepT = chronos::details::Packed96Rep;
+  using Traits = RepT::Traits;
+
+  [[nodiscard]] static constexpr RepT(min)() noexcept {
+    return RepT(Traits::Min, 0);
+  }
+
+  [[nodiscard]] static constexpr RepT(max)() noexcept {
+    return RepT(Traits::Max, ~RepT::LowT(0));
+  }
+
+  [[nodiscard]] static constexpr RepT lowest() noexcept { return (min)(); }
+
+  [[nodiscard]] static constexpr RepT epsilon() noexcept { return RepT(0, 1); }
+
+  [[nodiscard]] static constexpr RepT round_error() noexcept {
+    return (epsilon)();
+  }
+
+  [[nodiscard]] static constexpr RepT denorm_min() noexcept { return RepT(); }
+
+  [[nodiscard]] static constexpr RepT infinity() noexcept {
+    return RepT(Traits::InfP, 0);
+  }
+
+  [[nodiscard]] static constexpr RepT quiet_NaN() noexcept {
+    return RepT(Traits::NaN, 0);
+  }
+
+  [[nodiscard]] static constexpr RepT signaling_NaN() noexcept {
+    return (quiet_NaN)();
+  }
+
+  static constexpr float_denorm_style has_denorm = denorm_absent;
+  static constexpr bool has_denorm_loss = false;
+  static constexpr bool has_infinity = true;
+  static constexpr bool has_quiet_NaN = true;
+  static constexpr bool has_signaling_NaN = false;
+  static constexpr bool is_bounded = true;
+  static constexpr bool is_exact = true;
+  static constexpr bool is_iec559 = false;
+  static constexpr bool is_integer = false;
+  static constexpr bool is_modulo = false;
+  static constexpr bool is_signed = true;
+  static constexpr bool is_specialized = true;
+  static constexpr bool tinyness_before = false;
+  static constexpr bool traps = false;
+  static constexpr float_round_style round_style = round_toward_zero;
+  static constexpr int digits = 95;
+  static constexpr int digits10 = 28;
+  static constexpr int max_digits10 = 29;
+  static constexpr int max_exponent = 0;
+  static constexpr int max_exponent10 = 0;
+  static constexpr int min_exponent = 0;
+  static constexpr int min_exponent10 = 0;
+  static constexpr int radix = 2;
+};
@@ -0,0 +1,340 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include "Civil.h"
+#include "Moment.h"
+
+namespace chronos {
+// Parsing of moments from ISO 8601 timestamps, in the RFC 3339 profile:
+//
+//   YYYY-MM-DDTHH:MM:SS[.fraction][Z|+hh:mm|-hh:mm]
+//
+// The fraction has from one to twelve digits, which is as fine as picoseconds
+// go, so the moment is exact. The T may also be a lowercase t or a space, and
+// the Z lowercase. Without an offset, the time is taken as UTC. Years are from
+// 0000 to 9999, and the moment is relative to the de facto epoch, 0001-01-01.
+// Leap seconds, which are written as second 60, aren't accepted.
+//
+// The fixed-width part, up to the seconds, is checked and converted eight
+// bytes at a time, as is the fraction, when there are enough bytes left in the
+// text to read them as words.
+
+// Parse errors. Each says what was wrong at the place the result points to.
+enum class ParseError {
+  None,
+  Truncated, // The text ended early.
+  Syntax, // A character that can't be there, such as a letter for a digit.
+  Month,
+  Day, // Past the end of the month.
+  Hour,
+  Minute,
+  Second,
+  Fraction, // More than twelve digits.
+  Offset, // Hours or minutes out of range.
+};
+
+namespace details {
+inline constexpr auto ParseErrorNames = make_array("None"sv, "Truncated"sv,
+    "Syntax"sv, "Month"sv, "Day"sv, "Hour"sv, "Minute"sv, "Second"sv,
+    "Fraction"sv, "Offset"sv);
+} // namespace details
+
+constexpr const auto& asString(const ParseError& error) {
+  return details::ParseErrorNames[static_cast<int>(error)];
+}
+
+// Result of parsing, as with std::from_chars. On success, ptr is just past
+// what was parsed. On failure, it's at the character or field that was wrong,
+// and the moment is left alone.
+struct ParseResult {
+  const char* ptr;
+  ParseError error;
+
+  constexpr explicit operator bool() const noexcept {
+    return error == ParseError::None;
+  }
+};
+
+namespace details {
+// Length of the fixed-width part, through the seconds.
+constexpr const std::ptrdiff_t IsoFixedSize = 19;
+constexpr const int IsoMaxFractionDigits = 12;
+
+// Where each field of the fixed-width part starts.
+constexpr const int IsoMonthAt = 5;
+constexpr const int IsoDayAt = 8;
+constexpr const int IsoHourAt = 11;
+constexpr const int IsoMinuteAt = 14;
+constexpr const int IsoSecondAt = 17;
+
+// Digits of the first two words of the fixed-width part, "YYYY-MM-" and
+// "DDTHH:MM", as masks of the bytes, which are loaded little-endian, and the
+// separators that go between them.
+constexpr const uint64_t IsoDateDigits = 0x00FF'FF00'FFFF'FFFF;
+constexpr const uint64_t IsoDateSeparators = 0x2D00'002D'0000'0000;
+constexpr const uint64_t IsoTimeDigits = 0xFFFF'00FF'FF00'FFFF;
+constexpr const uint64_t IsoTimeSeparators = 0x0000'3A00'0054'0000;
+
+constexpr const uint64_t SwarLowNibbles = 0x0F0F'0F0F'0F0F'0F0F;
+constexpr const uint64_t SwarHighNibbles = 0xF0F0'F0F0'F0F0'F0F0;
+constexpr const uint64_t SwarDigitNibbles = 0x3333'3333'3333'3333;
+
+constexpr uint64_t loadLittleEndian(const char* in) noexcept {
+  uint64_t value = 0;
+  if (useByteLoops()) {
+    for (int i = 7; i >= 0; --i)
+      value = value << 8 | static_cast<unsigned char>(in[i]);
+    return value;
+  }
+  std::memcpy(&value, in, sizeof(value));
+  return value;
+}
+
+// Sets each byte of the word to 0x33 if it was a digit, and to something else
+// if it wasn't. A byte's high nibble must be 3, both as it is and with 6
+// added. Adding can carry into the next byte, but only out of one that isn't
+// a digit, so the first byte that isn't a digit is always found.
+constexpr uint64_t swarDigitNibbles(uint64_t word) noexcept {
+  return (word & SwarHighNibbles) |
+      ((word + 0x0606'0606'0606'0606) & SwarHighNibbles) >> 4;
+}
+
+// Gets the value of each pair of adjacent digits, in the byte of the first.
+constexpr uint64_t swarDigitPairs(uint64_t word, uint64_t digits) noexcept {
+  uint64_t values = word & SwarLowNibbles & digits;
+  return values * 10 + (values >> 8);
+}
+
+constexpr int swarByte(uint64_t word, int at) noexcept {
+  return static_cast<int>(word >> (8 * at) & 0xFF);
+}
+
+// Converts eight digits, loaded little-endian, to their value.
+constexpr uint64_t swarEightDigits(uint64_t word) noexcept {
+  word = (word & SwarLowNibbles) * 2561 >> 8;
+  word = (word & 0x00FF'00FF'00FF'00FF) * 6'553'601 >> 16;
+  return (word & 0x0000'FFFF'0000'FFFF) * 42'949'672'960'001 >> 32;
+}
+
+constexpr bool isDigit(char c) noexcept { return c >= '0' && c <= '9'; }
+
+// Reads count digits, or says why it couldn't.
+constexpr ParseError readDigits(
+    const char*& p, const char* last, int count, int& value) noexcept {
+  value = 0;
+  for (int i = 0; i < count; ++i, ++p) {
+    if (p == last) return ParseError::Truncated;
+    if (!isDigit(*p)) return ParseError::Syntax;
+    value = value * 10 + (*p - '0');
+  }
+  return ParseError::None;
+}
+
+constexpr ParseError readChar(const char*& p, const char* last,
+    char expected) noexcept {
+  if (p == last) return ParseError::Truncated;
+  if (*p != expected) return ParseError::Syntax;
+  ++p;
+  return ParseError::None;
+}
+
+struct IsoFields {
+  int year, month, day, hour, minute, second;
+};
+
+// Reads the fixed-width part a character at a time, saying exactly where it
+// goes wrong, if it does.
+constexpr ParseResult readIsoFixed(
+    const char* p, const char* last, IsoFields& f) noexcept {
+  ParseError error = ParseError::None;
+  auto step = [&](ParseError next) {
+    if (error == ParseError::None) error = next;
+    return error == ParseError::None;
+  };
+  step(readDigits(p, last, 4, f.year)) && step(readChar(p, last, '-')) &&
+      step(readDigits(p, last, 2, f.month)) && step(readChar(p, last, '-')) &&
+      step(readDigits(p, last, 2, f.day));
+  if (error == ParseError::None) {
+    if (p == last)
+      error = ParseError::Truncated;
+    else if (*p != 'T' && *p != 't' && *p != ' ')
+      error = ParseError::Syntax;
+    else
+      ++p;
+  }
+  step(readDigits(p, last, 2, f.hour)) && step(readChar(p, last, ':')) &&
+      step(readDigits(p, last, 2, f.minute)) && step(readChar(p, last, ':')) &&
+      step(readDigits(p, last, 2, f.second));
+  return ParseResult{p, error};
+}
+
+// Reads the fixed-width part as two words and three bytes, if it's all there
+// and in the usual form. Returns false if it isn't, so that readIsoFixed can
+// find out why.
+constexpr bool readIsoFixedFast(
+    const char* p, const char* last, IsoFields& f) noexcept {
+  if (last - p < IsoFixedSize) return false;
+  uint64_t date = loadLittleEndian(p);
+  uint64_t time = loadLittleEndian(p + 8);
+  uint64_t dateCheck = (swarDigitNibbles(date) & IsoDateDigits) |
+      (date & ~IsoDateDigits);
+  uint64_t timeCheck = (swarDigitNibbles(time) & IsoTimeDigits) |
+      (time & ~IsoTimeDigits);
+  if (dateCheck != ((SwarDigitNibbles & IsoDateDigits) | IsoDateSeparators) ||
+      timeCheck != ((SwarDigitNibbles & IsoTimeDigits) | IsoTimeSeparators) ||
+      p[16] != ':' || !isDigit(p[17]) || !isDigit(p[18]))
+    return false;
+  date = swarDigitPairs(date, IsoDateDigits);
+  time = swarDigitPairs(time, IsoTimeDigits);
+  f.year = swarByte(date, 0) * 100 + swarByte(date, 2);
+  f.month = swarByte(date, 5);
+  f.day = swarByte(time, 0);
+  f.hour = swarByte(time, 3);
+  f.minute = swarByte(time, 6);
+  f.second = (p[17] - '0') * 10 + (p[18] - '0');
+  return true;
+}
+
+// Reads the digits of the fraction, after the point, as picoseconds.
+constexpr ParseResult readIsoFraction(
+    const char* p, const char* last, UnitPicos& picos) noexcept {
+  const char* start = p;
+  uint64_t value = 0;
+  if (last - p >= 8) {
+    uint64_t word = loadLittleEndian(p);
+    uint64_t others = swarDigitNibbles(word) ^ SwarDigitNibbles;
+    int count = others ? std::countr_zero(others) / 8 : 8;
+    if (count) value = swarEightDigits(word << (64 - 8 * count));
+    p += count;
+    if (count == 8)
+      for (; p != last && isDigit(*p) && p - start < 13; ++p)
+        value = value * 10 + static_cast<uint64_t>(*p - '0');
+  } else {
+    for (; p != last && isDigit(*p); ++p)
+      value = value * 10 + static_cast<uint64_t>(*p - '0');
+  }
+  auto count = static_cast<int>(p - start);
+  if (!count) {
+    return ParseResult{
+        p, p == last ? ParseError::Truncated : ParseError::Syntax};
+  }
+  if (count > IsoMaxFractionDigits)
+    return ParseResult{start, ParseError::Fraction};
+  picos = static_cast<UnitPicos>(
+      value * PowersOfTen[IsoMaxFractionDigits - count]);
+  return ParseResult{p, ParseError::None};
+}
+
+// Reads the offset from UTC, if any, as seconds to subtract.
+constexpr ParseResult readIsoOffset(
+    const char* p, const char* last, UnitSeconds& offset) noexcept {
+  offset = 0;
+  if (p == last) return ParseResult{p, ParseError::None};
+  if (*p == 'Z' || *p == 'z') return ParseResult{p + 1, ParseError::None};
+  if (*p != '+' && *p != '-') return ParseResult{p, ParseError::None};
+  const char* sign = p++;
+  int hours = 0, minutes = 0;
+  ParseError error = readDigits(p, last, 2, hours);
+  if (error == ParseError::None) error = readChar(p, last, ':');
+  if (error == ParseError::None) error = readDigits(p, last, 2, minutes);
+  if (error != ParseError::None) return ParseResult{p, error};
+  if (hours > 23 || minutes > 59) return ParseResult{sign, ParseError::Offset};
+  offset = hours * SecondsPerHour + minutes * SecondsPerMinute;
+  if (*sign == '-') offset = -offset;
+  return ParseResult{p, ParseError::None};
+}
+
+// Checks the ranges of the fields, which must all be digits.
+constexpr ParseResult checkIsoFields(
+    const char* first, const IsoFields& f) noexcept {
+  // Every month has at least 28 days, so most dates are checked at once.
+  if ((f.month >= 1) & (f.month <= 12) & (f.day >= 1) & (f.day <= 28) &
+      (f.hour <= 23) & (f.minute <= 59) & (f.second <= 59))
+    return ParseResult{first + IsoFixedSize, ParseError::None};
+  if (f.month < 1 || f.month > 12)
+    return ParseResult{first + IsoMonthAt, ParseError::Month};
+  if (f.day < 1 || f.day > daysInMonth(f.year, f.month))
+    return ParseResult{first + IsoDayAt, ParseError::Day};
+  if (f.hour > 23) return ParseResult{first + IsoHourAt, ParseError::Hour};
+  if (f.minute > 59)
+    return ParseResult{first + IsoMinuteAt, ParseError::Minute};
+  if (f.second > 59)
+    return ParseResult{first + IsoSecondAt, ParseError::Second};
+  return ParseResult{first + IsoFixedSize, ParseError::None};
+}
+
+constexpr ParseResult parseIso(
+    const char* first, const char* last, UnitValue& sss) noexcept {
+  IsoFields f{};
+  if (!readIsoFixedFast(first, last, f)) {
+    if (auto result = readIsoFixed(first, last, f); !result) return result;
+  }
+  ParseResult result = checkIsoFields(first, f);
+  if (!result) return result;
+
+  UnitPicos picos = 0;
+  if (result.ptr != last && *result.ptr == '.') {
+    result = readIsoFraction(result.ptr + 1, last, picos);
+    if (!result) return result;
+  }
+  UnitSeconds offset = 0;
+  result = readIsoOffset(result.ptr, last, offset);
+  if (!result) return result;
+
+  UnitSeconds s = daysFromCivil(f.year, f.month, f.day) * SecondsPerDay +
+      f.hour * SecondsPerHour + f.minute * SecondsPerMinute + f.second - offset;
+  // Only the year 0000 comes before the epoch.
+  if (s < 0 && picos) ++s, picos -= PicosPerSecond;
+  sss = UnitValue{s, picos};
+  return result;
+}
+} // namespace details
+
+// Parses a timestamp from the start of the text.
+template<typename Scalar>
+constexpr ParseResult parseMoment(
+    const char* first, const char* last, Moment<Scalar>& out) noexcept {
+  UnitValue sss{};
+  ParseResult result = details::parseIso(first, last, sss);
+  if (result) out = Moment<Scalar>(sss);
+  return result;
+}
+
+template<typename Scalar>
+constexpr ParseResult parseMoment(
+    std::string_view text, Moment<Scalar>& out) noexcept {
+  return parseMoment(text.data(), text.data() + text.size(), out);
+}
+
+// Parses timestamps separated by the delimiter, such as a newline, appending
+// them to out, which may be a MomentColumn or any other container with a
+// push_back that takes Moment<>. A delimiter at the very end is allowed. On
+// failure, the timestamps before the bad one have been appended, and ptr is
+// where it went wrong. Anything but the delimiter after a timestamp is a
+// syntax error.
+template<typename Container>
+ParseResult parseMoments(
+    const char* first, const char* last, char delimiter, Container& out) {
+  while (first != last) {
+    UnitValue sss{};
+    ParseResult result = details::parseIso(first, last, sss);
+    if (!result) return result;
+    out.push_back(Moment<>(sss));
+    if (result.ptr == last) break;
+    if (*result.ptr != delimiter)
+      return ParseResult{result.ptr, ParseError::Syntax};
+    first = result.ptr + 1;
+  }
+  return ParseResult{last, ParseError::None};
+}
+
+template<typename Container>
+ParseResult parseMoments(
+    std::string_view text, char delimiter, Container& out) {
+  return parseMoments(text.data(), text.data() + text.size(), delimiter, out);
+}
+
+} // namespace chronos
@@ -16,8 +16,9 @@ namespace chronos {
 // which is a signed offset from an implied epoch.
 //
 // The value is always defined in terms of TAI, so such things as leap seconds
-// are the responsibility of time zone conversion, even to UTC. There is no
-// such thing as days, or even minutes; those are properties of civil times.
+// are the responsibility of time zone conversion, even to UTC, which is what
+// LeapSeconds is for. There is no such thing as days, or even minutes; those
+// are properties of civil times.
 //
 // The adapter exposes accessors for seconds() and subseconds(). These are both
 // signed 64-bit values. Conceptually, you can view the pair as a single
@@ -70,8 +71,12 @@ namespace chronos {
 //
 // The de facto epoch is 0001-01-01 00:00:00 in the proleptic Gregorian
 // calendar.
+//
+// Like CanonRep, this does not derive from SecondsTraits, so that it adds
+// nothing to the size of the ScalarUnit that contains it.
 template<typename Rep>
-struct RepAdapter : public SecondsTraits<> {
+struct RepAdapter {
+  using Traits = SecondsTraits<>;
   using RepT = Rep;
   using RepLimits = std::numeric_limits<Rep>;
   using WholesT = typename Rep::WholesT;
@@ -99,16 +104,26 @@ struct RepAdapter : public SecondsTraits<> {
     m_rep.value(s, ss);
   }
 
-  constexpr bool isNegative() const noexcept {
-    return m_rep.wholes() < 0 || m_rep.fractions() < 0;
+  constexpr bool isNegative() const noexcept { return m_rep.isNegative(); }
+
+  // Compares the raw wholes and fractions of raw-comparable reps, except that
+  // NaN on either side compares as greater.
+  template<typename R = Rep,
+      typename std::enable_if_t<is_raw_comparable_v<R>, int> = 0>
+  constexpr std::partial_ordering compare(const RepAdapter& rhs) const
+      noexcept {
+    auto wL = m_rep.wholes(), wR = rhs.m_rep.wholes();
+    if (wL == Rep::NaN || wR == Rep::NaN) return 1 <=> 0;
+    if (auto cmp = wL <=> wR; cmp != 0) return cmp;
+    return m_rep.fractions() <=> rhs.m_rep.fractions();
   }
 
   constexpr void category(Category cat) noexcept {
     switch (cat) {
     case Category::Num: value(0, 0); break;
     case Category::NaN: value(+1, -1); break;
-    case Category::InfN: seconds(InfN); break;
-    case Category::InfP: seconds(InfP); break;
+    case Category::InfN: value(Traits::InfN, 0); break;
+    case Category::InfP: value(Traits::InfP, 0); break;
     }
   }
 
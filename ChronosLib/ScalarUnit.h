@@ -59,6 +59,9 @@ public:
 
   constexpr explicit ScalarUnit(Category cat) noexcept { category(cat); }
 
+  // Construct directly from the representation, with no conversion.
+  constexpr explicit ScalarUnit(const RepT& rep) noexcept : m_adapter(rep) {}
+
   constexpr ScalarUnit(const ScalarUnit&) noexcept = default;
 
   // TODO: Consider whether it's worth providing a non-templated copy ctor.
@@ -132,6 +135,7 @@ public:
   constexpr Seconds seconds() const noexcept { return m_adapter.seconds(); }
   constexpr Picos subseconds() const noexcept { return m_adapter.subseconds(); }
   constexpr Value value() const noexcept { return m_adapter.value(); }
+  constexpr const RepT& rep() const noexcept { return m_adapter.m_rep; }
 
   // Arithmetic operators.
 
@@ -140,21 +144,34 @@ public:
   constexpr ScalarUnit operator-() noexcept {
     // TODO: Maybe optimize to avoid scaling.
     const auto& sss = value();
+    if (sss.s == NaN) return *this;
     return ScalarUnit(-sss.s, -sss.ss);
   }
 
   template<typename RepU, template<typename> class AdapterU>
   constexpr ::std::partial_ordering operator<=>(
       const ScalarUnit<RepU, AdapterU>& rhs) const noexcept {
+    if constexpr (usesDirectCompare<RepU, AdapterU>())
+      return m_adapter.compare(rhs.m_adapter);
     const auto sssL = value(), sssR = rhs.value();
     if (sssL.s == NaN || sssR.s == NaN) return 1 <=> 0;
     if (auto cmp = sssL.s <=> sssR.s; cmp != 0) return cmp;
     return sssL.ss <=> sssR.ss;
   }
 
+  // A custom operator<=> doesn't imply operator==, so it's spelled out.
+  template<typename RepU, template<typename> class AdapterU>
+  constexpr bool operator==(const ScalarUnit<RepU, AdapterU>& rhs) const
+      noexcept {
+    return (*this <=> rhs) == 0;
+  }
+
   template<typename RepU, template<typename> class AdapterU>
   constexpr ScalarUnit& operator+=(
       const ScalarUnit<RepU, AdapterU>& rhs) noexcept {
+    if constexpr (usesDirectArithmetic<RepU, AdapterU>()) {
+      if (m_adapter.tryAdd(rhs.m_adapter)) return *this;
+    }
     // TODO: Figure out why using structured binding here causes a compiler
     // error related to constexpr.
     UnitValue sssL = value(), sssR = rhs.value();
@@ -163,13 +180,22 @@ public:
     auto cat = addCategories(toCategory(sL), toCategory(sR));
     if (cat != Category::Num) return *this = cat;
     ssL += ssR;
-    // Carry or borrow second on s/ss sign difference.
+    // Carry any whole second out of the subseconds. Since |sR| <= Max, this
+    // can't overflow.
+    if (ssL >= PicosPerSecond)
+      ssL -= PicosPerSecond, sR++;
+    else if (ssL <= -PicosPerSecond)
+      ssL += PicosPerSecond, sR--;
+    // Add seconds, with saturation. A sum that lands on the encoding of NaN is
+    // also an underflow.
+    if (!addSafely(sL, sR, sL)) return overflow(sL > 0);
+    if (sL == NaN) return overflow(true);
+    // Carry or borrow second on s/ss sign difference. This has to wait until
+    // the seconds are summed, since that's what determines the sign.
     if (ssL > 0 && sL < 0)
       ssL -= PicosPerSecond, sL++;
     else if (ssL < 0 && sL > 0)
       ssL += PicosPerSecond, sL--;
-    // Add seconds, with saturation.
-    if (!addSafely(sL, sR, sL)) return overflow(sL > 0);
     return set(sL, ssL);
   }
 
@@ -193,14 +219,89 @@ public:
     if (!ss) return set(s, ss);
     // Multiply subseconds, then convert to seconds.
     UnitPicos quot, lo, hi = mul128(ss, m, lo);
-    ss = div128(hi, lo, PicosPerSecond, quot);
+    ss = PicosPerSecondDivisor.div(hi, lo, quot);
     if (!addSafely(s, quot, s)) return overflow(outNeg);
     return set(s, ss);
   }
 
+  // Divides by an integer, truncating toward zero. Division by zero saturates
+  // to the infinity with the sign of the dividend. Infinities stay infinite,
+  // but change sign when divided by a negative.
+  template<typename U,
+      typename std::enable_if_t<std::is_integral_v<U> && !std::is_class_v<U>,
+          int> = 0>
+  constexpr ScalarUnit& operator/=(const U& rhs) noexcept {
+    const UnitSeconds& d = rhs;
+    UnitValue sss = value();
+    UnitSeconds s = sss.s;
+    UnitPicos ss = sss.ss;
+    if (s == NaN) return *this;
+    bool neg(s < 0 || ss < 0);
+    if (!d) return overflow(neg);
+    if (isSpecial()) return (d < 0) ? overflow(!neg) : *this;
+    // Divide the seconds, then bring the remainder down into the subseconds
+    // and divide those. The result is less than a second, so it can't
+    // overflow.
+    UnitSeconds quot = s / d;
+    int64_t lo, hi = mul128(s % d, PicosPerSecond, lo);
+    uint64_t sum = static_cast<uint64_t>(lo) + static_cast<uint64_t>(ss);
+    hi += (sum < static_cast<uint64_t>(lo)) - (ss < 0);
+    div128(hi, static_cast<int64_t>(sum), d, ss);
+    return set(quot, ss);
+  }
+
+  // Divides by another scalar, returning the number of times it goes in,
+  // truncated toward zero, and setting rem to what's left over, which takes
+  // the sign of the dividend.
+  //
+  // The count is encoded like seconds, so that it can hold special results. It
+  // is NaN when either side is NaN, both are infinite, or both are zero. It
+  // saturates to infinity on overflow, when dividing an infinity, or when
+  // dividing by zero. Whenever the count is special, so is the remainder. A
+  // number divided by an infinity goes in zero times, leaving itself.
+  template<typename RepU, template<typename> class AdapterU>
+  constexpr UnitSeconds divide(
+      const ScalarUnit<RepU, AdapterU>& rhs, ScalarUnit& rem) const noexcept {
+    UnitValue sssL = value(), sssR = rhs.value();
+    Category catL = toCategory(sssL.s), catR = toCategory(sssR.s);
+    bool negL(sssL.s < 0 || sssL.ss < 0), negR(sssR.s < 0 || sssR.ss < 0);
+    bool outNeg(negL != negR);
+    rem = Category::NaN;
+    if (catL == Category::NaN || catR == Category::NaN) return NaN;
+    if (catR != Category::Num) {
+      if (catL != Category::Num) return NaN;
+      rem = *this;
+      return 0;
+    }
+    if (catL != Category::Num) return outNeg ? InfN : InfP;
+    WidePair n = toWidePicos(sssL), d = toWidePicos(sssR);
+    if (d == WidePair{}) {
+      if (n == WidePair{}) return NaN;
+      return negL ? InfN : InfP;
+    }
+    WidePair r{};
+    WidePair q = wideDiv(n, d, r);
+    if (q.hi || q.lo > static_cast<uint64_t>(Max)) return outNeg ? InfN : InfP;
+    rem.setWidePicos(r, negL);
+    auto count = static_cast<UnitSeconds>(q.lo);
+    return outNeg ? -count : count;
+  }
+
+  // Sets this to the remainder of dividing by rhs. See divide for details.
+  template<typename RepU, template<typename> class AdapterU>
+  constexpr ScalarUnit& operator%=(
+      const ScalarUnit<RepU, AdapterU>& rhs) noexcept {
+    ScalarUnit rem;
+    divide(rhs, rem);
+    return *this = rem;
+  }
+
   template<typename RepU, template<typename> class AdapterU>
   constexpr ScalarUnit& operator-=(
       const ScalarUnit<RepU, AdapterU>& rhs) noexcept {
+    if constexpr (usesDirectArithmetic<RepU, AdapterU>()) {
+      if (m_adapter.trySub(rhs.m_adapter)) return *this;
+    }
     return (*this) += -ScalarUnit<>(rhs);
   }
 
@@ -246,12 +347,31 @@ public:
   }
 
   static constexpr UnitValue fromFloat(double sss) noexcept {
+    // Converting an out-of-range double to an integer is undefined. x64
+    // hardware happens to produce the integer minimum, which is our NaN, so
+    // make that explicit instead of depending on it. This also catches NaN.
+    constexpr double limit = 9223372036854775808.0;
+    if (!(sss > -limit && sss < limit)) return UnitValue{NaN, 0};
     UnitSeconds s = static_cast<UnitSeconds>(sss);
     UnitPicos ss = static_cast<UnitPicos>((sss - s) * PicosPerSecond);
     return UnitValue{s, ss};
   }
 
 private:
+  template<typename, template<typename> class>
+  friend class ScalarUnit;
+
+  // Whether operations with rhs can be handed off to the adapter.
+  template<typename RepU, template<typename> class AdapterU>
+  static constexpr bool usesDirectArithmetic() noexcept {
+    return has_direct_arithmetic_v<AdapterT, AdapterU<RepU>>;
+  }
+
+  template<typename RepU, template<typename> class AdapterU>
+  static constexpr bool usesDirectCompare() noexcept {
+    return has_direct_compare_v<AdapterT, AdapterU<RepU>>;
+  }
+
   constexpr ScalarUnit& overflow(bool neg) {
     return *this = (neg) ? Category::InfN : Category::InfP;
   }
@@ -260,23 +380,44 @@ private:
     m_adapter.value(UnitValue{s, ss});
     return *this;
   }
+
+  // Sets from the magnitude of a wide picosecond count, which must be small
+  // enough for the seconds to fit.
+  constexpr ScalarUnit& setWidePicos(WidePair picos, bool neg) noexcept {
+    uint64_t s = 0;
+    uint64_t ss = PicosPerSecondDivisor.divu(picos.hi, picos.lo, s);
+    auto sS = static_cast<UnitSeconds>(s);
+    auto ssS = static_cast<UnitPicos>(ss);
+    return neg ? set(-sS, -ssS) : set(sS, ssS);
+  }
 }; // namespace details
 
+using DefaultScalarUnit = ScalarUnit<DefaultBaseRep>;
+
+// The scalar for the result of combining two scalars. When they match, the
+// result keeps their representation. Otherwise, it widens to the default.
+template<typename ScalarT, typename ScalarU>
+using CommonScalar = std::conditional_t<std::is_same_v<ScalarT, ScalarU>,
+    ScalarT, DefaultScalarUnit>;
+
 template<typename RepT, template<typename> class AdapterT, typename RepU,
     template<typename> class AdapterU>
-constexpr const ScalarUnit<> operator+(const ScalarUnit<RepT, AdapterT>& lhs,
+constexpr const auto operator+(const ScalarUnit<RepT, AdapterT>& lhs,
     const ScalarUnit<RepU, AdapterU>& rhs) noexcept {
-  return ScalarUnit<>(lhs) += rhs;
+  using Common =
+      CommonScalar<ScalarUnit<RepT, AdapterT>, ScalarUnit<RepU, AdapterU>>;
+  return Common(lhs) += rhs;
 }
 
 template<typename RepT, template<typename> class AdapterT, typename RepU,
     template<typename> class AdapterU>
-constexpr const ScalarUnit<> operator-(const ScalarUnit<RepT, AdapterT>& lhs,
+constexpr const auto operator-(const ScalarUnit<RepT, AdapterT>& lhs,
     const ScalarUnit<RepU, AdapterU>& rhs) noexcept {
-  return ScalarUnit<>(lhs) -= rhs;
+  using Common =
+      CommonScalar<ScalarUnit<RepT, AdapterT>, ScalarUnit<RepU, AdapterU>>;
+  return Common(lhs) -= rhs;
 }
 
-using DefaultScalarUnit = ScalarUnit<DefaultBaseRep>;
 using DefaultAdapter = DefaultScalarUnit::AdapterT;
 
 } // namespace details
@@ -33,6 +33,7 @@ public:
   using Scalar::seconds;
   using Scalar::subseconds;
   using Scalar::value;
+  using Scalar::rep;
   using Scalar::InfP;
   using Scalar::InfN;
   using Scalar::NaN;
@@ -46,16 +47,27 @@ public:
   using Scalar::isNegativeInfinity;
   using Scalar::dump;
 
+  // Convert from siblings with other representations.
+  template<typename ScalarU,
+      typename std::enable_if_t<!std::is_same_v<Scalar, ScalarU>, int> = 0>
+  constexpr explicit ScalarUnitChild(const Other<ScalarU>& rhs) noexcept
+      : Parent(scalarOf(rhs)) {}
+
   template<typename ScalarU>
   constexpr Child& operator=(const Other<ScalarU>& rhs) {
-    Parent::operator=(rhs);
+    Parent::operator=(scalarOf(rhs));
     return static_cast<Child&>(*this);
   }
 
   template<typename ScalarU>
   constexpr ::std::partial_ordering operator<=>(const Other<ScalarU>& rhs) const
       noexcept {
-    return Parent::operator<=>(static_cast<const Parent&>(rhs));
+    return Parent::operator<=>(scalarOf(rhs));
+  }
+
+  template<typename ScalarU>
+  constexpr bool operator==(const Other<ScalarU>& rhs) const noexcept {
+    return Parent::operator==(scalarOf(rhs));
   }
 
   constexpr Child operator-() noexcept {
@@ -64,13 +76,13 @@ public:
 
   template<typename ScalarU>
   constexpr Child& operator+=(const Other<ScalarU>& rhs) noexcept {
-    Parent::operator+=(rhs);
+    Parent::operator+=(scalarOf(rhs));
     return static_cast<Child&>(*this);
   }
 
   template<typename ScalarU>
   constexpr Child& operator-=(const Other<ScalarU>& rhs) noexcept {
-    Parent::operator-=(rhs);
+    Parent::operator-=(scalarOf(rhs));
     return static_cast<Child&>(*this);
   }
 
@@ -99,6 +111,54 @@ public:
     Parent::operator*=(rhs).value();
     return static_cast<Child&>(*this);
   }
+
+  template<typename U,
+      typename std::enable_if_t<std::is_integral_v<U> && !std::is_class_v<U>,
+          int> = 0>
+  constexpr const Child& operator/=(const U& rhs) noexcept {
+    Parent::operator/=(rhs);
+    return static_cast<Child&>(*this);
+  }
+
+  template<typename ScalarU>
+  constexpr UnitSeconds divide(const Other<ScalarU>& rhs, Child& rem) const
+      noexcept {
+    return Parent::divide(scalarOf(rhs), static_cast<Parent&>(rem));
+  }
+
+  template<typename ScalarU>
+  constexpr Child& operator%=(const Other<ScalarU>& rhs) noexcept {
+    Parent::operator%=(scalarOf(rhs));
+    return static_cast<Child&>(*this);
+  }
+
+protected:
+  // Adds or subtracts the scalar behind any child, for children that combine
+  // with other kinds, as moments do with durations.
+  template<typename ChildU>
+  constexpr Child& add(const ScalarUnitChild<ChildU>& rhs) noexcept {
+    Parent::operator+=(scalarOf(rhs));
+    return static_cast<Child&>(*this);
+  }
+
+  template<typename ChildU>
+  constexpr Child& subtract(const ScalarUnitChild<ChildU>& rhs) noexcept {
+    Parent::operator-=(scalarOf(rhs));
+    return static_cast<Child&>(*this);
+  }
+
+private:
+  template<typename>
+  friend class ScalarUnitChild;
+
+  // Gets the scalar behind a child, which may use another representation.
+  // Since the scalar is a private base, this takes friendship.
+  template<typename ChildU>
+  static constexpr const auto& scalarOf(
+      const ScalarUnitChild<ChildU>& rhs) noexcept {
+    using ScalarU = typename ScalarUnitChild<ChildU>::Scalar;
+    return static_cast<const ScalarU&>(rhs);
+  }
 };
 
 } // namespace details
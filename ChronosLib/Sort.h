@@ -0,0 +1,270 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Column.h"
+
+namespace chronos {
+namespace details {
+// LSD radix sort over order keys (see toOrderKey), eleven bits at a time,
+// lowest first. Each pass is stable, so values that are equal, NaN included,
+// stay in their original order.
+//
+// The histograms for every digit are taken in a single read before the first
+// pass, and any digit that's the same for every key is skipped. That's most of
+// them in practice: moments from a single day usually differ only in the two
+// lowest digits of the seconds, so they take six passes instead of ten.
+constexpr int RadixBits = 11;
+constexpr std::size_t RadixBuckets = std::size_t(1) << RadixBits;
+// The picoseconds of a key take up only 41 bits.
+constexpr int RadixLoDigits = 4;
+constexpr int RadixDigits = RadixLoDigits + 6;
+// Fewer keys than this are sorted by comparison instead, since clearing and
+// scanning the histograms would take longer.
+constexpr std::size_t RadixMinKeys = std::size_t(1) << 10;
+// Smallest share of the keys worth handing to a thread of its own.
+constexpr std::size_t RadixMinChunk = std::size_t(1) << 14;
+
+using RadixCounts = std::array<std::size_t, RadixBuckets>;
+using RadixHistogram = std::array<RadixCounts, RadixDigits>;
+
+// Key with the position it came from, for reordering something else.
+struct RadixEntry {
+  WidePair key;
+  std::size_t index;
+};
+
+inline const WidePair& radixKey(const WidePair& entry) noexcept {
+  return entry;
+}
+
+inline const WidePair& radixKey(const RadixEntry& entry) noexcept {
+  return entry.key;
+}
+
+inline std::size_t radixDigit(const WidePair& key, int digit) noexcept {
+  uint64_t bits = digit < RadixLoDigits
+      ? key.lo >> (digit * RadixBits)
+      : key.hi >> ((digit - RadixLoDigits) * RadixBits);
+  return static_cast<std::size_t>(bits) & (RadixBuckets - 1);
+}
+
+// Runs fn(chunk, begin, end) over count nearly equal chunks of [0, n), each
+// on its own thread, with the last on the calling thread.
+template<typename Fn>
+void radixChunks(unsigned count, std::size_t n, const Fn& fn) {
+  auto bound = [&](unsigned chunk) {
+    return n / count * chunk + std::min<std::size_t>(chunk, n % count);
+  };
+  // Destroying a thread that's still joinable terminates, so the workers
+  // already started are joined even if starting the next one throws.
+  struct Workers {
+    std::vector<std::thread> threads;
+    ~Workers() {
+      for (auto& thread : threads)
+        if (thread.joinable()) thread.join();
+    }
+  } workers;
+  workers.threads.reserve(count - 1);
+  for (unsigned chunk = 0; chunk + 1 < count; ++chunk)
+    workers.threads.emplace_back(
+        std::cref(fn), chunk, bound(chunk), bound(chunk + 1));
+  fn(count - 1, bound(count - 1), n);
+}
+
+// Sorts the entries by key, splitting the work among up to threads threads.
+// Each pass then has every thread count its own chunk, so that they can all
+// scatter to disjoint places at once.
+template<typename Entry>
+void radixSortEntries(std::vector<Entry>& entries, unsigned threads) {
+  std::size_t n = entries.size();
+  if (n < RadixMinKeys) {
+    std::stable_sort(entries.begin(), entries.end(),
+        [](const Entry& a, const Entry& b) {
+          return radixKey(a) < radixKey(b);
+        });
+    return;
+  }
+  auto most = std::max<std::size_t>(n / RadixMinChunk, 1);
+  threads = static_cast<unsigned>(std::clamp<std::size_t>(threads, 1, most));
+
+  std::vector<Entry> buffer(n);
+  Entry* src = entries.data();
+  Entry* dst = buffer.data();
+
+  std::vector<RadixHistogram> hists(threads);
+  radixChunks(threads, n, [&](unsigned chunk, std::size_t b, std::size_t e) {
+    auto& hist = hists[chunk];
+    for (auto& counts : hist) counts.fill(0);
+    for (std::size_t i = b; i < e; ++i)
+      for (int digit = 0; digit < RadixDigits; ++digit)
+        ++hist[digit][radixDigit(radixKey(src[i]), digit)];
+  });
+  for (unsigned chunk = 1; chunk < threads; ++chunk)
+    for (int digit = 0; digit < RadixDigits; ++digit)
+      for (std::size_t bucket = 0; bucket < RadixBuckets; ++bucket)
+        hists[0][digit][bucket] += hists[chunk][digit][bucket];
+  const RadixHistogram& total = hists[0];
+
+  std::vector<RadixCounts> offsets(threads);
+  for (int digit = 0; digit < RadixDigits; ++digit) {
+    if (total[digit][radixDigit(radixKey(src[0]), digit)] == n) continue;
+
+    if (threads == 1) {
+      std::size_t next = 0;
+      for (std::size_t bucket = 0; bucket < RadixBuckets; ++bucket)
+        offsets[0][bucket] = next, next += total[digit][bucket];
+      for (std::size_t i = 0; i < n; ++i)
+        dst[offsets[0][radixDigit(radixKey(src[i]), digit)]++] = src[i];
+    } else {
+      radixChunks(threads, n,
+          [&](unsigned chunk, std::size_t b, std::size_t e) {
+            auto& counts = offsets[chunk];
+            counts.fill(0);
+            for (std::size_t i = b; i < e; ++i)
+              ++counts[radixDigit(radixKey(src[i]), digit)];
+          });
+      std::size_t next = 0;
+      for (std::size_t bucket = 0; bucket < RadixBuckets; ++bucket) {
+        for (auto& counts : offsets) {
+          std::size_t count = counts[bucket];
+          counts[bucket] = next;
+          next += count;
+        }
+      }
+      radixChunks(threads, n,
+          [&](unsigned chunk, std::size_t b, std::size_t e) {
+            auto& next = offsets[chunk];
+            for (std::size_t i = b; i < e; ++i)
+              dst[next[radixDigit(radixKey(src[i]), digit)]++] = src[i];
+          });
+    }
+    std::swap(src, dst);
+  }
+  if (src != entries.data()) entries.swap(buffer);
+}
+
+inline unsigned radixThreads(unsigned threads) noexcept {
+  if (threads) return threads;
+  return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+// Whether the elements are their own keys, so that they can be rebuilt from
+// the sorted keys instead of being moved around.
+template<typename T, typename Proj>
+inline constexpr bool radix_keys_only_v = std::is_same_v<Proj, std::identity> &&
+    (std::is_same_v<T, Moment<>> || std::is_same_v<T, Duration<>>);
+
+template<typename RandomIt, typename Proj>
+std::vector<RadixEntry> radixSortedEntries(
+    RandomIt first, RandomIt last, Proj& proj, unsigned threads) {
+  std::vector<RadixEntry> entries(static_cast<std::size_t>(last - first));
+  for (std::size_t i = 0; i < entries.size(); ++i)
+    entries[i] = RadixEntry{toOrderKey(std::invoke(proj, first[i]).value()), i};
+  radixSortEntries(entries, threads);
+  return entries;
+}
+
+template<typename RandomIt, typename Proj>
+void radixSortRange(
+    RandomIt first, RandomIt last, Proj& proj, unsigned threads) {
+  using T = std::iter_value_t<RandomIt>;
+  if constexpr (radix_keys_only_v<T, Proj>) {
+    std::vector<WidePair> keys(static_cast<std::size_t>(last - first));
+    for (std::size_t i = 0; i < keys.size(); ++i)
+      keys[i] = toOrderKey(first[i].value());
+    radixSortEntries(keys, threads);
+    for (std::size_t i = 0; i < keys.size(); ++i)
+      first[i] = T(fromOrderKey(keys[i]));
+  } else {
+    // Position i takes the element from entries[i].index. Following each
+    // cycle of that permutation moves every element straight to its place,
+    // holding just the first of the cycle aside, and marks each position
+    // done by pointing it at itself.
+    auto entries = radixSortedEntries(first, last, proj, threads);
+    for (std::size_t start = 0; start < entries.size(); ++start) {
+      if (entries[start].index == start) continue;
+      T held = std::move(first[start]);
+      std::size_t to = start;
+      for (std::size_t from = entries[to].index; from != start;
+          from = entries[to].index) {
+        first[to] = std::move(first[from]);
+        entries[to].index = to;
+        to = from;
+      }
+      first[to] = std::move(held);
+      entries[to].index = to;
+    }
+  }
+}
+
+template<typename Element>
+void radixSortColumn(ScalarColumn<Element>& column, unsigned threads) {
+  std::vector<WidePair> keys(column.size());
+  UnitSeconds* s = column.seconds();
+  UnitPicos* ss = column.subseconds();
+  for (std::size_t i = 0; i < keys.size(); ++i)
+    keys[i] = toOrderKey(UnitValue{s[i], ss[i]});
+  radixSortEntries(keys, threads);
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    UnitValue sss = fromOrderKey(keys[i]);
+    s[i] = sss.s, ss[i] = sss.ss;
+  }
+}
+} // namespace details
+
+// Sorts moments or durations, ascending, with NaN last. Equal values keep
+// their order, as with std::stable_sort, which this agrees with when given a
+// comparison that puts NaN last. It takes a fixed number of linear passes
+// rather than n log n comparisons, which pays off for large ranges.
+//
+// The projection picks the moment or duration out of each element, so that
+// whole records can be sorted by timestamp. Elements are moved straight to
+// their places, following the cycles of the permutation, so each is moved
+// once, apart from one per cycle that's held aside, and there's no second
+// copy of the range.
+template<typename RandomIt, typename Proj = std::identity>
+void radixSort(RandomIt first, RandomIt last, Proj proj = {}) {
+  details::radixSortRange(first, last, proj, 1);
+}
+
+// Sorts as radixSort does, splitting the work among the given number of
+// threads, or as many as the hardware runs at once if that's zero. Small
+// ranges aren't split.
+template<typename RandomIt, typename Proj = std::identity>
+void parallelRadixSort(
+    RandomIt first, RandomIt last, Proj proj = {}, unsigned threads = 0) {
+  details::radixSortRange(first, last, proj, details::radixThreads(threads));
+}
+
+// Gets the positions of the elements in the order that radixSort would put
+// them in, for reordering other data, such as the columns of a table, to
+// match. The elements themselves are left alone.
+template<typename RandomIt, typename Proj = std::identity>
+std::vector<std::size_t> radixArgsort(
+    RandomIt first, RandomIt last, Proj proj = {}, unsigned threads = 1) {
+  auto entries = details::radixSortedEntries(
+      first, last, proj, details::radixThreads(threads));
+  std::vector<std::size_t> order(entries.size());
+  for (std::size_t i = 0; i < order.size(); ++i) order[i] = entries[i].index;
+  return order;
+}
+
+// Sorts a column in place. The keys are built straight from its arrays.
+template<typename Element>
+void radixSort(details::ScalarColumn<Element>& column) {
+  details::radixSortColumn(column, 1);
+}
+
+template<typename Element>
+void parallelRadixSort(
+    details::ScalarColumn<Element>& column, unsigned threads = 0) {
+  details::radixSortColumn(column, details::radixThreads(threads));
+}
+
+} // namespace chronos
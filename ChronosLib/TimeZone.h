@@ -0,0 +1,607 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Civil.h"
+#include "Column.h"
+
+namespace chronos {
+// Time zones, as the offsets from UTC that they had at each moment, read from
+// the TZif files of the tz database, such as those in /usr/share/zoneinfo.
+// Nothing is fetched from anywhere else.
+//
+// A zone is kept as a compiled image: a table of the UTC seconds at which the
+// offset changed, with the offset from then on, and an index into it by
+// equal spans of time, so that a lookup goes straight to a transition or two
+// from the right one. The rule that a TZif file gives for the future, such as
+// "the second Sunday in March", is expanded into transitions for a full 400
+// years of the Gregorian calendar, after which it repeats exactly, so later
+// moments are moved back by whole cycles before looking them up. The image is
+// plain data, in the byte order of the machine, so it can be written out when
+// building and mapped back in without being parsed or copied.
+//
+// Offsets are in seconds east of UTC, as ISO 8601 writes them, and apply from
+// the second of the transition on. Moments before the first transition have
+// the zone's earliest offset, which is usually local mean time.
+
+// Errors from reading zones. None of them leave the zone changed.
+enum class ZoneError {
+  None,
+  File, // The file couldn't be read.
+  Format, // The data isn't TZif, or is cut short or inconsistent.
+  Rule, // The rule for future times can't be read.
+  LeapSeconds, // The data counts leap seconds, as the "right" zones do.
+  Image, // A compiled image is the wrong size, version, or alignment.
+};
+
+namespace details {
+inline constexpr auto ZoneErrorNames = make_array("None"sv, "File"sv,
+    "Format"sv, "Rule"sv, "LeapSeconds"sv, "Image"sv);
+} // namespace details
+
+constexpr const auto& asString(const ZoneError& error) {
+  return details::ZoneErrorNames[static_cast<int>(error)];
+}
+
+namespace details {
+// The start of a compiled image. The transition times, the index, and the
+// offsets follow, in that order, each padded to 8 bytes.
+struct ZoneImageHeader {
+  char magic[8];
+  uint32_t count; // Transitions.
+  uint32_t bucketCount; // Entries in the index.
+  int64_t cycleStart; // Zero if there's no cycle.
+  int64_t cycleEnd;
+  int32_t initialOffset; // Before the first transition.
+  int32_t bucketShift; // Each bucket of the index spans 2^shift seconds.
+};
+
+constexpr const char ZoneImageMagic[8] = {'C', 'h', 'r', 'T', 'Z', 'i', 'm',
+    '1'};
+constexpr const int64_t ZoneCycleSeconds = DaysPerEra * SecondsPerDay;
+constexpr const int64_t TzifMaxSeconds = int64_t{1} << 60;
+
+constexpr std::size_t padZoneImage(std::size_t bytes) noexcept {
+  return (bytes + 7) & ~std::size_t(7);
+}
+
+// Reads big-endian fields, as TZif has them, keeping track of what's left.
+struct TzifReader {
+  const unsigned char* p;
+  const unsigned char* end;
+
+  bool has(std::size_t n) const noexcept {
+    return static_cast<std::size_t>(end - p) >= n;
+  }
+
+  uint64_t read(int bytes) noexcept {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) value = value << 8 | *p++;
+    return value;
+  }
+
+  int64_t readSigned(int bytes) noexcept {
+    uint64_t value = read(bytes);
+    if (bytes < 8) {
+      uint64_t sign = uint64_t{1} << (bytes * 8 - 1);
+      value = (value ^ sign) - sign;
+    }
+    return static_cast<int64_t>(value);
+  }
+};
+
+// The counts from a TZif header, in the order they're stored.
+struct TzifCounts {
+  uint64_t isut, isstd, leap, time, type, chars;
+
+  std::size_t blockSize(int timeBytes) const noexcept {
+    return static_cast<std::size_t>(time * (timeBytes + 1) + type * 6 + chars +
+        leap * (timeBytes + 4) + isstd + isut);
+  }
+};
+
+inline bool readTzifHeader(
+    TzifReader& in, char& version, TzifCounts& counts) noexcept {
+  if (!in.has(44) || std::memcmp(in.p, "TZif", 4) != 0) return false;
+  version = static_cast<char>(in.p[4]);
+  in.p += 20;
+  uint64_t* fields[] = {&counts.isut, &counts.isstd, &counts.leap,
+      &counts.time, &counts.type, &counts.chars};
+  for (uint64_t* field : fields) *field = in.read(4);
+  return counts.type >= 1 && counts.type <= 256 &&
+      (!counts.isut || counts.isut == counts.type) &&
+      (!counts.isstd || counts.isstd == counts.type);
+}
+
+// A rule from a POSIX TZ string, for the day and local time of a transition.
+struct PosixRule {
+  char kind; // 'J' for Julian days without leap days, 'n' with, or 'M'.
+  int month;
+  int week;
+  int day;
+  int32_t time;
+};
+
+// The rule from a TZif footer, such as "EST5EDT,M3.2.0,M11.1.0".
+struct PosixZone {
+  int32_t stdOffset;
+  int32_t dstOffset;
+  bool hasDst;
+  PosixRule start; // Into daylight saving time.
+  PosixRule end;
+};
+
+struct PosixReader {
+  const char* p;
+  const char* end;
+
+  bool peek(char c) const noexcept { return p != end && *p == c; }
+
+  bool number(int& value, int maxDigits) noexcept {
+    int digits = 0;
+    for (value = 0; p != end && *p >= '0' && *p <= '9' && digits < maxDigits;
+         ++p, ++digits)
+      value = value * 10 + (*p - '0');
+    return digits > 0;
+  }
+
+  // A name is at least three letters, or anything in angle brackets.
+  bool name() noexcept {
+    if (peek('<')) {
+      const char* close = std::find(p, end, '>');
+      if (close == end) return false;
+      p = close + 1;
+      return true;
+    }
+    const char* first = p;
+    while (p != end && ((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z')))
+      ++p;
+    return p - first >= 3;
+  }
+
+  // Reads [+-]hh[:mm[:ss]], in seconds.
+  bool time(int32_t& seconds, int maxHours) noexcept {
+    bool negative = peek('-');
+    if (negative || peek('+')) ++p;
+    int hours = 0, minutes = 0, secs = 0;
+    if (!number(hours, 3) || hours > maxHours) return false;
+    if (peek(':')) {
+      ++p;
+      if (!number(minutes, 2) || minutes > 59) return false;
+      if (peek(':')) {
+        ++p;
+        if (!number(secs, 2) || secs > 59) return false;
+      }
+    }
+    seconds = hours * 3'600 + minutes * 60 + secs;
+    if (negative) seconds = -seconds;
+    return true;
+  }
+
+  bool rule(PosixRule& out) noexcept {
+    if (!peek(',')) return false;
+    ++p;
+    out = PosixRule{'n', 0, 0, 0, 7'200};
+    if (peek('M')) {
+      ++p;
+      out.kind = 'M';
+      if (!number(out.month, 2) || out.month < 1 || out.month > 12 ||
+          !peek('.'))
+        return false;
+      ++p;
+      if (!number(out.week, 1) || out.week < 1 || out.week > 5 || !peek('.'))
+        return false;
+      ++p;
+      if (!number(out.day, 1) || out.day > 6) return false;
+    } else {
+      if (peek('J')) ++p, out.kind = 'J';
+      if (!number(out.day, 3)) return false;
+      if (out.kind == 'J' ? out.day < 1 || out.day > 365 : out.day > 365)
+        return false;
+    }
+    if (peek('/')) {
+      ++p;
+      // Version 3 allows times from -167 to 167 hours.
+      if (!time(out.time, 167)) return false;
+    }
+    return true;
+  }
+};
+
+// Reads a POSIX TZ string. Its offsets are west of UTC, so they're negated.
+inline bool readPosixZone(const char* p, const char* end, PosixZone& out) {
+  PosixReader in{p, end};
+  out = PosixZone{};
+  if (!in.name() || !in.time(out.stdOffset, 24)) return false;
+  out.stdOffset = -out.stdOffset;
+  if (in.p != in.end) {
+    if (!in.name()) return false;
+    out.hasDst = true;
+    out.dstOffset = out.stdOffset + 3'600;
+    if (!in.peek(',')) {
+      if (!in.time(out.dstOffset, 24)) return false;
+      out.dstOffset = -out.dstOffset;
+    }
+    if (!in.rule(out.start) || !in.rule(out.end)) return false;
+  }
+  return in.p == in.end;
+}
+
+// Gets the days from 0001-01-01 to the day of a rule in the given year.
+constexpr int64_t posixRuleDay(const PosixRule& rule, int64_t year) noexcept {
+  int64_t january = daysFromCivil(year, 1, 1);
+  if (rule.kind == 'J')
+    return january + rule.day - 1 + (rule.day >= 60 && isLeapYear(year));
+  if (rule.kind == 'n') return january + rule.day;
+  // 0001-01-01 was a Monday, and POSIX counts the days of the week from
+  // Sunday, so adding 1 gives the remainder for the day of the week.
+  int64_t first = daysFromCivil(year, rule.month, 1);
+  int64_t day = first + (rule.day - (first + 1) % 7 + 7) % 7 +
+      7 * (rule.week - 1);
+  if (day >= first + daysInMonth(year, rule.month)) day -= 7;
+  return day;
+}
+
+using ZoneTransitions = std::vector<std::pair<int64_t, int32_t>>;
+} // namespace details
+
+// A time zone, from TZif data or a compiled image. An empty zone is UTC.
+//
+// Zones aren't copyable, since an image can be owned or only viewed, but they
+// can be moved. Looking up an offset doesn't change the zone, so one zone can
+// be shared between threads, each with its own ZoneCursor.
+class TimeZone {
+public:
+  TimeZone() noexcept = default;
+  TimeZone(const TimeZone&) = delete;
+  TimeZone& operator=(const TimeZone&) = delete;
+  TimeZone(TimeZone&& rhs) noexcept { *this = std::move(rhs); }
+
+  // Leaves the other zone as UTC.
+  TimeZone& operator=(TimeZone&& rhs) noexcept {
+    m_storage = std::move(rhs.m_storage);
+    m_image = std::exchange(rhs.m_image, nullptr);
+    m_size = std::exchange(rhs.m_size, 0);
+    m_header = std::exchange(rhs.m_header, details::ZoneImageHeader{});
+    m_at = std::exchange(rhs.m_at, nullptr);
+    m_buckets = std::exchange(rhs.m_buckets, nullptr);
+    m_offsets = std::exchange(rhs.m_offsets, nullptr);
+    return *this;
+  }
+
+  // Compiles TZif data, of any version.
+  ZoneError readTzif(const unsigned char* data, std::size_t size) {
+    using namespace details;
+    TzifReader in{data, data + size};
+    char version = 0;
+    TzifCounts counts{};
+    if (!readTzifHeader(in, version, counts)) return ZoneError::Format;
+    // Version 1 data has 32-bit times. Later versions repeat it, for old
+    // readers, then follow with 64-bit times and the rule.
+    int timeBytes = 4;
+    if (version >= '2') {
+      if (!in.has(counts.blockSize(4))) return ZoneError::Format;
+      in.p += counts.blockSize(4);
+      if (!readTzifHeader(in, version, counts)) return ZoneError::Format;
+      timeBytes = 8;
+    }
+    if (!in.has(counts.blockSize(timeBytes))) return ZoneError::Format;
+    if (counts.leap) return ZoneError::LeapSeconds;
+
+    // The transition times come first, then the types that they change to,
+    // then the types themselves.
+    const unsigned char* block = in.p;
+    TzifReader types{block + counts.time * (timeBytes + 1), in.end};
+    std::vector<int32_t> offsets(counts.type);
+    for (auto& offset : offsets) {
+      offset = static_cast<int32_t>(types.readSigned(4));
+      types.p += 2;
+    }
+    ZoneTransitions transitions;
+    transitions.reserve(counts.time);
+    TzifReader indices{block + counts.time * timeBytes, in.end};
+    for (uint64_t i = 0; i < counts.time; ++i) {
+      int64_t at = in.readSigned(timeBytes);
+      uint64_t type = indices.read(1);
+      // zic writes -2^59 for the beginning of time, and nothing is earlier.
+      if (type >= counts.type || at < -TzifMaxSeconds || at > TzifMaxSeconds)
+        return ZoneError::Format;
+      at += UnixEpochSeconds;
+      if (i && at <= transitions.back().first) return ZoneError::Format;
+      transitions.emplace_back(at, offsets[type]);
+    }
+
+    PosixZone rule{};
+    if (timeBytes == 8) {
+      in.p = block + counts.blockSize(8);
+      if (!in.has(1) || *in.p != '\n') return ZoneError::Format;
+      const auto* first = reinterpret_cast<const char*>(in.p + 1);
+      const auto* last = static_cast<const char*>(std::memchr(
+          first, '\n', static_cast<std::size_t>(in.end - in.p - 1)));
+      if (!last) return ZoneError::Format;
+      if (first != last && !readPosixZone(first, last, rule))
+        return ZoneError::Rule;
+    }
+    build(offsets[0], transitions, rule);
+    return ZoneError::None;
+  }
+
+  // Compiles a TZif file, such as /usr/share/zoneinfo/Europe/Paris.
+  ZoneError loadTzif(const std::string& path) {
+    std::vector<unsigned char> data;
+    if (!readFile(path, data)) return ZoneError::File;
+    return readTzif(data.data(), data.size());
+  }
+
+  // The compiled image, for writing to a file when building, to be viewed or
+  // loaded later. Empty for UTC.
+  const unsigned char* imageData() const noexcept { return m_image; }
+  std::size_t imageSize() const noexcept { return m_size; }
+
+  // Uses an image in place, such as one mapped from a file, without copying
+  // it. It must be aligned to 8 bytes and outlive the zone.
+  ZoneError viewImage(const void* data, std::size_t size) noexcept {
+    using namespace details;
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    ZoneImageHeader header{};
+    if (reinterpret_cast<std::uintptr_t>(data) % 8 ||
+        size < sizeof(header))
+      return ZoneError::Image;
+    std::memcpy(&header, bytes, sizeof(header));
+    if (std::memcmp(header.magic, ZoneImageMagic, sizeof(header.magic)) ||
+        !header.count || !header.bucketCount || header.bucketShift < 0 ||
+        header.bucketShift > 62 ||
+        size != imageBytes(header.count, header.bucketCount))
+      return ZoneError::Image;
+    const auto* at = reinterpret_cast<const int64_t*>(bytes + sizeof(header));
+    const auto* buckets = reinterpret_cast<const uint32_t*>(
+        bytes + sizeof(header) + header.count * 8);
+    for (uint32_t i = 1; i < header.count; ++i)
+      if (at[i] <= at[i - 1]) return ZoneError::Image;
+    for (uint32_t i = 0; i < header.bucketCount; ++i)
+      if (buckets[i] >= header.count) return ZoneError::Image;
+    if (header.cycleStart && (header.cycleEnd - header.cycleStart !=
+                                     ZoneCycleSeconds ||
+                                 header.cycleStart < at[0]))
+      return ZoneError::Image;
+
+    if (data != m_storage.data()) m_storage.clear();
+    m_image = bytes;
+    m_size = size;
+    m_header = header;
+    m_at = at;
+    m_buckets = buckets;
+    m_offsets = reinterpret_cast<const int32_t*>(
+        bytes + sizeof(header) + header.count * 8 +
+        padZoneImage(header.bucketCount * 4));
+    return ZoneError::None;
+  }
+
+  // Reads an image from a file and uses it.
+  ZoneError loadImage(const std::string& path) {
+    std::vector<unsigned char> data;
+    if (!readFile(path, data)) return ZoneError::File;
+    std::vector<uint64_t> storage((data.size() + 7) / 8);
+    std::memcpy(storage.data(), data.data(), data.size());
+    ZoneError error = viewImage(storage.data(), data.size());
+    if (error == ZoneError::None) m_storage = std::move(storage);
+    return error;
+  }
+
+  // Gets the offset at a second, in seconds east of UTC.
+  int32_t offset(UnitSeconds s) const noexcept {
+    UnitSeconds from = 0, until = 0;
+    return find(reduce(s), from, until);
+  }
+
+  template<typename Scalar>
+  Duration<> offset(const Moment<Scalar>& item) const noexcept {
+    UnitValue sss = item.value();
+    if (SecondsTraits<>::toCategory(sss.s) != Category::Num) return {};
+    return Duration<>(offset(details::floorSeconds(sss)));
+  }
+
+  // Gets the local time of a moment, as a moment, so that toCivil gives its
+  // local date and time of day.
+  template<typename Scalar>
+  Moment<Scalar> toLocal(const Moment<Scalar>& item) const noexcept {
+    return Moment<Scalar>(item + offset(item));
+  }
+
+  // Moves a second that's past the rule's cycle back into it, where the
+  // table has the same transitions, so that it can be looked up.
+  UnitSeconds reduce(UnitSeconds s) const noexcept {
+    if (!m_header.cycleStart || s < m_header.cycleEnd) return s;
+    return m_header.cycleStart +
+        (s - m_header.cycleStart) % details::ZoneCycleSeconds;
+  }
+
+  // Gets the offset at a second that's been reduced, along with the span of
+  // seconds, from and until, that it applies to.
+  int32_t find(UnitSeconds s, UnitSeconds& from, UnitSeconds& until) const
+      noexcept {
+    using T = SecondsTraits<>;
+    if (!m_header.count || s < m_at[0]) {
+      from = T::Min;
+      until = m_header.count ? m_at[0] : T::InfP;
+      return m_header.initialOffset;
+    }
+    auto bucket = (static_cast<uint64_t>(s) - static_cast<uint64_t>(m_at[0])) >>
+        m_header.bucketShift;
+    uint32_t i =
+        m_buckets[std::min<uint64_t>(bucket, m_header.bucketCount - 1)];
+    while (i + 1 < m_header.count && m_at[i + 1] <= s) ++i;
+    from = m_at[i];
+    until = i + 1 < m_header.count ? m_at[i + 1]
+        : m_header.cycleStart      ? m_header.cycleEnd
+                                   : T::InfP;
+    return m_offsets[i];
+  }
+
+private:
+  std::vector<uint64_t> m_storage;
+  const unsigned char* m_image = nullptr;
+  std::size_t m_size = 0;
+  details::ZoneImageHeader m_header{};
+  const int64_t* m_at = nullptr;
+  const uint32_t* m_buckets = nullptr;
+  const int32_t* m_offsets = nullptr;
+
+  static std::size_t imageBytes(std::size_t count, std::size_t buckets) {
+    using namespace details;
+    return sizeof(ZoneImageHeader) + count * 8 + padZoneImage(buckets * 4) +
+        padZoneImage(count * 4);
+  }
+
+  static bool readFile(const std::string& path,
+      std::vector<unsigned char>& data) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    data.assign(std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>());
+    return !file.bad();
+  }
+
+  // Expands the rule, if it has daylight saving time, and lays out the image.
+  void build(int32_t initialOffset, details::ZoneTransitions transitions,
+      const details::PosixZone& rule) {
+    using namespace details;
+    ZoneImageHeader header{};
+    std::memcpy(header.magic, ZoneImageMagic, sizeof(header.magic));
+    header.initialOffset = initialOffset;
+    if (rule.hasDst) {
+      // The cycle starts with the year after the last transition given, and
+      // the rule is expanded from the year before, so that the offset at the
+      // start of the cycle is known, whatever the time of day of the rule.
+      int64_t last = transitions.empty() ? UnixEpochSeconds
+                                         : transitions.back().first;
+      UnitSeconds rest = 0;
+      int64_t firstYear = civilFromDays(splitDays(last, rest)).year + 1;
+      header.cycleStart = daysFromCivil(firstYear, 1, 1) * SecondsPerDay;
+      header.cycleEnd = header.cycleStart + ZoneCycleSeconds;
+      ZoneTransitions expanded;
+      for (int64_t year = firstYear - 1; year <= firstYear + 400; ++year) {
+        expanded.emplace_back(posixRuleDay(rule.start, year) * SecondsPerDay +
+                rule.start.time - rule.stdOffset,
+            rule.dstOffset);
+        expanded.emplace_back(posixRuleDay(rule.end, year) * SecondsPerDay +
+                rule.end.time - rule.dstOffset,
+            rule.stdOffset);
+      }
+      std::sort(expanded.begin(), expanded.end());
+      for (const auto& [at, offset] : expanded) {
+        if ((transitions.empty() || at > transitions.back().first) &&
+            at < header.cycleEnd)
+          transitions.emplace_back(at, offset);
+      }
+    }
+
+    // Transitions that don't change the offset, such as those that only
+    // change the abbreviation, are dropped.
+    ZoneTransitions kept;
+    int32_t current = initialOffset;
+    for (const auto& [at, offset] : transitions) {
+      if (offset != current) kept.emplace_back(at, offset);
+      current = offset;
+    }
+    if (kept.empty()) {
+      // Keep one, so that the cycle has a transition to fall back to.
+      kept.emplace_back(header.cycleStart ? header.cycleStart : 0,
+          initialOffset);
+    }
+    if (header.cycleStart && kept.front().first > header.cycleStart)
+      header.cycleStart = header.cycleEnd = 0;
+
+    // Buckets are as fine as they can be with about one per transition, so
+    // that most lookups only compare against the next transition or two.
+    header.count = static_cast<uint32_t>(kept.size());
+    auto span = static_cast<uint64_t>(
+        (header.cycleStart ? header.cycleEnd : kept.back().first) -
+        kept.front().first);
+    while ((span >> header.bucketShift) >= header.count)
+      ++header.bucketShift;
+    header.bucketCount =
+        static_cast<uint32_t>((span >> header.bucketShift) + 1);
+
+    std::size_t size = imageBytes(header.count, header.bucketCount);
+    std::vector<uint64_t> storage(size / 8);
+    auto* bytes = reinterpret_cast<unsigned char*>(storage.data());
+    std::memcpy(bytes, &header, sizeof(header));
+    auto* at = reinterpret_cast<int64_t*>(bytes + sizeof(header));
+    auto* buckets = reinterpret_cast<uint32_t*>(at + header.count);
+    auto* offsets = reinterpret_cast<int32_t*>(
+        bytes + sizeof(header) + header.count * 8 +
+        padZoneImage(header.bucketCount * 4));
+    uint32_t i = 0;
+    for (uint32_t b = 0; b < header.bucketCount; ++b) {
+      int64_t start = kept.front().first +
+          static_cast<int64_t>(uint64_t{b} << header.bucketShift);
+      while (i + 1 < header.count && kept[i + 1].first <= start) ++i;
+      buckets[b] = i;
+    }
+    for (std::size_t k = 0; k < kept.size(); ++k) {
+      at[k] = kept[k].first;
+      offsets[k] = kept[k].second;
+    }
+    viewImage(bytes, size);
+    m_storage = std::move(storage);
+  }
+};
+
+// Remembers the span of the last offset it looked up, so that moments in time
+// order, as events usually are, only look up the zone when they cross a
+// transition. It's meant to be kept per thread, since it isn't safe to share.
+class ZoneCursor {
+public:
+  explicit ZoneCursor(const TimeZone& zone) noexcept : m_zone(&zone) {}
+
+  int32_t offset(UnitSeconds s) noexcept {
+    s = m_zone->reduce(s);
+    if (s < m_from || s >= m_until)
+      m_offset = m_zone->find(s, m_from, m_until);
+    return m_offset;
+  }
+
+  template<typename Scalar>
+  Duration<> offset(const Moment<Scalar>& item) noexcept {
+    UnitValue sss = item.value();
+    if (SecondsTraits<>::toCategory(sss.s) != Category::Num) return {};
+    return Duration<>(offset(details::floorSeconds(sss)));
+  }
+
+  template<typename Scalar>
+  Moment<Scalar> toLocal(const Moment<Scalar>& item) noexcept {
+    return Moment<Scalar>(item + offset(item));
+  }
+
+private:
+  const TimeZone* m_zone;
+  // Empty, so that the first lookup always goes to the zone.
+  UnitSeconds m_from = 1;
+  UnitSeconds m_until = 0;
+  int32_t m_offset = 0;
+};
+
+// Converts every moment of a column to local time, in place, as toLocal does.
+// Special values are unchanged, and local times past the range saturate.
+inline void toLocal(const TimeZone& zone, MomentColumn& column) noexcept {
+  using namespace details;
+  ZoneCursor cursor(zone);
+  UnitSeconds* s = column.seconds();
+  UnitPicos* ss = column.subseconds();
+  for (std::size_t i = 0; i < column.size(); ++i) {
+    if (SecondsTraits<>::toCategory(s[i]) != Category::Num) continue;
+    UnitValue sss{s[i], ss[i]};
+    UnitSeconds floor = floorSeconds(sss);
+    sss = shiftFloored(floor, sss.ss, cursor.offset(floor));
+    s[i] = sss.s, ss[i] = sss.ss;
+  }
+}
+
+} // namespace chronos
@@ -1,12 +1,13 @@
 #pragma once
 #include <array>
+#include <bit>
+#include <limits>
 #include <string>
 #include <ostream>
 #include <typeinfo>
+#include <type_traits>
 #include <utility>
-
-// TODO: ifdef for MSVC.
-#include <intrin.h>
+#include "WideMath.h"
 
 namespace chronos {
 // General utilities.
@@ -75,29 +76,46 @@ constexpr int64_t addCarry(int64_t a, int64_t b, int64_t& c) noexcept {
 // the high half. This makes it easy to check for whether the answer is too
 // large to fit entirely in cLo. But note that a negative result has a carry of
 // -1, not 0, due to sign extension.
-int64_t mul128(int64_t a, int64_t b, int64_t& cLo) {
-  // TODO: Implement this conditionally for various compilers. It would be nice
-  // if there were a way to make it constexpr without doing piecewise
-  // multiplication. Ditto for div128. We could use the code at
-  // https://bit.ly/2J1tZEc to do the multiplication in constexpr, but it would
-  // be substantially more expensive when it's done at runtime.
-  int64_t cHi;
-  cLo = _mul128(a, b, &cHi);
-  return cHi;
+//
+// In a constant expression, this uses the portable backend, which is exact but
+// slow, since the hardware backends can't be evaluated at compile time. At
+// runtime, it uses the native backend. See WideMath.h for details.
+constexpr int64_t mul128(int64_t a, int64_t b, int64_t& cLo) noexcept {
+  return WideAuto::mul(a, b, cLo);
 }
 
 // Divides the 128-bit value split between dividendHi and dividendLo by
 // divisor, setting quotient and returning the remainder. This makes it easy to
-// check for whether the dividend was a multiple of the divisor.
-int64_t div128(int64_t dividendHi, int64_t dividendLo, int64_t divisor,
-    int64_t& quotient) {
-  int64_t remainder;
-  quotient = _div128(dividendHi, dividendLo, divisor, &remainder);
-  return remainder;
+// check for whether the dividend was a multiple of the divisor. The quotient
+// must fit in 64 bits.
+//
+// Like mul128, this is exact in constant expressions and native at runtime.
+constexpr int64_t div128(int64_t dividendHi, int64_t dividendLo,
+    int64_t divisor, int64_t& quotient) noexcept {
+  return WideAuto::div(dividendHi, dividendLo, divisor, quotient);
 }
 
 using namespace std::string_view_literals;
 
+namespace details {
+// Whether to access multibyte values in memory a byte at a time. The compilers
+// don't reliably see through the portable loops, so they run only at compile
+// time or on big-endian targets. Elsewhere, a word is copied and swapped, or
+// not, as needed.
+constexpr bool useByteLoops() noexcept {
+  return std::is_constant_evaluated() ||
+      std::endian::native != std::endian::little;
+}
+
+// Every power of ten that fits in 64 bits.
+inline constexpr uint64_t PowersOfTen[] = {1, 10, 100, 1'000, 10'000,
+    100'000, 1'000'000, 10'000'000, 100'000'000, 1'000'000'000,
+    10'000'000'000, 100'000'000'000, 1'000'000'000'000, 10'000'000'000'000,
+    100'000'000'000'000, 1'000'000'000'000'000, 10'000'000'000'000'000,
+    100'000'000'000'000'000, 1'000'000'000'000'000'000,
+    10'000'000'000'000'000'000u};
+} // namespace details
+
 // Adapter to allow any dumpable object to be streamed out.
 template<typename Dumpable>
 inline auto operator<<(::std::ostream& os, const Dumpable& item)
@@ -131,8 +149,9 @@ inline auto operator<<(::std::ostream& os, const Stringable& item)
   return os << asString(item);
 }
 
-// MSVC mysteriously fails to support this predefined macro.
-#ifndef __PRETTY_FUNCTION__
+// MSVC mysteriously fails to support this predefined macro. Note that GCC and
+// Clang don't implement it as a macro, either, so it can't just be sniffed.
+#if defined(_MSC_VER) && !defined(__clang__) && !defined(__PRETTY_FUNCTION__)
 #define __PRETTY_FUNCTION__ __FUNCSIG__
 #endif
 
@@ -0,0 +1,425 @@
+#pragma once
+#include <cstdint>
+#include <bit>
+#include <compare>
+#include <type_traits>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace chronos {
+// Wide (128-bit) integer arithmetic.
+//
+// The scalar math only needs two wide operations: multiplying a pair of 64-bit
+// values into a 128-bit product, and dividing a 128-bit value by a 64-bit one.
+// Every compiler has its own way of getting at the hardware for these, so they
+// are wrapped up here as interchangeable backends. The best one for each
+// operation is selected at compile time, but all of them remain available by
+// name so that they can be tested and benchmarked against each other.
+//
+// All backends share the same contract:
+//
+// mul(a, b, lo) sets lo to the low half of a * b and returns the high half.
+// Note that a negative product has a high half of -1, not 0, due to sign
+// extension.
+//
+// div(hi, lo, d, q) sets q to hi:lo / d, truncated toward zero, and returns
+// the remainder, which takes the sign of the dividend. The quotient must fit
+// in 64 bits. The hardware backends trap when it doesn't, so callers must
+// ensure that it does, which typically means that hi:lo is the product of a
+// value whose magnitude is less than d.
+//
+// mulu and divu are the unsigned equivalents. For divu, the precondition
+// amounts to hi < d.
+enum class WideBackend { Portable, Int128, X64Asm, Msvc };
+
+template<WideBackend Backend>
+struct WideOps {
+  static constexpr bool available = false;
+};
+
+// Portable backend: piecewise 32-bit arithmetic. Works everywhere, including
+// in constant expressions, but costs several multiplies per product and
+// noticeably more per division.
+template<>
+struct WideOps<WideBackend::Portable> {
+  static constexpr bool available = true;
+
+  static constexpr uint64_t mulu(
+      uint64_t a, uint64_t b, uint64_t& lo) noexcept {
+    constexpr uint64_t mask = 0xFFFFFFFF;
+    uint64_t aLo = a & mask, aHi = a >> 32;
+    uint64_t bLo = b & mask, bHi = b >> 32;
+    uint64_t ll = aLo * bLo, lh = aLo * bHi, hl = aHi * bLo, hh = aHi * bHi;
+    // Sum the middle column, which can carry into the high half.
+    uint64_t mid = (ll >> 32) + (lh & mask) + (hl & mask);
+    lo = (mid << 32) | (ll & mask);
+    return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+  }
+
+  static constexpr int64_t mul(int64_t a, int64_t b, int64_t& lo) noexcept {
+    uint64_t uLo = 0;
+    uint64_t uHi =
+        mulu(static_cast<uint64_t>(a), static_cast<uint64_t>(b), uLo);
+    // The unsigned product treats a negative input as 2^64 too large, so take
+    // the other input back out of the high half.
+    if (a < 0) uHi -= static_cast<uint64_t>(b);
+    if (b < 0) uHi -= static_cast<uint64_t>(a);
+    lo = static_cast<int64_t>(uLo);
+    return static_cast<int64_t>(uHi);
+  }
+
+  // This is Knuth's Algorithm D specialized for a two-digit dividend and a
+  // one-digit divisor, in base 2^32. See divlu in Hacker's Delight.
+  static constexpr uint64_t divu(
+      uint64_t hi, uint64_t lo, uint64_t d, uint64_t& q) noexcept {
+    constexpr uint64_t base = uint64_t(1) << 32;
+    constexpr uint64_t mask = base - 1;
+    // Normalize so that the divisor's top bit is set.
+    int shift = std::countl_zero(d);
+    d <<= shift;
+    uint64_t un32 = shift ? (hi << shift) | (lo >> (64 - shift)) : hi;
+    uint64_t un10 = lo << shift;
+    uint64_t vn1 = d >> 32, vn0 = d & mask;
+    uint64_t un1 = un10 >> 32, un0 = un10 & mask;
+
+    // Estimate each quotient digit from the top digits, then correct it.
+    uint64_t q1 = un32 / vn1, rhat = un32 - q1 * vn1;
+    while (q1 >= base || q1 * vn0 > base * rhat + un1) {
+      --q1;
+      rhat += vn1;
+      if (rhat >= base) break;
+    }
+    uint64_t un21 = un32 * base + un1 - q1 * d;
+
+    uint64_t q0 = un21 / vn1;
+    rhat = un21 - q0 * vn1;
+    while (q0 >= base || q0 * vn0 > base * rhat + un0) {
+      --q0;
+      rhat += vn1;
+      if (rhat >= base) break;
+    }
+
+    q = q1 * base + q0;
+    return (un21 * base + un0 - q0 * d) >> shift;
+  }
+
+  static constexpr int64_t div(
+      int64_t hi, int64_t lo, int64_t d, int64_t& q) noexcept {
+    // Divide the magnitudes, then restore the signs.
+    bool nNeg(hi < 0), dNeg(d < 0);
+    uint64_t uHi = static_cast<uint64_t>(hi), uLo = static_cast<uint64_t>(lo);
+    if (nNeg) {
+      uLo = ~uLo + 1;
+      uHi = ~uHi + (uLo == 0);
+    }
+    uint64_t uD = static_cast<uint64_t>(d);
+    if (dNeg) uD = 0 - uD;
+    uint64_t uQ = 0, uR = divu(uHi, uLo, uD, uQ);
+    q = static_cast<int64_t>((nNeg != dNeg) ? 0 - uQ : uQ);
+    return static_cast<int64_t>(nNeg ? 0 - uR : uR);
+  }
+};
+
+#ifdef __SIZEOF_INT128__
+// Compiler-provided 128-bit integers, as in GCC and Clang. Multiplication
+// compiles down to a single instruction, and the compiler can see through it
+// to optimize. Division, however, becomes a call to a generic 128/128 routine
+// in the runtime library, which is much slower than the hardware divide.
+__extension__ typedef __int128 Int128;
+__extension__ typedef unsigned __int128 UInt128;
+
+template<>
+struct WideOps<WideBackend::Int128> {
+  static constexpr bool available = true;
+
+  static constexpr uint64_t mulu(
+      uint64_t a, uint64_t b, uint64_t& lo) noexcept {
+    UInt128 p = static_cast<UInt128>(a) * b;
+    lo = static_cast<uint64_t>(p);
+    return static_cast<uint64_t>(p >> 64);
+  }
+
+  static constexpr int64_t mul(int64_t a, int64_t b, int64_t& lo) noexcept {
+    Int128 p = static_cast<Int128>(a) * b;
+    lo = static_cast<int64_t>(p);
+    return static_cast<int64_t>(p >> 64);
+  }
+
+  static constexpr uint64_t divu(
+      uint64_t hi, uint64_t lo, uint64_t d, uint64_t& q) noexcept {
+    UInt128 n = (static_cast<UInt128>(hi) << 64) | lo;
+    q = static_cast<uint64_t>(n / d);
+    return static_cast<uint64_t>(n % d);
+  }
+
+  static constexpr int64_t div(
+      int64_t hi, int64_t lo, int64_t d, int64_t& q) noexcept {
+    Int128 n = static_cast<Int128>(
+        (static_cast<UInt128>(static_cast<uint64_t>(hi)) << 64) |
+        static_cast<uint64_t>(lo));
+    q = static_cast<int64_t>(n / d);
+    return static_cast<int64_t>(n % d);
+  }
+};
+#endif
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+// Inline assembly for x86-64 with GCC-style compilers. The point of this is
+// mostly division, since it reaches the single hardware divide that the
+// compiler won't emit for 128-bit operands. For unsigned products, mulx is
+// used when BMI2 is enabled, as it leaves the flags alone and lets the
+// register allocator pick the outputs.
+template<>
+struct WideOps<WideBackend::X64Asm> {
+  static constexpr bool available = true;
+
+  static inline uint64_t mulu(uint64_t a, uint64_t b, uint64_t& lo) noexcept {
+    uint64_t hi;
+#ifdef __BMI2__
+    __asm__("mulxq %3, %0, %1" : "=r"(lo), "=r"(hi) : "d"(a), "rm"(b));
+#else
+    __asm__("mulq %3" : "=a"(lo), "=d"(hi) : "a"(a), "rm"(b) : "cc");
+#endif
+    return hi;
+  }
+
+  static inline int64_t mul(int64_t a, int64_t b, int64_t& lo) noexcept {
+    int64_t hi;
+    __asm__("imulq %3" : "=a"(lo), "=d"(hi) : "a"(a), "rm"(b) : "cc");
+    return hi;
+  }
+
+  static inline uint64_t divu(
+      uint64_t hi, uint64_t lo, uint64_t d, uint64_t& q) noexcept {
+    uint64_t r;
+    __asm__("divq %4" : "=a"(q), "=d"(r) : "a"(lo), "d"(hi), "rm"(d) : "cc");
+    return r;
+  }
+
+  static inline int64_t div(
+      int64_t hi, int64_t lo, int64_t d, int64_t& q) noexcept {
+    int64_t r;
+    __asm__("idivq %4" : "=a"(q), "=d"(r) : "a"(lo), "d"(hi), "rm"(d) : "cc");
+    return r;
+  }
+};
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64) && !defined(__clang__)
+// MSVC intrinsics for x64.
+template<>
+struct WideOps<WideBackend::Msvc> {
+  static constexpr bool available = true;
+
+  static inline uint64_t mulu(uint64_t a, uint64_t b, uint64_t& lo) noexcept {
+    uint64_t hi;
+    lo = _umul128(a, b, &hi);
+    return hi;
+  }
+
+  static inline int64_t mul(int64_t a, int64_t b, int64_t& lo) noexcept {
+    int64_t hi;
+    lo = _mul128(a, b, &hi);
+    return hi;
+  }
+
+  static inline uint64_t divu(
+      uint64_t hi, uint64_t lo, uint64_t d, uint64_t& q) noexcept {
+    uint64_t r;
+    q = _udiv128(hi, lo, d, &r);
+    return r;
+  }
+
+  static inline int64_t div(
+      int64_t hi, int64_t lo, int64_t d, int64_t& q) noexcept {
+    int64_t r;
+    q = _div128(hi, lo, d, &r);
+    return r;
+  }
+};
+#endif
+
+// The backends chosen for this platform. They can differ by operation: with
+// GCC or Clang on x86-64, the compiler's own 128-bit multiply is as good as
+// anything, but its division is not.
+constexpr const WideBackend NativeMulBackend =
+    WideOps<WideBackend::Msvc>::available     ? WideBackend::Msvc
+    : WideOps<WideBackend::Int128>::available ? WideBackend::Int128
+    : WideOps<WideBackend::X64Asm>::available ? WideBackend::X64Asm
+                                              : WideBackend::Portable;
+
+constexpr const WideBackend NativeDivBackend =
+    WideOps<WideBackend::Msvc>::available     ? WideBackend::Msvc
+    : WideOps<WideBackend::X64Asm>::available ? WideBackend::X64Asm
+    : WideOps<WideBackend::Int128>::available ? WideBackend::Int128
+                                              : WideBackend::Portable;
+
+using NativeMul = WideOps<NativeMulBackend>;
+using NativeDiv = WideOps<NativeDivBackend>;
+
+// Uses the portable backend in constant expressions, since the hardware
+// backends can't be evaluated at compile time, and the native ones otherwise.
+struct WideAuto {
+  using Portable = WideOps<WideBackend::Portable>;
+
+  static constexpr uint64_t mulu(
+      uint64_t a, uint64_t b, uint64_t& lo) noexcept {
+    if (std::is_constant_evaluated()) return Portable::mulu(a, b, lo);
+    return NativeMul::mulu(a, b, lo);
+  }
+
+  static constexpr int64_t mul(int64_t a, int64_t b, int64_t& lo) noexcept {
+    if (std::is_constant_evaluated()) return Portable::mul(a, b, lo);
+    return NativeMul::mul(a, b, lo);
+  }
+
+  static constexpr uint64_t divu(
+      uint64_t hi, uint64_t lo, uint64_t d, uint64_t& q) noexcept {
+    if (std::is_constant_evaluated()) return Portable::divu(hi, lo, d, q);
+    return NativeDiv::divu(hi, lo, d, q);
+  }
+
+  static constexpr int64_t div(
+      int64_t hi, int64_t lo, int64_t d, int64_t& q) noexcept {
+    if (std::is_constant_evaluated()) return Portable::div(hi, lo, d, q);
+    return NativeDiv::div(hi, lo, d, q);
+  }
+};
+
+// Unsigned 128-bit value, as a pair of halves, for code that has to carry a
+// wide value around instead of just producing one.
+struct WidePair {
+  uint64_t hi;
+  uint64_t lo;
+
+  constexpr auto operator<=>(const WidePair&) const noexcept = default;
+};
+
+constexpr WidePair wideMul(uint64_t a, uint64_t b) noexcept {
+  WidePair p{};
+  p.hi = WideAuto::mulu(a, b, p.lo);
+  return p;
+}
+
+constexpr WidePair wideAdd(WidePair a, WidePair b) noexcept {
+  uint64_t lo = a.lo + b.lo;
+  return WidePair{a.hi + b.hi + (lo < a.lo), lo};
+}
+
+constexpr WidePair wideSub(WidePair a, WidePair b) noexcept {
+  return WidePair{a.hi - b.hi - (a.lo < b.lo), a.lo - b.lo};
+}
+
+// Divides n by d, which must not be zero, setting r to the remainder and
+// returning the quotient.
+constexpr WidePair wideDiv(WidePair n, WidePair d, WidePair& r) noexcept {
+  if (!d.hi) {
+    // Long division by a single digit, where the first step can't overflow.
+    WidePair q{n.hi / d.lo, 0};
+    r = WidePair{0, WideAuto::divu(n.hi % d.lo, n.lo, d.lo, q.lo)};
+    return q;
+  }
+
+  // The quotient fits in one digit, so estimate it by dividing by the top
+  // digit of the divisor, then correct. See divlu in Hacker's Delight.
+  int shift = std::countl_zero(d.hi);
+  uint64_t dTop = shift ? (d.hi << shift) | (d.lo >> (64 - shift)) : d.hi;
+  uint64_t q = 0;
+  WideAuto::divu(n.hi >> 1, (n.hi << 63) | (n.lo >> 1), dTop, q);
+  q >>= 63 - shift;
+  if (q) --q;
+  WidePair qd = wideMul(q, d.lo);
+  qd.hi += q * d.hi;
+  r = wideSub(n, qd);
+  if (r >= d) {
+    ++q;
+    r = wideSub(r, d);
+  }
+  return WidePair{0, q};
+}
+
+// Division by an invariant divisor.
+//
+// Dividing by the same value over and over is common enough, and the hardware
+// divide slow enough, that it pays to precompute a reciprocal once and then
+// divide with a couple of multiplies. This is the 2-by-1 division from Moller
+// and Granlund, "Improved division by invariant integers".
+//
+// The divisor must not be zero. Construction costs a full division, so it
+// should be done ahead of time, ideally as a constexpr.
+class WideDivisor {
+public:
+  constexpr explicit WideDivisor(uint64_t d) noexcept
+      : m_shift(std::countl_zero(d)), m_norm(d << m_shift),
+        m_recip(calcRecip(m_norm)) {}
+
+  constexpr uint64_t divisor() const noexcept { return m_norm >> m_shift; }
+
+  // Divides hi:lo, setting q to the quotient and returning the remainder. As
+  // with divu, the quotient must fit, so hi must be less than the divisor.
+  constexpr uint64_t divu(uint64_t hi, uint64_t lo, uint64_t& q) const
+      noexcept {
+    uint64_t u1 = m_shift ? (hi << m_shift) | (lo >> (64 - m_shift)) : hi;
+    return div2by1(u1, lo << m_shift, q) >> m_shift;
+  }
+
+  // Divides n with no restriction on the size of the quotient, setting r to
+  // the remainder and returning the quotient.
+  constexpr WidePair divu(WidePair n, uint64_t& r) const noexcept {
+    uint64_t u2 = m_shift ? n.hi >> (64 - m_shift) : 0;
+    uint64_t u1 = m_shift ? (n.hi << m_shift) | (n.lo >> (64 - m_shift)) : n.hi;
+    WidePair q{};
+    uint64_t rem = div2by1(u2, u1, q.hi);
+    r = div2by1(rem, n.lo << m_shift, q.lo) >> m_shift;
+    return q;
+  }
+
+  // Signed equivalent of divu, with the same contract as WideOps::div, except
+  // that the divisor is always positive.
+  constexpr int64_t div(int64_t hi, int64_t lo, int64_t& q) const noexcept {
+    bool neg(hi < 0);
+    uint64_t uHi = static_cast<uint64_t>(hi), uLo = static_cast<uint64_t>(lo);
+    if (neg) {
+      uLo = ~uLo + 1;
+      uHi = ~uHi + (uLo == 0);
+    }
+    uint64_t uQ = 0, uR = divu(uHi, uLo, uQ);
+    q = static_cast<int64_t>(neg ? 0 - uQ : uQ);
+    return static_cast<int64_t>(neg ? 0 - uR : uR);
+  }
+
+private:
+  int m_shift;
+  uint64_t m_norm;
+  uint64_t m_recip;
+
+  // The reciprocal is floor((2^128 - 1) / d) - 2^64, for normalized d.
+  static constexpr uint64_t calcRecip(uint64_t d) noexcept {
+    uint64_t q = 0;
+    WideAuto::divu(~d, ~uint64_t(0), d, q);
+    return q;
+  }
+
+  // Divides u1:u0 by the normalized divisor, where u1 is less than it.
+  constexpr uint64_t div2by1(uint64_t u1, uint64_t u0, uint64_t& q) const
+      noexcept {
+    WidePair est = wideAdd(wideMul(m_recip, u1), WidePair{u1, u0});
+    uint64_t q1 = est.hi + 1;
+    uint64_t r = u0 - q1 * m_norm;
+    // The estimate is at most one too high or one too low.
+    if (r > est.lo) {
+      --q1;
+      r += m_norm;
+    }
+    if (r >= m_norm) {
+      ++q1;
+      r -= m_norm;
+    }
+    q = q1;
+    return r;
+  }
+};
+
+} // namespace chronos
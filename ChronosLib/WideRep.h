@@ -0,0 +1,323 @@
+#pragma once
+#include "ScalarUnit.h"
+
+namespace chronos {
+namespace details {
+// Representation of linear time as a single signed 128-bit count of
+// picoseconds.
+//
+// CanonRep keeps seconds and subseconds apart, so adding two values means
+// carrying and borrowing between them and then renormalizing. Here, there is
+// no fixed point to carry across: adding is one wide add and comparing is one
+// wide compare. The seconds and picoseconds are only split apart, with a
+// multiply by a precomputed reciprocal, when they're asked for.
+//
+// The numeric range is the same as the default, in that the seconds are kept
+// within SecondsTraits<>, so the magnitude of the count is at most MaxCount.
+// The special values are the extremes of the 128-bit range, just as
+// SecondsTraits would define them for a 128-bit type: the maximum is positive
+// infinity, its negation is negative infinity, and the minimum is NaN. These
+// sort the same way as the values they stand for, so the raw count compares
+// correctly for everything but NaN.
+//
+// The count is stored as two's-complement halves, so that this works without
+// compiler support for 128-bit integers. Where there is such support, the
+// arithmetic goes through it.
+class Picos128Rep {
+public:
+  using HighT = int64_t;
+  using LowT = uint64_t;
+  using Traits = SecondsTraits<>;
+  static constexpr const bool rawComparable = true;
+
+  constexpr Picos128Rep() noexcept : m_lo(0), m_hi(0) {}
+  constexpr Picos128Rep(HighT hi, LowT lo) noexcept : m_lo(lo), m_hi(hi) {}
+  constexpr explicit Picos128Rep(WidePair count) noexcept
+      : m_lo(count.lo), m_hi(static_cast<HighT>(count.hi)) {}
+
+  constexpr HighT high() const noexcept { return m_hi; }
+  constexpr LowT low() const noexcept { return m_lo; }
+
+  constexpr WidePair count() const noexcept {
+    return WidePair{static_cast<uint64_t>(m_hi), m_lo};
+  }
+
+  // The special values.
+  static constexpr Picos128Rep infP() noexcept {
+    return Picos128Rep(std::numeric_limits<HighT>::max(), ~LowT(0));
+  }
+  static constexpr Picos128Rep infN() noexcept {
+    return Picos128Rep(std::numeric_limits<HighT>::min(), 1);
+  }
+  static constexpr Picos128Rep nan() noexcept {
+    return Picos128Rep(std::numeric_limits<HighT>::min(), 0);
+  }
+
+  // The largest numeric count, one picosecond short of a second past Max.
+  static constexpr const WidePair MaxCount = wideSub(
+      wideMul(Traits::Max + 1, PicosPerSecond), WidePair{0, 1});
+
+  // Whether the count is numeric. Biasing by MaxCount maps the numeric range
+  // onto [0, 2 * MaxCount], so this is one unsigned compare.
+  constexpr bool isNumber() const noexcept {
+    return wideAdd(count(), MaxCount) <= wideAdd(MaxCount, MaxCount);
+  }
+
+  // Wrapping arithmetic and plain ordering on the raw counts. Callers are
+  // responsible for range and for NaN.
+  friend constexpr Picos128Rep operator+(
+      const Picos128Rep& lhs, const Picos128Rep& rhs) noexcept {
+#ifdef __SIZEOF_INT128__
+    if (!std::is_constant_evaluated())
+      return fromWide(toWideU(lhs) + toWideU(rhs));
+#endif
+    return Picos128Rep(wideAdd(lhs.count(), rhs.count()));
+  }
+
+  friend constexpr Picos128Rep operator-(
+      const Picos128Rep& lhs, const Picos128Rep& rhs) noexcept {
+#ifdef __SIZEOF_INT128__
+    if (!std::is_constant_evaluated())
+      return fromWide(toWideU(lhs) - toWideU(rhs));
+#endif
+    return Picos128Rep(wideSub(lhs.count(), rhs.count()));
+  }
+
+  friend constexpr std::strong_ordering operator<=>(
+      const Picos128Rep& lhs, const Picos128Rep& rhs) noexcept {
+#ifdef __SIZEOF_INT128__
+    // Spelled as a difference of flags so that, once inlined into a relational
+    // operator, it folds down to a single flag, rather than a chain of
+    // branches.
+    if (!std::is_constant_evaluated()) {
+      Int128 l = toWide(lhs), r = toWide(rhs);
+      return ((l > r) - (l < r)) <=> 0;
+    }
+#endif
+    if (auto cmp = lhs.m_hi <=> rhs.m_hi; cmp != 0) return cmp;
+    return lhs.m_lo <=> rhs.m_lo;
+  }
+
+  friend constexpr bool operator==(
+      const Picos128Rep& lhs, const Picos128Rep& rhs) noexcept {
+    return lhs.m_hi == rhs.m_hi && lhs.m_lo == rhs.m_lo;
+  }
+
+  auto dump(std::ostream& os) const -> decltype(os) {
+    auto flagScope = StreamFlagsGuard(os, std::ios::hex);
+    return os << m_hi << "." << m_lo << " <" << sizeof(*this) << ">";
+  }
+
+private:
+  // Fields, least significant first.
+  LowT m_lo;
+  HighT m_hi;
+
+#ifdef __SIZEOF_INT128__
+  // The arithmetic is unsigned so that it wraps instead of overflowing.
+  static constexpr UInt128 toWideU(const Picos128Rep& rep) noexcept {
+    return (static_cast<UInt128>(static_cast<uint64_t>(rep.m_hi)) << 64) |
+        rep.m_lo;
+  }
+
+  static constexpr Int128 toWide(const Picos128Rep& rep) noexcept {
+    return static_cast<Int128>(toWideU(rep));
+  }
+
+  static constexpr Picos128Rep fromWide(UInt128 count) noexcept {
+    return Picos128Rep(static_cast<HighT>(count >> 64),
+        static_cast<LowT>(count));
+  }
+#endif
+};
+
+} // namespace details
+
+// Adapter for the 128-bit picosecond representation.
+//
+// Besides the usual accessors, this offers tryAdd, trySub, and compare, which
+// ScalarUnit uses in place of its general code when both sides share this
+// representation.
+template<>
+struct RepAdapter<details::Picos128Rep> {
+  using Traits = SecondsTraits<>;
+  using RepT = details::Picos128Rep;
+  using RepLimits = std::numeric_limits<RepT>;
+  using WholesT = RepT::HighT;
+  using FractionsT = RepT::LowT;
+
+  RepT m_rep;
+
+  constexpr RepAdapter() noexcept : m_rep() {}
+  explicit constexpr RepAdapter(const UnitValue& sss) noexcept
+      : m_rep(create(sss.s, sss.ss)) {}
+  explicit constexpr RepAdapter(const RepT& rep) noexcept : m_rep(rep) {}
+  constexpr RepAdapter(UnitSeconds s, UnitPicos ss) noexcept
+      : m_rep(create(s, ss)) {}
+  constexpr RepAdapter(const RepAdapter&) noexcept = default;
+
+  constexpr RepAdapter& operator=(const RepAdapter&) noexcept = default;
+
+  constexpr UnitSeconds seconds() const noexcept { return value().s; }
+  constexpr void seconds(UnitSeconds s) noexcept {
+    m_rep = create(s, subseconds());
+  }
+
+  constexpr UnitPicos subseconds() const noexcept { return value().ss; }
+  constexpr void subseconds(UnitPicos ss) noexcept {
+    m_rep = create(seconds(), ss);
+  }
+
+  constexpr UnitValue value() const noexcept {
+    WholesT hi = m_rep.high();
+    // Only the special values reach the extremes of the high half.
+    if (hi == std::numeric_limits<WholesT>::max())
+      return UnitValue{Traits::InfP, 0};
+    if (hi == std::numeric_limits<WholesT>::min())
+      return UnitValue{m_rep.low() ? Traits::InfN : Traits::NaN, 0};
+    // Divide the magnitude, then negate both parts if the count was negative.
+    // The magnitude is under PicosPerSecond * 2^63, so the quotient fits.
+    auto mask = static_cast<uint64_t>(hi >> 63);
+    WidePair count = m_rep.count();
+    WidePair mag = wideSub(
+        WidePair{count.hi ^ mask, count.lo ^ mask}, WidePair{mask, mask});
+    uint64_t s = 0;
+    uint64_t ss = PicosPerSecondDivisor.divu(mag.hi, mag.lo, s);
+    return UnitValue{static_cast<UnitSeconds>((s ^ mask) - mask),
+        static_cast<UnitPicos>((ss ^ mask) - mask)};
+  }
+  constexpr void value(const UnitValue& sss) noexcept {
+    m_rep = create(sss.s, sss.ss);
+  }
+  constexpr void value(UnitSeconds s, UnitPicos ss) noexcept {
+    m_rep = create(s, ss);
+  }
+
+  constexpr bool isNegative() const noexcept { return m_rep.high() < 0; }
+
+  constexpr void category(Category cat) noexcept {
+    switch (cat) {
+    case Category::Num: m_rep = RepT(); break;
+    case Category::NaN: m_rep = RepT::nan(); break;
+    case Category::InfN: m_rep = RepT::infN(); break;
+    case Category::InfP: m_rep = RepT::infP(); break;
+    }
+  }
+
+  // Adds rhs, but only when both sides and the sum are numbers. Otherwise,
+  // returns false without changing anything, so that the caller can apply the
+  // general rules for special values and saturation. The three checks are
+  // combined so that there's just the one branch.
+  constexpr bool tryAdd(const RepAdapter& rhs) noexcept {
+    RepT sum = m_rep + rhs.m_rep;
+    if (!(m_rep.isNumber() & rhs.m_rep.isNumber() & sum.isNumber()))
+      return false;
+    m_rep = sum;
+    return true;
+  }
+
+  // Subtracts rhs, as with tryAdd.
+  constexpr bool trySub(const RepAdapter& rhs) noexcept {
+    RepT diff = m_rep - rhs.m_rep;
+    if (!(m_rep.isNumber() & rhs.m_rep.isNumber() & diff.isNumber()))
+      return false;
+    m_rep = diff;
+    return true;
+  }
+
+  // Compares with the same results as ScalarUnit, where NaN on either side
+  // compares as greater.
+  constexpr std::partial_ordering compare(const RepAdapter& rhs) const
+      noexcept {
+    if ((m_rep == RepT::nan()) | (rhs.m_rep == RepT::nan())) return 1 <=> 0;
+    return m_rep <=> rhs.m_rep;
+  }
+
+  auto dump(std::ostream& os) const -> decltype(os) { return m_rep.dump(os); }
+
+private:
+  // Creates the count, with the same sign rules as CanonRep. Excess
+  // subseconds need no special handling, as the count is wide enough to just
+  // absorb them.
+  static constexpr RepT create(UnitSeconds s, UnitPicos ss) noexcept {
+    if (s < 0 && ss > 0)
+      ss = -ss;
+    else if (s > 0 && ss < 0)
+      s = Traits::NaN;
+    if (s == Traits::NaN) return RepT::nan();
+    if (s > Traits::Max) return RepT::infP();
+    if (s < Traits::Min) return RepT::infN();
+
+    int64_t lo, hi = mul128(s, PicosPerSecond, lo);
+    RepT count(wideAdd(
+        WidePair{static_cast<uint64_t>(hi), static_cast<uint64_t>(lo)},
+        WidePair{ss < 0 ? ~uint64_t(0) : 0, static_cast<uint64_t>(ss)}));
+    if (count.isNumber()) return count;
+    return (count.high() < 0) ? RepT::infN() : RepT::infP();
+  }
+};
+
+namespace details {
+using Picos128ScalarUnit = ScalarUnit<Picos128Rep>;
+} // namespace details
+} // namespace chronos
+
+template<>
+class std::numeric_limits<chronos::details::Picos128Rep> {
+public:
+  using RepT = chronos::details::Picos128Rep;
+
+  [[nodiscard]] static constexpr RepT(min)() noexcept {
+    return RepT(chronos::wideSub(chronos::WidePair{}, RepT::MaxCount));
+  }
+
+  [[nodiscard]] static constexpr RepT(max)() noexcept {
+    return RepT(RepT::MaxCount);
+  }
+
+  [[nodiscard]] static constexpr RepT lowest() noexcept { return (min)(); }
+
+  [[nodiscard]] static constexpr RepT epsilon() noexcept { return RepT(0, 1); }
+
+  [[nodiscard]] static constexpr RepT round_error() noexcept {
+    return (epsilon)();
+  }
+
+  [[nodiscard]] static constexpr RepT denorm_min() noexcept { return RepT(); }
+
+  [[nodiscard]] static constexpr RepT infinity() noexcept {
+    return RepT::infP();
+  }
+
+  [[nodiscard]] static constexpr RepT quiet_NaN() noexcept {
+    return RepT::nan();
+  }
+
+  [[nodiscard]] static constexpr RepT signaling_NaN() noexcept {
+    return (quiet_NaN)();
+  }
+
+  static constexpr float_denorm_style has_denorm = denorm_absent;
+  static constexpr bool has_denorm_loss = false;
+  static constexpr bool has_infinity = true;
+  static constexpr bool has_quiet_NaN = true;
+  static constexpr bool has_signaling_NaN = false;
+  static constexpr bool is_bounded = true;
+  static constexpr bool is_exact = true;
+  static constexpr bool is_iec559 = false;
+  static constexpr bool is_integer = false;
+  static constexpr bool is_modulo = false;
+  static constexpr bool is_signed = true;
+  static constexpr bool is_specialized = true;
+  static constexpr bool tinyness_before = false;
+  static constexpr bool traps = false;
+  static constexpr float_round_style round_style = round_toward_zero;
+  static constexpr int digits = 102;
+  static constexpr int digits10 = 30;
+  static constexpr int max_digits10 = 31;
+  static constexpr int max_exponent = 0;
+  static constexpr int max_exponent10 = 0;
+  static constexpr int min_exponent = 0;
+  static constexpr int min_exponent10 = 0;
+  static constexpr int radix = 2;
+};
@@ -0,0 +1,1102 @@
+#include "pch.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include "../ChronosLib/Moment.h"
+#include "../ChronosLib/WideRep.h"
+#include "../ChronosLib/Column.h"
+#include "../ChronosLib/KeyEncoding.h"
+#include "../ChronosLib/Sort.h"
+#include "../ChronosLib/Hash.h"
+#include "../ChronosLib/Parse.h"
+#include "../ChronosLib/Format.h"
+#include "../ChronosLib/Civil.h"
+#include "../ChronosLib/Calendar.h"
+#include "../ChronosLib/TimeZone.h"
+#include "../ChronosLib/LeapSeconds.h"
+#include "../ChronosLib/Clock.h"
+#include "../ChronosLib/CoarseClock.h"
+#include "../ChronosLib/Interop.h"
+
+using namespace std;
+using namespace chronos;
+
+// Microbenchmarks.
+//
+// These are disabled by default, since their output is only interesting when
+// someone is looking at it, and they take long enough to get in the way of the
+// unit tests. Run them in a release build with:
+//
+//   --gtest_also_run_disabled_tests --gtest_filter=*ChronosBench*
+//
+// Each benchmark also checks that the variants it compares agree, both so that
+// the work can't be optimized away and so that a fast but wrong variant can't
+// pass unnoticed.
+
+namespace {
+constexpr size_t BenchCount = 1 << 20;
+constexpr int BenchReps = 8;
+
+// Runs the body BenchReps times over BenchCount items, then reports the best
+// time per item, which is the least noisy.
+template<typename Body>
+double bench(const char* label, Body&& body) {
+  double best = 0;
+  for (int rep = 0; rep < BenchReps; ++rep) {
+    auto start = chrono::steady_clock::now();
+    body();
+    chrono::duration<double, nano> elapsed =
+        chrono::steady_clock::now() - start;
+    double ns = elapsed.count() / BenchCount;
+    if (!rep || ns < best) best = ns;
+  }
+  cout << "  " << label << ": " << best << " ns/op" << endl;
+  return best;
+}
+
+// Keeps a result alive, as if whatever it's in memory were read by code the
+// compiler can't see, so the work that produced it can't be elided.
+template<typename T>
+void consume(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "g"(&value) : "memory");
+#else
+  static const void* volatile sink;
+  sink = &value;
+  _ReadWriteBarrier();
+#endif
+}
+
+// Durations under a second or so, with factors small enough that most
+// products stay in range, as is typical when scaling timeouts and intervals.
+vector<pair<UnitValue, int64_t>> makeMulWorkload() {
+  mt19937_64 gen(42);
+  uniform_int_distribution<int64_t> secs(-1'000'000, 1'000'000);
+  uniform_int_distribution<int64_t> picos(0, PicosPerSecond - 1);
+  uniform_int_distribution<int64_t> factor(-1'000'000'000, 1'000'000'000);
+  vector<pair<UnitValue, int64_t>> work(BenchCount);
+  for (auto& [sss, m] : work) {
+    sss.s = secs(gen);
+    sss.ss = (sss.s < 0) ? -picos(gen) : picos(gen);
+    m = factor(gen);
+  }
+  return work;
+}
+
+// The arithmetic core of ScalarUnit::operator*=, with the backend as a
+// parameter instead of fixed by the platform.
+template<WideBackend Backend>
+UnitValue mulWith(UnitValue sss, int64_t m) {
+  using Ops = WideOps<Backend>;
+  int64_t s = sss.s, ss = sss.ss, quot, lo, hi;
+  bool outNeg((s < 0) != (m < 0));
+  if (s && Ops::mul(s, m, s) != (outNeg ? -1 : 0))
+    return UnitValue{outNeg ? SecondsTraits<>::InfN : SecondsTraits<>::InfP, 0};
+  hi = Ops::mul(ss, m, lo);
+  ss = Ops::div(hi, lo, PicosPerSecond, quot);
+  return UnitValue{s + quot, ss};
+}
+
+template<WideBackend Backend>
+void benchMulWith(const char* label,
+    const vector<pair<UnitValue, int64_t>>& work,
+    const vector<UnitValue>& expected) {
+  if constexpr (WideOps<Backend>::available) {
+    vector<UnitValue> out(work.size());
+    bench(label, [&] {
+      for (size_t i = 0; i < work.size(); ++i)
+        out[i] = mulWith<Backend>(work[i].first, work[i].second);
+      consume(out);
+    });
+    EXPECT_EQ(out, expected);
+  }
+}
+} // namespace
+
+TEST(Mul128, DISABLED_ChronosBench) {
+  const auto work = makeMulWorkload();
+  vector<Duration<>> out(work.size());
+  cout << "Duration::operator*=" << endl;
+  bench("native", [&] {
+    for (size_t i = 0; i < work.size(); ++i) {
+      out[i] = Duration<>(work[i].first);
+      out[i] *= work[i].second;
+    }
+    consume(out);
+  });
+
+  vector<UnitValue> expected(work.size());
+  for (size_t i = 0; i < work.size(); ++i) expected[i] = out[i].value();
+  benchMulWith<WideBackend::Portable>("portable", work, expected);
+  benchMulWith<WideBackend::Int128>("int128", work, expected);
+  benchMulWith<WideBackend::X64Asm>("x64asm", work, expected);
+  benchMulWith<WideBackend::Msvc>("msvc", work, expected);
+}
+
+TEST(DurationDivisor, DISABLED_ChronosBench) {
+  // Bucket arbitrary durations of up to a day into 250 ms widths.
+  mt19937_64 gen(42);
+  uniform_int_distribution<int64_t> secs(0, SecondsPerDay);
+  uniform_int_distribution<int64_t> picos(0, PicosPerSecond - 1);
+  vector<Duration<>> work(BenchCount);
+  for (auto& d : work) d = Duration<>(secs(gen), picos(gen));
+  const Duration<> width(0, 250, 1000);
+
+  vector<UnitSeconds> expected(work.size()), out(work.size());
+  cout << "Duration / Duration" << endl;
+  bench("general", [&] {
+    for (size_t i = 0; i < work.size(); ++i) expected[i] = work[i] / width;
+    consume(expected);
+  });
+  const DurationDivisor<> divisor(width);
+  bench("invariant", [&] {
+    for (size_t i = 0; i < work.size(); ++i) out[i] = divisor.count(work[i]);
+    consume(out);
+  });
+  EXPECT_EQ(out, expected);
+}
+
+namespace {
+// Sums and counts in-order pairs over a workload of durations, so that both
+// addition and comparison are exercised.
+template<typename Unit>
+void benchAddCompare(const char* label, const vector<UnitValue>& values,
+    UnitValue& total, size_t& ordered) {
+  vector<Duration<Unit>> work(values.size());
+  for (size_t i = 0; i < values.size(); ++i)
+    work[i] = Duration<Unit>(values[i]);
+  cout << label << endl;
+  bench("add", [&] {
+    Duration<Unit> sum;
+    for (const auto& d : work) sum += d;
+    consume(sum);
+    total = sum.value();
+  });
+  bench("compare", [&] {
+    size_t count = 0;
+    for (size_t i = 1; i < work.size(); ++i) count += work[i - 1] < work[i];
+    consume(count);
+    ordered = count;
+  });
+}
+} // namespace
+
+TEST(Picos128Rep, DISABLED_ChronosBench) {
+  mt19937_64 gen(42);
+  uniform_int_distribution<int64_t> secs(-1'000'000, 1'000'000);
+  uniform_int_distribution<int64_t> picos(0, PicosPerSecond - 1);
+  vector<UnitValue> values(BenchCount);
+  for (auto& sss : values) {
+    sss.s = secs(gen);
+    sss.ss = (sss.s < 0) ? -picos(gen) : picos(gen);
+  }
+
+  UnitValue totalCanon{}, totalWide{};
+  size_t orderedCanon = 0, orderedWide = 0;
+  benchAddCompare<details::DefaultScalarUnit>(
+      "DefaultBaseRep", values, totalCanon, orderedCanon);
+  benchAddCompare<details::Picos128ScalarUnit>(
+      "Picos128Rep", values, totalWide, orderedWide);
+  EXPECT_EQ(totalWide, totalCanon);
+  EXPECT_EQ(orderedWide, orderedCanon);
+}
+
+namespace {
+template<ColumnBackend Backend>
+void benchColumnWith(const char* label, const MomentColumn& lhs,
+    const MomentColumn& rhs, UnitValue offset, const DurationColumn& expected) {
+  if constexpr (ColumnOps<Backend>::available) {
+    using Ops = ColumnOps<Backend>;
+    MomentColumn shifted(lhs.size());
+    DurationColumn deltas(lhs.size());
+    cout << "  " << label << endl;
+    bench("add", [&] {
+      Ops::addValue(lhs.seconds(), lhs.subseconds(), offset,
+          shifted.seconds(), shifted.subseconds(), lhs.size());
+      consume(shifted);
+    });
+    bench("sub", [&] {
+      Ops::sub(shifted.seconds(), shifted.subseconds(), rhs.seconds(),
+          rhs.subseconds(), deltas.seconds(), deltas.subseconds(),
+          lhs.size());
+      consume(deltas);
+    });
+    for (size_t i = 0; i < deltas.size(); ++i)
+      EXPECT_EQ(deltas.value(i), expected.value(i));
+  }
+}
+} // namespace
+
+TEST(MomentColumn, DISABLED_ChronosBench) {
+  // Timestamps over a century, shifted by a time zone offset, then compared
+  // with another batch.
+  mt19937_64 gen(42);
+  uniform_int_distribution<int64_t> secs(
+      UnixEpochSeconds, UnixEpochSeconds + 100 * SecondsPerYear);
+  uniform_int_distribution<int64_t> picos(0, PicosPerSecond - 1);
+  vector<Moment<>> lhs(BenchCount), rhs(BenchCount);
+  MomentColumn lhsColumn, rhsColumn;
+  for (size_t i = 0; i < BenchCount; ++i) {
+    lhs[i] = Moment<>(secs(gen), picos(gen));
+    rhs[i] = Moment<>(secs(gen), picos(gen));
+    lhsColumn.push_back(lhs[i]);
+    rhsColumn.push_back(rhs[i]);
+  }
+  const Duration<> offset(-5 * SecondsPerHour, -500'000'000'000);
+
+  vector<Moment<>> shifted(BenchCount);
+  vector<Duration<>> deltas(BenchCount);
+  cout << "MomentColumn" << endl;
+  cout << "  vector<Moment<>>" << endl;
+  bench("add", [&] {
+    for (size_t i = 0; i < BenchCount; ++i) shifted[i] = lhs[i] + offset;
+    consume(shifted);
+  });
+  bench("sub", [&] {
+    for (size_t i = 0; i < BenchCount; ++i) deltas[i] = shifted[i] - rhs[i];
+    consume(deltas);
+  });
+
+  DurationColumn expected;
+  for (const auto& d : deltas) expected.push_back(d);
+  benchColumnWith<ColumnBackend::Scalar>(
+      "scalar", lhsColumn, rhsColumn, offset.value(), expected);
+  benchColumnWith<ColumnBackend::Avx2>(
+      "avx2", lhsColumn, rhsColumn, offset.value(), expected);
+  benchColumnWith<ColumnBackend::Avx512>(
+      "avx512", lhsColumn, rhsColumn, offset.value(), expected);
+}
+
+namespace {
+template<ColumnBackend Backend>
+void benchReduceWith(const char* label, const DurationColumn& column,
+    const Duration<>& total, const Duration<>& least) {
+  if constexpr (ColumnOps<Backend>::available) {
+    using Ops = ColumnOps<Backend>;
+    UnitValue sum{}, min{};
+    CategoryCounts counts{};
+    cout << "  " << label << endl;
+    bench("sum", [&] {
+      sum = Ops::sum(column.seconds(), column.subseconds(), column.size());
+      consume(sum);
+    });
+    bench("min", [&] {
+      min = Ops::minimum(column.seconds(), column.subseconds(), column.size());
+      consume(min);
+    });
+    bench("count", [&] {
+      counts = Ops::countCategories(column.seconds(), column.size());
+      consume(counts);
+    });
+    EXPECT_EQ(sum, total.value());
+    EXPECT_EQ(min, least.value());
+    EXPECT_EQ(counts[static_cast<size_t>(Category::Num)], column.size());
+  }
+}
+} // namespace
+
+TEST(DurationColumnReduce, DISABLED_ChronosBench) {
+  mt19937_64 gen(42);
+  uniform_int_distribution<int64_t> secs(-1'000'000, 1'000'000);
+  uniform_int_distribution<int64_t> picos(0, PicosPerSecond - 1);
+  vector<Duration<>> work(BenchCount);
+  for (auto& d : work) {
+    int64_t s = secs(gen), ss = picos(gen);
+    d = Duration<>(s, s < 0 ? -ss : ss);
+  }
+  const DurationColumn column(work.begin(), work.end());
+
+  Duration<> total, least(Category::InfP);
+  cout << "DurationColumn reductions" << endl;
+  cout << "  vector<Duration<>>" << endl;
+  bench("sum", [&] {
+    Duration<> sum;
+    for (const auto& d : work) sum += d;
+    consume(sum);
+    total = sum;
+  });
+  bench("min", [&] {
+    Duration<> min(Category::InfP);
+    for (const auto& d : work)
+      if (d < min) min = d;
+    consume(min);
+    least = min;
+  });
+  benchReduceWith<ColumnBackend::Scalar>("scalar", column, total, least);
+  benchReduceWith<ColumnBackend::Avx2>("avx2", column, total, least);
+  benchReduceWith<ColumnBackend::Avx512>("avx512", column, total, least);
+}
+
+// A day of moments, as when ordering a day's events by timestamp. Each run
+// includes copying the unsorted moments, which is the same for every variant.
+TEST(RadixSort, DISABLED_ChronosBench) {
+  mt19937_64 gen(42);
+  uniform_int_distribution<int64_t> secs(0, SecondsPerDay - 1);
+  uniform_int_distribution<int64_t> picos(0, PicosPerSecond - 1);
+  const Moment<> start(UnixEpochSeconds + 20'000 * SecondsPerDay);
+  vector<Moment<>> work(BenchCount);
+  for (auto& m : work)
+    m = start + Duration<>(secs(gen), picos(gen) / 1000 * 1000);
+
+  vector<Moment<>> expected, sorted;
+  cout << "Sorting a day of moments" << endl;
+  bench("std::sort", [&] {
+    expected = work;
+    sort(expected.begin(), expected.end());
+    consume(expected);
+  });
+  bench("radixSort", [&] {
+    sorted = work;
+    radixSort(sorted.begin(), sorted.end());
+    consume(sorted);
+  });
+  EXPECT_EQ(sorted, expected);
+  bench("parallelRadixSort", [&] {
+    sorted = work;
+    parallelRadixSort(sorted.begin(), sorted.end());
+    consume(sorted);
+  });
+  EXPECT_EQ(sorted, expected);
+  vector<size_t> order;
+  bench("radixArgsort", [&] {
+    order = radixArgsort(work.begin(), work.end());
+    consume(order);
+  });
+  for (size_t i = 0; i < BenchCount; ++i)
+    EXPECT_EQ(work[order[i]], expected[i]);
+}
+
+// Moments from this era to the nanosecond, as stored in a key-value store.
+TEST(KeyEncoding, DISABLED_ChronosBench) {
+  mt19937_64 gen(42);
+  uniform_int_distribution<int64_t> secs(0, 100 * SecondsPerYear);
+  uniform_int_distribution<int64_t> nanos(0, NanosPerSecond - 1);
+  vector<Moment<>> work(BenchCount);
+  for (auto& m : work)
+    m = Moment<>(UnixEpochSeconds + secs(gen), nanos(gen) * 1000);
+
+  vector<array<uint8_t, KeySize>> fixed(BenchCount);
+  vector<array<uint8_t, MaxCompactKeySize>> compact(BenchCount);
+  vector<uint8_t> lengths(BenchCount);
+  vector<Moment<>> back(BenchCount);
+  cout << "Key encoding" << endl;
+  bench("encodeKey", [&] {
+    for (size_t i = 0; i < BenchCount; ++i) fixed[i] = encodeKey(work[i]);
+    consume(fixed);
+  });
+  bench("decodeKey", [&] {
+    for (size_t i = 0; i < BenchCount; ++i) decodeKey(fixed[i].data(), back[i]);
+    consume(back);
+  });
+  EXPECT_EQ(back, work);
+  bench("encodeCompactKey", [&] {
+    for (size_t i = 0; i < BenchCount; ++i)
+      lengths[i] = static_cast<uint8_t>(
+          encodeCompactKey(work[i], compact[i].data()));
+    consume(compact);
+  });
+  bench("decodeCompactKey", [&] {
+    for (size_t i = 0; i < BenchCount; ++i)
+      decodeCompactKey(compact[i].data(), lengths[i], back[i]);
+    consume(back);
+  });
+  EXPECT_EQ(back, work);
+}
+
+namespace {
+// Sorts moments of a rep by comparing them both directly and through their
+// values, which is what every comparison did before reps could be compared
+// raw.
+template<typename Unit>
+void benchRawCompare(const char* label, const vector<Moment<Unit>>& work) {
+  cout << "  " << label << endl;
+  vector<Moment<Unit>> byValue, direct;
+  bench("std::sort by value()", [&] {
+    byValue = work;
+    sort(byValue.begin(), byValue.end(),
+        [](const Moment<Unit>& a, const Moment<Unit>& b) {
+          UnitValue l = a.value(), r = b.value();
+          if (l.s == SecondsTraits<>::NaN || r.s == SecondsTraits<>::NaN)
+            return false;
+          return l < r;
+        });
+    consume(byValue);
+  });
+  bench("std::sort by <=>", [&] {
+    direct = work;
+    sort(direct.begin(), direct.end());
+    consume(direct);
+  });
+  EXPECT_EQ(direct, byValue);
+}
+} // namespace
+
+TEST(RawCompare, DISABLED_ChronosBench) {
+  mt19937_64 gen(42);
+  uniform_int_distribution<int64_t> secs(0, 50 * SecondsPerYear);
+  uniform_int_distribution<int64_t> nanos(0, NanosPerSecond - 1);
+  vector<Moment<details::ScalarUnit<details::Unix32Rep>>> unix32(BenchCount);
+  vector<Moment<>> canon(BenchCount);
+  for (size_t i = 0; i < BenchCount; ++i) {
+    canon[i] = Moment<>(UnixEpochSeconds + secs(gen), nanos(gen) * 1000);
+    unix32[i] = Moment<details::ScalarUnit<details::Unix32Rep>>(canon[i]);
+  }
+  cout << "Sorting moments" << endl;
+  benchRawCompare("DefaultBaseRep", canon);
+  benchRawCompare("Unix32Rep", unix32);
+}
+
+namespace {
+// The sort of hash that gets written by hand, combining the standard hashes
+// of the fields. Those are the identity for integers, so this is just XOR.
+struct XorHash {
+  size_t operator()(const Moment<>& m) const noexcept {
+    return hash<UnitSeconds>()(m.seconds()) ^ hash<UnitPicos>()(m.subseconds());
+  }
+};
+
+// Counts the distinct moments with an open-addressed table of a power-of-two
+// size, indexed by the low bits of the hash, as flat hash maps are.
+template<typename Hash>
+size_t flatDedup(const vector<Moment<>>& work, vector<Moment<>>& table) {
+  const size_t mask = table.size() - 1;
+  const Moment<> empty(Category::NaN);
+  fill(table.begin(), table.end(), empty);
+  size_t distinct = 0;
+  for (const auto& m : work) {
+    size_t slot = Hash()(m) & mask;
+    while (table[slot].seconds() != SecondsTraits<>::NaN && table[slot] != m)
+      slot = (slot + 1) & mask;
+    if (table[slot].seconds() == SecondsTraits<>::NaN)
+      table[slot] = m, ++distinct;
+  }
+  return distinct;
+}
+
+// Dedups the moments, each of which appears twice, and joins half of them
+// against the other half, with the given hash.
+template<typename Hash>
+void benchHash(const char* label, const vector<Moment<>>& work,
+    size_t& distinct, size_t& matched) {
+  cout << "  " << label << endl;
+  bench("unordered_set dedup", [&] {
+    unordered_set<Moment<>, Hash> seen;
+    for (const auto& m : work) seen.insert(m);
+    distinct = seen.size();
+  });
+  vector<Moment<>> table(size_t(1) << 21);
+  size_t flat = 0;
+  bench("flat table dedup", [&] { flat = flatDedup<Hash>(work, table); });
+  EXPECT_EQ(flat, distinct);
+  const size_t half = work.size() / 2;
+  unordered_map<Moment<>, size_t, Hash> build;
+  for (size_t i = 0; i < half; ++i) build.emplace(work[i], i);
+  bench("unordered_map join", [&] {
+    matched = 0;
+    for (size_t i = half; i < work.size(); ++i)
+      matched += build.count(work[i]);
+  });
+}
+} // namespace
+
+TEST(Hash, DISABLED_ChronosBench) {
+  // Microsecond ticks, and random moments over fifty years. Each appears
+  // twice, so that half the inserts are duplicates.
+  const UnitSeconds base = UnixEpochSeconds + 1'700'000'000;
+  vector<Moment<>> spaced(BenchCount), random(BenchCount);
+  mt19937_64 gen(42);
+  uniform_int_distribution<int64_t> secs(0, 50 * SecondsPerYear);
+  uniform_int_distribution<int64_t> nanos(0, NanosPerSecond - 1);
+  for (size_t i = 0; i < BenchCount / 2; ++i) {
+    auto n = static_cast<int64_t>(i);
+    spaced[2 * i] = spaced[2 * i + 1] =
+        Moment<>(base + n / 1'000'000, n % 1'000'000 * 1'000'000);
+    random[2 * i] = random[2 * i + 1] =
+        Moment<>(UnixEpochSeconds + secs(gen), nanos(gen) * 1'000);
+  }
+  shuffle(spaced.begin(), spaced.end(), gen);
+  shuffle(random.begin(), random.end(), gen);
+  for (auto [label, work] : {pair{"Evenly spaced", &spaced},
+           pair{"Random", &random}}) {
+    cout << label << " moments" << endl;
+    size_t distinctXor = 0, matchedXor = 0, distinct = 0, matched = 0;
+    benchHash<XorHash>("XOR of field hashes", *work, distinctXor, matchedXor);
+    benchHash<ScalarHash>("ScalarHash", *work, distinct, matched);
+    EXPECT_EQ(distinct, BenchCount / 2);
+    EXPECT_EQ(distinctXor, distinct);
+    EXPECT_EQ(matchedXor, matched);
+  }
+}
+
+TEST(Parse, DISABLED_ChronosBench) {
+  // Log timestamps, to the nanosecond, one per line.
+  mt19937_64 gen(42);
+  uniform_int_distribution<int64_t> secs(0, 50 * SecondsPerYear);
+  uniform_int_distribution<int64_t> nanos(0, NanosPerSecond - 1);
+  vector<Moment<>> expected(BenchCount);
+  // The sscanf gets lines of their own, since it measures the whole string
+  // each time.
+  vector<string> lines(BenchCount);
+  string text;
+  vector<size_t> starts(BenchCount);
+  for (size_t i = 0; i < BenchCount; ++i) {
+    int64_t days = secs(gen) / SecondsPerDay + 719'162;
+    int64_t sod = secs(gen) % SecondsPerDay;
+    int64_t ns = nanos(gen);
+    // Walk the days out to a date, the slow way.
+    int year = 1970, month = 1;
+    int64_t left = days - 719'162;
+    while (left >= (details::isLeapYear(year) ? 366 : 365))
+      left -= details::isLeapYear(year) ? 366 : 365, ++year;
+    while (left >= details::daysInMonth(year, month))
+      left -= details::daysInMonth(year, month), ++month;
+    char line[64];
+    snprintf(line, sizeof(line), "%04d-%02d-%02dT%02d:%02d:%02d.%09dZ", year,
+        month, static_cast<int>(left) + 1, static_cast<int>(sod / 3600),
+        static_cast<int>(sod / 60 % 60), static_cast<int>(sod % 60),
+        static_cast<int>(ns));
+    lines[i] = line;
+    starts[i] = text.size();
+    text += line;
+    text += '\n';
+    expected[i] = Moment<>(days * SecondsPerDay + sod, ns * 1'000);
+  }
+
+  cout << "Parsing ISO 8601 timestamps" << endl;
+  vector<Moment<>> scanned(BenchCount), parsed(BenchCount);
+  bench("sscanf", [&] {
+    for (size_t i = 0; i < BenchCount; ++i) {
+      int y, mo, d, h, mi, sec, ns;
+      sscanf(lines[i].c_str(), "%4d-%2d-%2dT%2d:%2d:%2d.%9dZ", &y, &mo, &d,
+          &h, &mi, &sec, &ns);
+      scanned[i] = Moment<>(details::daysFromCivil(y, mo, d) * SecondsPerDay +
+              h * SecondsPerHour + mi * SecondsPerMinute + sec,
+          UnitPicos(ns) * 1'000);
+    }
+    consume(scanned);
+  });
+  bench("parseMoment", [&] {
+    const char* last = text.data() + text.size();
+    for (size_t i = 0; i < BenchCount; ++i)
+      parseMoment(text.data() + starts[i], last, parsed[i]);
+    consume(parsed);
+  });
+  MomentColumn column;
+  bench("parseMoments into a column", [&] {
+    column.clear();
+    parseMoments(text, '\n', column);
+    consume(column);
+  });
+  EXPECT_EQ(scanned, expected);
+  EXPECT_EQ(parsed, expected);
+  ASSERT_EQ(column.size(), BenchCount);
+  EXPECT_EQ(column[BenchCount - 1], expected.back());
+}
+
+TEST(Format, DISABLED_ChronosBench) {
+  mt19937_64 gen(42);
+  uniform_int_distribution<int64_t> secs(0, 50 * SecondsPerYear);
+  uniform_int_distribution<int64_t> nanos(0, NanosPerSecond - 1);
+  vector<Moment<>> moments(BenchCount);
+  vector<Duration<>> durations(BenchCount);
+  for (size_t i = 0; i < BenchCount; ++i) {
+    moments[i] = Moment<>(UnixEpochSeconds + secs(gen), nanos(gen) * 1'000);
+    durations[i] = Duration<>(secs(gen) % 1'000, nanos(gen) * 1'000);
+  }
+  // Each writes every line into the same buffer, as a log writer would.
+  string text(BenchCount * MaxIsoChars, ' ');
+
+  cout << "Formatting durations" << endl;
+  size_t streamed = 0, written = 0;
+  bench("ostream <<", [&] {
+    ostringstream os;
+    for (const auto& d : durations) os << d << '\n';
+    streamed = os.str().size();
+  });
+  bench("toChars", [&] {
+    char* out = text.data();
+    char* last = out + text.size();
+    for (const auto& d : durations) {
+      out = toChars(out, last, d).ptr;
+      *out++ = '\n';
+    }
+    written = static_cast<size_t>(out - text.data());
+    consume(text);
+  });
+  EXPECT_GT(streamed, written);
+
+  cout << "Formatting moments to the nanosecond" << endl;
+  string printed;
+  bench("civilFromDays and snprintf", [&] {
+    char* out = text.data();
+    for (const auto& m : moments) {
+      auto [s, ss] = m.value();
+      auto date = details::civilFromDays(s / SecondsPerDay);
+      auto rest = static_cast<int>(s % SecondsPerDay);
+      out += snprintf(out, MaxIsoChars, "%04d-%02d-%02dT%02d:%02d:%02d.%09dZ\n",
+          static_cast<int>(date.year), date.month, date.day, rest / 3'600,
+          rest / 60 % 60, rest % 60, static_cast<int>(ss / 1'000));
+    }
+    printed.assign(text.data(), out);
+  });
+  bench("toChars", [&] {
+    char* out = text.data();
+    char* last = out + text.size();
+    for (const auto& m : moments) {
+      out = toChars(out, last, m, Precision::Nanos).ptr;
+      *out++ = '\n';
+    }
+    written = static_cast<size_t>(out - text.data());
+    consume(text);
+  });
+  EXPECT_EQ(string_view(text.data(), written), printed);
+}
+
+TEST(IsoFormatter, DISABLED_ChronosBench) {
+  // A million lines a second, a microsecond or so apart, and random moments,
+  // which never share a second.
+  mt19937_64 gen(42);
+  uniform_int_distribution<int64_t> jitter(0, 2'000'000);
+  uniform_int_distribution<int64_t> secs(0, 50 * SecondsPerYear);
+  vector<Moment<>> logged(BenchCount), random(BenchCount);
+  Moment<> at(UnixEpochSeconds + 1'700'000'000);
+  for (size_t i = 0; i < BenchCount; ++i) {
+    logged[i] = at += Duration<>(0, jitter(gen));
+    random[i] = Moment<>(UnixEpochSeconds + secs(gen), jitter(gen));
+  }
+  string expected(BenchCount * MaxIsoChars, ' '), text = expected;
+
+  for (auto [label, work] : {pair{"Logged moments", &logged},
+           pair{"Random moments", &random}}) {
+    cout << label << ", to the microsecond" << endl;
+    size_t plain = 0, cached = 0;
+    bench("toChars", [&] {
+      char* out = expected.data();
+      char* last = out + expected.size();
+      for (const auto& m : *work) {
+        out = toChars(out, last, m, Precision::Micros).ptr;
+        *out++ = '\n';
+      }
+      plain = static_cast<size_t>(out - expected.data());
+      consume(expected);
+    });
+    bench("IsoFormatter", [&] {
+      IsoFormatter formatter;
+      char* out = text.data();
+      char* last = out + text.size();
+      for (const auto& m : *work) {
+        out = formatter.toChars(out, last, m, Precision::Micros).ptr;
+        *out++ = '\n';
+      }
+      cached = static_cast<size_t>(out - text.data());
+      consume(text);
+    });
+    EXPECT_EQ(string_view(text.data(), cached),
+        string_view(expected.data(), plain));
+  }
+}
+
+namespace {
+// The previous conversion, with divisions by the lengths of eras, centuries,
+// and years, as a baseline.
+CivilDate civilFromDaysByDivision(int64_t days) {
+  constexpr int64_t DaysPerEra = 146'097;
+  days += 306;
+  int64_t era = (days >= 0 ? days : days - (DaysPerEra - 1)) / DaysPerEra;
+  int64_t dayOfEra = days - era * DaysPerEra;
+  int64_t yearOfEra = (dayOfEra - dayOfEra / 1'460 + dayOfEra / 36'524 -
+                          dayOfEra / (DaysPerEra - 1)) / 365;
+  int64_t dayOfYear =
+      dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+  int64_t shiftedMonth = (5 * dayOfYear + 2) / 153;
+  int month = static_cast<int>(
+      shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9);
+  int day = static_cast<int>(dayOfYear - (153 * shiftedMonth + 2) / 5 + 1);
+  return CivilDate{era * 400 + yearOfEra + (month <= 2), month, day};
+}
+} // namespace
+
+TEST(Civil, DISABLED_ChronosBench) {
+  // Moments over a century around the present, as for partitioning by day.
+  mt19937_64 gen(42);
+  uniform_int_distribution<int64_t> secs(0, 100 * SecondsPerYear);
+  uniform_int_distribution<int64_t> picos(0, PicosPerSecond - 1);
+  MomentColumn column;
+  for (size_t i = 0; i < BenchCount; ++i)
+    column.push_back(Moment<>(UnixEpochSeconds + secs(gen), picos(gen)));
+  const UnitSeconds* s = column.seconds();
+  const UnitPicos* ss = column.subseconds();
+  vector<int64_t> expectedYears(BenchCount), years(BenchCount);
+  vector<uint8_t> expectedMonths(BenchCount), months(BenchCount);
+  vector<uint8_t> expectedDays(BenchCount), days(BenchCount);
+
+  cout << "Moments to dates" << endl;
+  bench("Divisions", [&] {
+    for (size_t i = 0; i < BenchCount; ++i) {
+      UnitSeconds rest = 0;
+      CivilDate date = civilFromDaysByDivision(
+          details::splitDays(s[i] - (ss[i] < 0), rest));
+      expectedYears[i] = date.year;
+      expectedMonths[i] = static_cast<uint8_t>(date.month);
+      expectedDays[i] = static_cast<uint8_t>(date.day);
+    }
+    consume(expectedYears);
+  });
+  bench("Affine", [&] {
+    for (size_t i = 0; i < BenchCount; ++i)
+      details::civilDateLane(s[i], ss[i], years.data(), months.data(),
+          days.data(), i);
+    consume(years);
+  });
+  EXPECT_EQ(years, expectedYears);
+  EXPECT_EQ(months, expectedMonths);
+  EXPECT_EQ(days, expectedDays);
+  fill(years.begin(), years.end(), 0);
+  bench("Affine batch", [&] {
+    civilDates(s, ss, years.data(), months.data(), days.data(), BenchCount);
+    consume(years);
+  });
+  EXPECT_EQ(years, expectedYears);
+  EXPECT_EQ(months, expectedMonths);
+  EXPECT_EQ(days, expectedDays);
+}
+
+TEST(Calendar, DISABLED_ChronosBench) {
+  // A month of events in order, which come in long runs on the same day, and
+  // moments scattered over a century.
+  mt19937_64 gen(42);
+  uniform_int_distribution<int64_t> secs(0, 100 * SecondsPerYear);
+  uniform_int_distribution<int64_t> picos(0, PicosPerSecond - 1);
+  MomentColumn events, scattered;
+  const UnitSeconds start = UnixEpochSeconds + 1'706'659'200;
+  for (size_t i = 0; i < BenchCount; ++i) {
+    events.push_back(Moment<>(
+        start + static_cast<int64_t>(i) * 30 * SecondsPerDay / BenchCount,
+        picos(gen)));
+    scattered.push_back(
+        Moment<>(UnixEpochSeconds + secs(gen), picos(gen)));
+  }
+
+  for (auto [label, column] : {pair{"Events in order", &events},
+           pair{"Scattered moments", &scattered}}) {
+    cout << label << ", plus a month" << endl;
+    MomentColumn expected = *column, single = *column, batch = *column;
+    bench("Civil fields", [&] {
+      for (size_t i = 0; i < BenchCount; ++i) {
+        CivilTime t{};
+        toCivil((*column)[i], t);
+        if (++t.month > 12) ++t.year, t.month = 1;
+        t.day = min(t.day, details::daysInMonth(t.year, t.month));
+        expected.set(i, fromCivil(t));
+      }
+      consume(expected);
+    });
+    bench("addMonths", [&] {
+      for (size_t i = 0; i < BenchCount; ++i)
+        single.set(i, addMonths((*column)[i], 1));
+      consume(single);
+    });
+    bench("addMonths column", [&] {
+      copy_n(column->seconds(), BenchCount, batch.seconds());
+      copy_n(column->subseconds(), BenchCount, batch.subseconds());
+      addMonths(batch, 1);
+      consume(batch);
+    });
+    for (size_t i = 0; i < BenchCount; ++i) {
+      EXPECT_EQ(single.value(i), expected.value(i));
+      EXPECT_EQ(batch.value(i), expected.value(i));
+    }
+  }
+}
+
+TEST(TimeZone, DISABLED_ChronosBench) {
+  // New York's rule, as TZif data with no transitions of its own, and a
+  // stream of events from the same year, in time order.
+  string rule = "EST5EDT,M3.2.0,M11.1.0";
+  vector<unsigned char> data;
+  for (int block = 0; block < 2; ++block) {
+    data.insert(data.end(), {'T', 'Z', 'i', 'f', '2'});
+    data.insert(data.end(), 15, 0);
+    for (int count : {0, 0, 0, 0, 1, 4})
+      data.insert(data.end(), {0, 0, 0, static_cast<unsigned char>(count)});
+    data.insert(data.end(), {0xFF, 0xFF, 0xB9, 0xB0, 0, 0, 'E', 'S', 'T', 0});
+  }
+  data.push_back('\n');
+  data.insert(data.end(), rule.begin(), rule.end());
+  data.push_back('\n');
+  TimeZone zone;
+  ASSERT_EQ(zone.readTzif(data.data(), data.size()), ZoneError::None);
+
+  MomentColumn events;
+  Moment<> at(UnixEpochSeconds + 1'704'067'200);
+  for (size_t i = 0; i < BenchCount; ++i)
+    events.push_back(at += Duration<>(30, 123));
+
+  // The baseline is a binary search of the transitions, which are walked out
+  // of the zone itself.
+  vector<pair<UnitSeconds, int32_t>> table;
+  for (UnitSeconds from = 0, until = SecondsTraits<>::Min;
+       until < zone.reduce(SecondsTraits<>::Max);) {
+    int32_t offset = zone.find(until, from, until);
+    table.emplace_back(from, offset);
+  }
+  vector<int32_t> expected(BenchCount), offsets(BenchCount);
+  cout << "Offsets of events in order" << endl;
+  bench("Binary search", [&] {
+    for (size_t i = 0; i < BenchCount; ++i) {
+      auto it = upper_bound(table.begin(), table.end(),
+          pair{zone.reduce(events.seconds()[i]), INT32_MAX});
+      expected[i] = prev(it)->second;
+    }
+    consume(expected);
+  });
+  bench("Index", [&] {
+    for (size_t i = 0; i < BenchCount; ++i)
+      offsets[i] = zone.offset(events.seconds()[i]);
+    consume(offsets);
+  });
+  EXPECT_EQ(offsets, expected);
+  bench("Cursor", [&] {
+    ZoneCursor cursor(zone);
+    for (size_t i = 0; i < BenchCount; ++i)
+      offsets[i] = cursor.offset(events.seconds()[i]);
+    consume(offsets);
+  });
+  EXPECT_EQ(offsets, expected);
+
+  cout << "Events to local time" << endl;
+  MomentColumn single = events, batch = events;
+  bench("toLocal", [&] {
+    for (size_t i = 0; i < BenchCount; ++i)
+      single.set(i, zone.toLocal(events[i]));
+    consume(single);
+  });
+  bench("toLocal column", [&] {
+    copy_n(events.seconds(), BenchCount, batch.seconds());
+    copy_n(events.subseconds(), BenchCount, batch.subseconds());
+    toLocal(zone, batch);
+    consume(batch);
+  });
+  for (size_t i = 0; i < BenchCount; ++i)
+    EXPECT_EQ(batch.value(i), single.value(i));
+}
+
+TEST(LeapSeconds, DISABLED_ChronosBench) {
+  // Recent events, all in the same leap epoch, as POSIX moments.
+  const LeapSeconds leaps;
+  MomentColumn events;
+  Moment<> at(UnixEpochSeconds + 1'704'067'200);
+  for (size_t i = 0; i < BenchCount; ++i)
+    events.push_back(at += Duration<>(30, 123));
+
+  // The baselines are the fixed offset that the table replaces, and a binary
+  // search of a table of leaps for every moment.
+  vector<pair<UnitSeconds, int32_t>> table;
+  for (auto [year, month, offset] : details::BuiltinLeaps)
+    table.emplace_back(
+        fromCivil(CivilTime{year, month, 1, 0, 0, 0, 0}).seconds(), offset);
+  MomentColumn expected = events, single = events, batch = events;
+  cout << "POSIX to TAI" << endl;
+  bench("Fixed 37 s", [&] {
+    for (size_t i = 0; i < BenchCount; ++i)
+      expected.set(i, events[i] + Duration<>(37));
+    consume(expected);
+  });
+  bench("Binary search", [&] {
+    for (size_t i = 0; i < BenchCount; ++i) {
+      auto it = upper_bound(table.begin(), table.end(),
+          pair{events.seconds()[i], INT32_MAX});
+      single.set(i, events[i] + Duration<>(prev(it)->second));
+    }
+    consume(single);
+  });
+  for (size_t i = 0; i < BenchCount; ++i)
+    EXPECT_EQ(single.value(i), expected.value(i));
+  bench("toTai", [&] {
+    for (size_t i = 0; i < BenchCount; ++i)
+      single.set(i, leaps.toTai(events[i]));
+    consume(single);
+  });
+  bench("toTai column", [&] {
+    copy_n(events.seconds(), BenchCount, batch.seconds());
+    copy_n(events.subseconds(), BenchCount, batch.subseconds());
+    leaps.toTai(batch);
+    consume(batch);
+  });
+  for (size_t i = 0; i < BenchCount; ++i) {
+    EXPECT_EQ(single.value(i), expected.value(i));
+    EXPECT_EQ(batch.value(i), expected.value(i));
+  }
+}
+
+TEST(Clock, DISABLED_ChronosBench) {
+  // The baseline is converting by hand, adding the fraction as a duration,
+  // from clock_gettime where there is one, as Clock.h does.
+  vector<Moment<>> readings(BenchCount);
+  cout << "Reading the time" << endl;
+  bench("Kernel clock, by hand", [&] {
+    for (size_t i = 0; i < BenchCount; ++i) {
+      timespec ts{};
+#ifdef CLOCK_REALTIME
+      clock_gettime(CLOCK_REALTIME, &ts);
+#else
+      timespec_get(&ts, TIME_UTC);
+#endif
+      readings[i] = Moment<>(UnixEpochSeconds + ts.tv_sec) +
+          Duration<>(0, ts.tv_nsec * 1'000);
+    }
+    consume(readings);
+  });
+  bench("Realtime", [&] {
+    for (size_t i = 0; i < BenchCount; ++i) readings[i] = now();
+    consume(readings);
+  });
+  bench("Tai", [&] {
+    for (size_t i = 0; i < BenchCount; ++i)
+      readings[i] = now<ClockSource::Tai>();
+    consume(readings);
+  });
+  bench("Monotonic", [&] {
+    for (size_t i = 0; i < BenchCount; ++i)
+      readings[i] = now<ClockSource::Monotonic>();
+    consume(readings);
+  });
+  TscClock clock;
+  cout << "  (TSC " << (clock.invariant() ? "invariant" : "not invariant")
+       << ", " << clock.scale() / double(uint64_t{1} << 32) << " ps/tick)"
+       << endl;
+  bench("TscClock", [&] {
+    for (size_t i = 0; i < BenchCount; ++i) readings[i] = clock.now();
+    consume(readings);
+  });
+
+  // How far the counter drifts from the system clock, with a period long
+  // enough that it isn't calibrated along the way.
+  cout << "Drift from Realtime" << endl;
+  TscClock idle(ClockSource::Realtime, Duration<>(SecondsPerHour));
+  for (int ms : {10, 100, 1'000}) {
+    idle.recalibrate();
+    this_thread::sleep_for(chrono::milliseconds(ms));
+    Duration<> drift = idle.recalibrate();
+    cout << "  after " << ms << " ms: " << drift.seconds() * 1e9 +
+            drift.subseconds() / 1e3 << " ns" << endl;
+  }
+}
+
+TEST(CoarseClock, DISABLED_ChronosBench) {
+  // Reading the slot, against reading the kernel clock each time, with and
+  // without other threads reading it too.
+  vector<Moment<>> readings(BenchCount);
+  CoarseClock clock;
+  cout << "Reading the time to the millisecond" << endl;
+  bench("now()", [&] {
+    for (size_t i = 0; i < BenchCount; ++i) readings[i] = now();
+    consume(readings);
+  });
+  bench("CoarseClock", [&] {
+    for (size_t i = 0; i < BenchCount; ++i) readings[i] = clock.now();
+    consume(readings);
+  });
+  atomic<bool> done{false};
+  vector<thread> readers;
+  for (int i = 0; i < 3; ++i)
+    readers.emplace_back([&] {
+      while (!done) consume(clock.now());
+    });
+  bench("CoarseClock, 3 other readers", [&] {
+    for (size_t i = 0; i < BenchCount; ++i) readings[i] = clock.now();
+    consume(readings);
+  });
+  done = true;
+  for (thread& reader : readers) reader.join();
+
+  // How far behind the kernel clock the readings are.
+  Duration<> worst;
+  for (size_t i = 0; i < BenchCount; ++i) {
+    Moment<> reading = clock.now();
+    worst = max(worst, now() - reading);
+  }
+  cout << "  Worst lag: " << worst.seconds() * 1e3 +
+          worst.subseconds() / 1e9 << " ms" << endl;
+}
+
+TEST(Interop, DISABLED_ChronosBench) {
+  // Receive timestamps from the recent past, as recvmmsg would give them.
+  mt19937_64 gen(42);
+  // The fields are time_t and long, so that braces don't narrow into them.
+  uniform_int_distribution<time_t> secs(1'700'000'000, 1'800'000'000);
+  uniform_int_distribution<long> nanos(0, NanosPerSecond - 1);
+  vector<timespec> stamps(BenchCount);
+  for (timespec& ts : stamps) ts = timespec{secs(gen), nanos(gen)};
+
+  // The baseline is converting by hand, adding the fraction as a duration.
+  MomentColumn expected, single, batch;
+  expected.resize(BenchCount), single.resize(BenchCount);
+  cout << "timespec to Moment" << endl;
+  bench("By hand", [&] {
+    for (size_t i = 0; i < BenchCount; ++i)
+      expected.set(i, Moment<>(UnixEpochSeconds + stamps[i].tv_sec) +
+              Duration<>(0, stamps[i].tv_nsec * 1'000));
+    consume(expected);
+  });
+  bench("fromTimespec", [&] {
+    for (size_t i = 0; i < BenchCount; ++i)
+      single.set(i, fromTimespec(stamps[i]));
+    consume(single);
+  });
+  bench("fromTimespecs", [&] {
+    fromTimespecs(stamps.data(), stamps.size(), batch);
+    consume(batch);
+  });
+  for (size_t i = 0; i < BenchCount; ++i) {
+    EXPECT_EQ(single.value(i), expected.value(i));
+    EXPECT_EQ(batch.value(i), expected.value(i));
+  }
+
+  // Durations to and from nanoseconds, by hand through the accessors, as
+  // callers did, and with the conversions.
+  vector<Duration<>> durations(BenchCount);
+  vector<chrono::nanoseconds> counts(BenchCount), byHand(BenchCount);
+  for (size_t i = 0; i < BenchCount; ++i)
+    durations[i] = Duration<>(batch.value(i)) - Duration<>(UnixEpochSeconds);
+  cout << "Duration to nanoseconds" << endl;
+  bench("By hand", [&] {
+    for (size_t i = 0; i < BenchCount; ++i)
+      byHand[i] = chrono::nanoseconds(durations[i].seconds() * NanosPerSecond +
+          durations[i].subseconds() / 1'000);
+    consume(byHand);
+  });
+  bench("toChrono", [&] {
+    for (size_t i = 0; i < BenchCount; ++i)
+      counts[i] = toChrono<chrono::nanoseconds>(durations[i]);
+    consume(counts);
+  });
+  EXPECT_EQ(counts, byHand);
+  vector<Duration<>> back(BenchCount), backByHand(BenchCount);
+  cout << "Nanoseconds to Duration" << endl;
+  bench("By hand", [&] {
+    for (size_t i = 0; i < BenchCount; ++i) {
+      int64_t count = counts[i].count();
+      backByHand[i] = Duration<>(count / NanosPerSecond) +
+          Duration<>(0, count % NanosPerSecond * 1'000);
+    }
+    consume(backByHand);
+  });
+  bench("fromChrono", [&] {
+    for (size_t i = 0; i < BenchCount; ++i) back[i] = fromChrono(counts[i]);
+    consume(back);
+  });
+  EXPECT_EQ(back, backByHand);
+}
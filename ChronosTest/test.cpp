@@ -1,9 +1,33 @@
 #include "pch.h"
+#include <atomic>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <thread>
 #include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 #include "../ChronosLib/CanonRep.h"
 #include "../ChronosLib/ScalarUnit.h"
 #include "../ChronosLib/Moment.h"
+#include "../ChronosLib/PackedRep.h"
+#include "../ChronosLib/WideRep.h"
+#include "../ChronosLib/NanosRep.h"
+#include "../ChronosLib/Column.h"
+#include "../ChronosLib/KeyEncoding.h"
+#include "../ChronosLib/Sort.h"
+#include "../ChronosLib/Hash.h"
+#include "../ChronosLib/Parse.h"
+#include "../ChronosLib/Format.h"
+#include "../ChronosLib/Literals.h"
+#include "../ChronosLib/Civil.h"
+#include "../ChronosLib/Calendar.h"
+#include "../ChronosLib/TimeZone.h"
+#include "../ChronosLib/LeapSeconds.h"
+#include "../ChronosLib/Clock.h"
+#include "../ChronosLib/CoarseClock.h"
+#include "../ChronosLib/Interop.h"
 
 using namespace std;
 using namespace chronos;
@@ -245,6 +269,99 @@ TEST(AddCarry, ChronosTest) {
   EXPECT_EQ(c, min);
 }
 
+template<WideBackend Backend>
+void testWideMath() {
+  using Ops = WideOps<Backend>;
+  using Ref = WideOps<WideBackend::Portable>;
+  constexpr int64_t max = std::numeric_limits<int64_t>::max();
+  constexpr int64_t min = std::numeric_limits<int64_t>::min();
+  int64_t hi, lo, q, r;
+
+  // Known products.
+  hi = Ops::mul(max, max, lo);
+  EXPECT_EQ(hi, max >> 1);
+  EXPECT_EQ(lo, 1);
+  hi = Ops::mul(min, min, lo);
+  EXPECT_EQ(hi, int64_t(1) << 62);
+  EXPECT_EQ(lo, 0);
+  hi = Ops::mul(min, max, lo);
+  EXPECT_EQ(hi, min >> 1);
+  EXPECT_EQ(lo, min);
+  hi = Ops::mul(-1, 1, lo);
+  EXPECT_EQ(hi, -1);
+  EXPECT_EQ(lo, -1);
+  uint64_t uHi, uLo, uQ;
+  uHi = Ops::mulu(~uint64_t(0), ~uint64_t(0), uLo);
+  EXPECT_EQ(uHi, ~uint64_t(1));
+  EXPECT_EQ(uLo, 1u);
+
+  // Known quotients, including the ones operator*= depends on.
+  hi = Ops::mul(PicosPerSecond - 1, max, lo);
+  r = Ops::div(hi, lo, PicosPerSecond, q);
+  EXPECT_EQ(q, 9223372036845552434);
+  EXPECT_EQ(r, 963145224193);
+  hi = Ops::mul(PicosPerSecond - 1, min, lo);
+  r = Ops::div(hi, lo, PicosPerSecond, q);
+  EXPECT_EQ(q, -9223372036845552435);
+  EXPECT_EQ(r, -963145224192);
+  r = Ops::div(-1, -7, 2, q);
+  EXPECT_EQ(q, -3);
+  EXPECT_EQ(r, -1);
+  r = Ops::div(0, 7, -2, q);
+  EXPECT_EQ(q, -3);
+  EXPECT_EQ(r, 1);
+  uint64_t uR = Ops::divu(~uint64_t(1), 1, ~uint64_t(0), uQ);
+  EXPECT_EQ(uQ, ~uint64_t(0));
+  EXPECT_EQ(uR, 0u);
+
+  // Agreement with the portable reference over a spread of operands.
+  const int64_t values[] = {0, 1, -1, 2, -3, 999'999'999'999,
+      -999'999'999'999, PicosPerSecond, 0x7654321076543210, -0x123456789ABCDEF,
+      max, min, max - 1, min + 1};
+  const int64_t divisors[] = {1, -1, 7, -7, PicosPerSecond, -PicosPerSecond,
+      max, min};
+  for (auto a : values) {
+    for (auto b : values) {
+      int64_t refLo, refHi = Ref::mul(a, b, refLo);
+      hi = Ops::mul(a, b, lo);
+      EXPECT_EQ(hi, refHi);
+      EXPECT_EQ(lo, refLo);
+      uint64_t refULo, refUHi = Ref::mulu(a, b, refULo);
+      uHi = Ops::mulu(a, b, uLo);
+      EXPECT_EQ(uHi, refUHi);
+      EXPECT_EQ(uLo, refULo);
+    }
+    for (auto d : divisors) {
+      // Keep the quotient in range by dividing a product by its own factor.
+      if (d == min || (a == min && d == -1)) continue;
+      hi = Ops::mul(a, d, lo);
+      int64_t refQ, refR = Ref::div(hi, lo, d, refQ);
+      r = Ops::div(hi, lo, d, q);
+      EXPECT_EQ(q, a);
+      EXPECT_EQ(r, 0);
+      EXPECT_EQ(q, refQ);
+      EXPECT_EQ(r, refR);
+      r = Ops::div(a < 0 ? -1 : 0, a, d, q);
+      refR = Ref::div(a < 0 ? -1 : 0, a, d, refQ);
+      EXPECT_EQ(q, refQ);
+      EXPECT_EQ(r, refR);
+    }
+  }
+}
+
+// Only backends that exist for this compiler and platform can be tested.
+template<WideBackend Backend>
+void testWideMathIfAvailable() {
+  if constexpr (WideOps<Backend>::available) testWideMath<Backend>();
+}
+
+TEST(WideMath, ChronosTest) {
+  testWideMathIfAvailable<WideBackend::Portable>();
+  testWideMathIfAvailable<WideBackend::Int128>();
+  testWideMathIfAvailable<WideBackend::X64Asm>();
+  testWideMathIfAvailable<WideBackend::Msvc>();
+}
+
 template<typename Unit>
 void testCtors() {
   Unit nan(Category::NaN);
@@ -400,6 +517,141 @@ TEST(CtorDefaultCopyAB, ChronosTest) {
   EXPECT_TRUE(a.isPositiveInfinity());
 }
 
+TEST(CanonRepScaling, ChronosTest) {
+  // Nanoseconds in 8 bytes, which is also the default for 32-bit fractions.
+  using Nanos = details::CanonRep<int32_t, int32_t, std::ratio<1, 1>,
+      std::ratio<NanosPerSecond, 1>>;
+  using Unit = details::ScalarUnit<Nanos>;
+  static_assert(std::is_same_v<Nanos, details::CanonRep<int32_t, int32_t>>);
+  static_assert(sizeof(Unit) == 8);
+  static_assert(sizeof(Duration<Unit>) == 8);
+  testCtors<Unit>();
+  static_assert(Unit(-1, -123'456'789'000).value() ==
+      UnitValue{-1, -123'456'789'000});
+
+  // Rounding is to the nearest, with ties away from zero, on both sides.
+  EXPECT_EQ(Unit(0, 499).value(), (UnitValue{0, 0}));
+  EXPECT_EQ(Unit(0, 500).value(), (UnitValue{0, 1000}));
+  EXPECT_EQ(Unit(0, -499).value(), (UnitValue{0, 0}));
+  EXPECT_EQ(Unit(0, -500).value(), (UnitValue{0, -1000}));
+  EXPECT_EQ(Unit(-3, 1500).value(), (UnitValue{-3, -2000}));
+  EXPECT_EQ(Unit(0, 999'999'999'500).value(), (UnitValue{1, 0}));
+  EXPECT_EQ(Unit(-1, -999'999'999'500).value(), (UnitValue{-2, 0}));
+
+  // The range is that of the 32-bit wholes, and rounding can saturate.
+  constexpr UnitSeconds max = SecondsTraits<int32_t>::Max;
+  EXPECT_EQ(Unit(max, 999'999'999'000).value(),
+      (UnitValue{max, 999'999'999'000}));
+  EXPECT_TRUE(Unit(max, 999'999'999'500).isPositiveInfinity());
+  EXPECT_TRUE(Unit(max + 1).isPositiveInfinity());
+  EXPECT_TRUE(Unit(-max - 1).isNegativeInfinity());
+  EXPECT_TRUE(Unit(1, -1).isNaN());
+  EXPECT_EQ(Unit(std::numeric_limits<Unit>::max().value()).value(),
+      (UnitValue{max, 999'999'999'000}));
+
+  Duration<Unit> d(1, 500'000'000'000);
+  d += d;
+  EXPECT_EQ(d.value(), (UnitValue{3, 0}));
+  d -= Duration<>(0, 1);
+  EXPECT_EQ(d.value(), (UnitValue{3, 0}));
+  d -= Duration<>(0, 500);
+  EXPECT_EQ(d.value(), (UnitValue{3, 0}));
+  d -= Duration<>(0, 501);
+  EXPECT_EQ(d.value(), (UnitValue{2, 999'999'999'000}));
+
+  // Small fractions default to the finest power of 10 that fits.
+  using Hundredths = details::ScalarUnit<details::CanonRep<int8_t, int8_t>>;
+  EXPECT_EQ(Hundredths(1, 5'000'000'000).value(),
+      (UnitValue{1, 10'000'000'000}));
+  EXPECT_EQ(Hundredths(1, 4'999'999'999).value(), (UnitValue{1, 0}));
+  EXPECT_EQ(Hundredths(0, -990'000'000'000).value(),
+      (UnitValue{0, -990'000'000'000}));
+
+  // Fractions that don't divide a picosecond evenly still round-trip.
+  using Odd = details::ScalarUnit<details::CanonRep<int16_t, int16_t,
+      std::ratio<1, 1>, std::ratio<127, 1>>>;
+  for (UnitPicos f = -126; f < 127; ++f) {
+    UnitPicos ss = Odd(0, f * PicosPerSecond / 127).subseconds();
+    EXPECT_EQ(Odd(0, ss).subseconds(), ss);
+    EXPECT_EQ(ss, (f * PicosPerSecond + (f < 0 ? -63 : 63)) / 127);
+  }
+
+  // Wholes larger than a second round the seconds, dropping the fractions
+  // unless the value is an exact multiple.
+  using Hours = details::ScalarUnit<details::CanonRep<int16_t, int16_t,
+      std::ratio<SecondsPerHour, 1>>>;
+  EXPECT_EQ(Hours(7200).value(), (UnitValue{7200, 0}));
+  EXPECT_EQ(Hours(3600, 500'000'000'000).value(),
+      (UnitValue{3600, 500'000'000'000}));
+  EXPECT_EQ(Hours(5399).value(), (UnitValue{3600, 0}));
+  EXPECT_EQ(Hours(5400).value(), (UnitValue{7200, 0}));
+  EXPECT_EQ(Hours(-5400).value(), (UnitValue{-7200, 0}));
+  EXPECT_EQ(Hours(5399, 999'999'999'999).value(), (UnitValue{7200, 0}));
+  EXPECT_EQ(Hours(1799, 999'900'000'000).value(), (UnitValue{0, 0}));
+  EXPECT_TRUE(Hours(32767 * SecondsPerHour).isPositiveInfinity());
+  using Threes = details::ScalarUnit<details::CanonRep<int16_t, int16_t,
+      std::ratio<3, 1>>>;
+  EXPECT_EQ(Threes(1, 500'000'000'000).value(), (UnitValue{3, 0}));
+  EXPECT_EQ(Threes(1, 499'900'000'000).value(), (UnitValue{0, 0}));
+  EXPECT_EQ(Threes(-1, -500'000'000'000).value(), (UnitValue{-3, 0}));
+}
+
+TEST(EpochBias, ChronosTest) {
+  // 32-bit seconds and nanoseconds, from the Unix epoch to early 2106.
+  using Rep = details::Unix32Rep;
+  using Unit = details::ScalarUnit<Rep>;
+  static_assert(sizeof(Unit) == 8);
+  static_assert(sizeof(Moment<Unit>) == 8);
+  constexpr UnitSeconds span = 2 * UnitSeconds(SecondsTraits<int32_t>::Max);
+  static_assert(Unit(UnixEpochSeconds).value() ==
+      UnitValue{UnixEpochSeconds, 0});
+  EXPECT_EQ(Rep(UnixEpochSeconds).wholes(), Rep::MinWholes);
+  EXPECT_EQ(Rep(UnixEpochSeconds + span).wholes(), Rep::MaxWholes);
+  EXPECT_EQ(Unit(UnixEpochSeconds + span, 999'999'999'000).value(),
+      (UnitValue{UnixEpochSeconds + span, 999'999'999'000}));
+  EXPECT_TRUE(Unit(UnixEpochSeconds + span + 1).isPositiveInfinity());
+  EXPECT_TRUE(Unit(UnixEpochSeconds - 1, 999'999'999'000).isNegativeInfinity());
+  EXPECT_TRUE(Unit(-UnixEpochSeconds).isNegativeInfinity());
+  EXPECT_TRUE(Unit(Category::NaN).isNaN());
+  EXPECT_TRUE(Unit(1, -1).isNaN());
+  EXPECT_EQ(Unit(std::numeric_limits<Rep>::min().value()).value(),
+      (UnitValue{UnixEpochSeconds, 0}));
+  EXPECT_EQ(Unit(std::numeric_limits<Rep>::max().value()).value(),
+      (UnitValue{UnixEpochSeconds + span, 999'999'999'000}));
+  EXPECT_FALSE(RepAdapter<Rep>(UnixEpochSeconds, 0).isNegative());
+
+  // Moments keep their order and subtract to unbiased durations.
+  Moment<Unit> a(UnixEpochSeconds + 10, 250'000'000'000);
+  Moment<Unit> b(UnixEpochSeconds + span - 3);
+  EXPECT_LT(a, b);
+  EXPECT_EQ(b - a, Duration<>(span - 14, 750'000'000'000));
+  a += Duration<>(5, 1'000);
+  EXPECT_EQ(a.value(), (UnitValue{UnixEpochSeconds + 15, 250'000'001'000}));
+
+  // The epoch can also straddle zero, in which case negative values keep
+  // their negative fractions.
+  using Hundredths = details::ScalarUnit<details::CanonRep<int8_t, int8_t,
+      std::ratio<1, 1>, std::ratio<100, 1>, 100>>;
+  EXPECT_EQ(Hundredths(-26, -990'000'000'000).value(),
+      (UnitValue{-26, -990'000'000'000}));
+  EXPECT_EQ(Hundredths(226, 990'000'000'000).value(),
+      (UnitValue{226, 990'000'000'000}));
+  EXPECT_TRUE(Hundredths(-27).isNegativeInfinity());
+  EXPECT_TRUE(Hundredths(227).isPositiveInfinity());
+  EXPECT_TRUE(RepAdapter<Hundredths::RepT>(0, -10'000'000'000).isNegative());
+  EXPECT_FALSE(RepAdapter<Hundredths::RepT>(0, 10'000'000'000).isNegative());
+
+  // With larger wholes, the epoch is a whole number of them.
+  using Hours = details::ScalarUnit<details::CanonRep<int16_t, int16_t,
+      std::ratio<SecondsPerHour, 1>, std::ratio<10'000, 1>,
+      100'000 * SecondsPerHour>>;
+  EXPECT_EQ(Hours(100'000 * SecondsPerHour + 5400).value(),
+      (UnitValue{100'002 * SecondsPerHour, 0}));
+  EXPECT_EQ(Hours(SecondsPerHour * 70'000, 500'000'000'000).value(),
+      (UnitValue{70'000 * SecondsPerHour, 500'000'000'000}));
+  EXPECT_TRUE(Hours(SecondsPerHour * 60'000).isNegativeInfinity());
+}
+
 TEST(SpecialAddition, ChronosTest) {
   using Unit = details::ScalarUnit<>;
   EXPECT_EQ(Unit::addCategories(Category::Num, Category::Num), Category::Num);
@@ -857,3 +1109,1972 @@ TEST(ScalarMath, ChronosTest) {
   d1 *= Duration<>::Max / 2;
   //EXPECT_TRUE(d1.isNumber());
 }
+
+TEST(ConstexprMath, ChronosTest) {
+  constexpr int64_t maxSigned = std::numeric_limits<int64_t>::max();
+  constexpr int64_t minSigned = std::numeric_limits<int64_t>::min();
+
+  // These are all evaluated at compile time, through the portable backend.
+  constexpr Duration<> d1 = Duration<>(3) * 1000;
+  static_assert(d1.seconds() == 3000);
+  constexpr Duration<> d2 = Duration<>(0, 3, 4) * -3;
+  static_assert(d2.value() == UnitValue{-2, -PicosPerSecond / 4});
+  constexpr Duration<> d3 = Duration<>(0, PicosPerSecond - 1) * maxSigned;
+  static_assert(d3.value() == UnitValue{9223372036845552434, 963145224193});
+  constexpr Duration<> d4 = minSigned * Duration<>(0, PicosPerSecond - 1);
+  static_assert(d4.value() == UnitValue{-9223372036845552435, -963145224192});
+  constexpr Duration<> d5 = Duration<>(4, 1, 2) * maxSigned;
+  static_assert(d5.isPositiveInfinity());
+
+  // The same values at runtime, through the native backend.
+  int64_t m = 1000;
+  EXPECT_EQ(Duration<>(3) * m, d1);
+  m = -3;
+  EXPECT_EQ(Duration<>(0, 3, 4) * m, d2);
+  m = maxSigned;
+  EXPECT_EQ(Duration<>(0, PicosPerSecond - 1) * m, d3);
+  EXPECT_TRUE((Duration<>(4, 1, 2) * m).isPositiveInfinity());
+  m = minSigned;
+  EXPECT_EQ(Duration<>(0, PicosPerSecond - 1) * m, d4);
+}
+
+TEST(ScalarDivision, ChronosTest) {
+  constexpr int64_t maxSigned = std::numeric_limits<int64_t>::max();
+  constexpr int64_t minSigned = std::numeric_limits<int64_t>::min();
+  constexpr UnitSeconds InfP = SecondsTraits<>::InfP;
+  constexpr UnitSeconds InfN = SecondsTraits<>::InfN;
+  constexpr UnitSeconds NaN = SecondsTraits<>::NaN;
+
+  // Division by integers.
+  static_assert(Duration<>(7) / 2 == Duration<>(3, 1, 2));
+  EXPECT_EQ(Duration<>(7) / 2, Duration<>(3, 1, 2));
+  EXPECT_EQ(Duration<>(-7) / 2, Duration<>(-3, 1, 2));
+  EXPECT_EQ(Duration<>(7) / -2, Duration<>(-3, 1, 2));
+  EXPECT_EQ(Duration<>(0, 7) / 2, Duration<>(0, 3));
+  EXPECT_EQ(Duration<>(0, -7) / 2, Duration<>(0, -3));
+  EXPECT_EQ(Duration<>(1, 1) / -1, Duration<>(-1, -1));
+  EXPECT_EQ(Duration<>(Duration<>::Max) / -1, Duration<>(-Duration<>::Max));
+  EXPECT_EQ(Duration<>(Duration<>::Max) / minSigned, Duration<>(0, -999999999999));
+  EXPECT_EQ(Duration<>(0, 1, 3) / 1000, Duration<>(0, 333333333));
+  EXPECT_EQ((Duration<>(0, PicosPerSecond - 1) * maxSigned) / maxSigned,
+      Duration<>(0, PicosPerSecond - 1));
+  EXPECT_EQ((Duration<>(0, PicosPerSecond - 1) * minSigned) / minSigned,
+      Duration<>(0, PicosPerSecond - 1));
+  EXPECT_TRUE((Duration<>(1) / 0).isPositiveInfinity());
+  EXPECT_TRUE((Duration<>(0) / 0).isPositiveInfinity());
+  EXPECT_TRUE((Duration<>(0, -1) / 0).isNegativeInfinity());
+  EXPECT_TRUE((Duration<>(Category::InfP) / 2).isPositiveInfinity());
+  EXPECT_TRUE((Duration<>(Category::InfP) / -2).isNegativeInfinity());
+  EXPECT_TRUE((Duration<>(Category::InfN) / -2).isPositiveInfinity());
+  EXPECT_TRUE((Duration<>(Category::NaN) / 2).isNaN());
+  EXPECT_TRUE((Duration<>(Category::NaN) / 0).isNaN());
+
+  // Division by durations.
+  static_assert(Duration<>(10) / Duration<>(3) == 3);
+  auto dd = div(Duration<>(10), Duration<>(3));
+  EXPECT_EQ(dd.quot, 3);
+  EXPECT_EQ(dd.rem, Duration<>(1));
+  dd = div(Duration<>(-10), Duration<>(3));
+  EXPECT_EQ(dd.quot, -3);
+  EXPECT_EQ(dd.rem, Duration<>(-1));
+  dd = div(Duration<>(10), Duration<>(-3));
+  EXPECT_EQ(dd.quot, -3);
+  EXPECT_EQ(dd.rem, Duration<>(1));
+  dd = div(Duration<>(-10), Duration<>(-3));
+  EXPECT_EQ(dd.quot, 3);
+  EXPECT_EQ(dd.rem, Duration<>(-1));
+  EXPECT_EQ(Duration<>(1) / Duration<>(0, 1, 1000), 1000);
+  EXPECT_EQ(Duration<>(1, 1) % Duration<>(0, 1, 1000), Duration<>(0, 1));
+  EXPECT_EQ(Duration<>(5, 5) / Duration<>(5, 5), 1);
+  EXPECT_EQ(Duration<>(5, 4) / Duration<>(5, 5), 0);
+  EXPECT_EQ(Duration<>(5, 4) % Duration<>(5, 5), Duration<>(5, 4));
+  // The quotient can exceed 64 bits, so it saturates.
+  EXPECT_EQ(Duration<>(maxSigned / PicosPerSecond) / Duration<>(0, 1),
+      maxSigned / PicosPerSecond * PicosPerSecond);
+  EXPECT_EQ(Duration<>(maxSigned / PicosPerSecond + 1) / Duration<>(0, 1), InfP);
+  EXPECT_EQ(Duration<>(-Duration<>::Max) / Duration<>(0, 1), InfN);
+  EXPECT_TRUE((Duration<>(-Duration<>::Max) % Duration<>(0, 1)).isNaN());
+  // Divisors too large for 64 bits of picoseconds.
+  dd = div(Duration<>(Duration<>::Max), Duration<>(1'000'000'000, 7));
+  EXPECT_EQ(dd.quot, Duration<>::Max / 1'000'000'000);
+  EXPECT_EQ(Duration<>(dd.quot) * 1'000'000'000 +
+      Duration<>(0, 7) * dd.quot + dd.rem, Duration<>(Duration<>::Max));
+  EXPECT_LT(dd.rem, Duration<>(1'000'000'000, 7));
+  // Special values.
+  EXPECT_EQ(Duration<>(5) / Duration<>(Category::InfP), 0);
+  EXPECT_EQ(Duration<>(5) % Duration<>(Category::InfN), Duration<>(5));
+  EXPECT_EQ(Duration<>(Category::InfP) / Duration<>(5), InfP);
+  EXPECT_EQ(Duration<>(Category::InfP) / Duration<>(-5), InfN);
+  EXPECT_EQ(Duration<>(Category::InfP) / Duration<>(Category::InfP), NaN);
+  EXPECT_EQ(Duration<>(Category::NaN) / Duration<>(1), NaN);
+  EXPECT_EQ(Duration<>(1) / Duration<>(Category::NaN), NaN);
+  EXPECT_EQ(Duration<>(1) / Duration<>(0), InfP);
+  EXPECT_EQ(Duration<>(-1) / Duration<>(0), InfN);
+  EXPECT_EQ(Duration<>(0) / Duration<>(0), NaN);
+  EXPECT_TRUE((Duration<>(1) % Duration<>(0)).isNaN());
+
+  // Invariant divisors must agree with the general division.
+  const Duration<> widths[] = {Duration<>(0, 1), Duration<>(0, -7),
+      Duration<>(0, 1, 1000), Duration<>(60), Duration<>(-3600, -1),
+      Duration<>(86400 * 213), Duration<>(86400 * 214), Duration<>(0),
+      Duration<>(Category::InfP), Duration<>(Category::NaN)};
+  const Duration<> values[] = {Duration<>(0), Duration<>(0, 1),
+      Duration<>(0, -999'999'999'999), Duration<>(59, 999'999'999'999),
+      Duration<>(-61), Duration<>(1'234'567'890, 123'456'789'012),
+      Duration<>(-9'876'543'210, -1), Duration<>(Duration<>::Max),
+      Duration<>(-Duration<>::Max), Duration<>(Category::InfN),
+      Duration<>(Category::NaN)};
+  for (const auto& width : widths) {
+    DurationDivisor<> divisor(width);
+    for (const auto& value : values) {
+      auto expected = div(value, width);
+      auto actual = divisor.div(value);
+      EXPECT_EQ(actual.quot, expected.quot);
+      EXPECT_EQ(actual.rem.value(), expected.rem.value());
+      EXPECT_EQ(divisor.count(value), expected.quot);
+    }
+  }
+}
+
+TEST(PackedRep, ChronosTest) {
+  using Unit = details::Packed96ScalarUnit;
+  static_assert(sizeof(Unit) == 12);
+  static_assert(sizeof(Moment<Unit>) == 12);
+  static_assert(sizeof(Moment<>) == 16);
+  static_assert(is_scalar_unit_v<Unit>);
+
+  testCtors<Unit>();
+  testCtors<Duration<Unit>>();
+  testCtors<Moment<Unit>>();
+
+  // Whole nanoseconds are exact, in both directions.
+  const UnitValue exact[] = {{0, 0}, {1, 0}, {-1, 0}, {0, 1000}, {0, -1000},
+      {1, 999'999'999'000}, {-1, -999'999'999'000},
+      {SecondsPerYear * 2000, 123'456'789'000},
+      {-SecondsPerYear * 2000, -123'456'789'000},
+      {600'000'000'000'000'000, 999'999'999'000},
+      {-600'000'000'000'000'000, -1000}};
+  for (const auto& sss : exact) {
+    Unit u(sss);
+    EXPECT_EQ(u.value(), sss);
+    EXPECT_TRUE(u.isNumber());
+  }
+
+  // Finer values are truncated toward zero, to a multiple of 15.625 ps.
+  EXPECT_EQ(Unit(0, 1).value(), (UnitValue{0, 0}));
+  EXPECT_EQ(Unit(0, 16).value(), (UnitValue{0, 15}));
+  EXPECT_EQ(Unit(0, 32).value(), (UnitValue{0, 31}));
+  EXPECT_EQ(Unit(0, -32).value(), (UnitValue{0, -31}));
+  EXPECT_EQ(Unit(0, 125).value(), (UnitValue{0, 125}));
+  EXPECT_EQ(Unit(-2, 125).value(), (UnitValue{-2, -125}));
+
+  // Excess subseconds carry, and mismatched signs are NaN.
+  EXPECT_EQ(Unit(1, 2 * PicosPerSecond).value(), (UnitValue{3, 0}));
+  EXPECT_EQ(Unit(-1, 2 * PicosPerSecond).value(), (UnitValue{-3, 0}));
+  EXPECT_TRUE(Unit(1, -1).isNaN());
+
+  // The range is smaller than the default, so saturation comes sooner.
+  EXPECT_TRUE(Unit(620'000'000'000'000'000).isPositiveInfinity());
+  EXPECT_TRUE(Unit(-620'000'000'000'000'000).isNegativeInfinity());
+  EXPECT_TRUE(Unit(Unit::Max).isPositiveInfinity());
+  EXPECT_TRUE(Unit(Unit::Min).isNegativeInfinity());
+  EXPECT_TRUE(Unit(Unit::InfP).isPositiveInfinity());
+  EXPECT_TRUE(Unit(Unit::InfN).isNegativeInfinity());
+  using Adapter = Unit::AdapterT;
+  EXPECT_TRUE(Unit(Adapter(std::numeric_limits<Unit>::infinity()).value())
+                  .isPositiveInfinity());
+  Unit big(Adapter(std::numeric_limits<Unit>::max()).value());
+  EXPECT_TRUE(big.isNumber());
+  EXPECT_TRUE((details::DefaultScalarUnit(big) + Unit(0, 1000)).isNumber());
+  EXPECT_TRUE((big + Unit(0, 1000)).isPositiveInfinity());
+  big += Unit(1);
+  EXPECT_TRUE(big.isPositiveInfinity());
+
+  // Arithmetic and comparison work through the adapter, and mix with the
+  // default representation.
+  Duration<Unit> d(1, 500'000'000'000);
+  Moment<Unit> m(1000);
+  m += d;
+  EXPECT_EQ(m.value(), (UnitValue{1001, 500'000'000'000}));
+  m -= Duration<>(2);
+  EXPECT_EQ(m, Moment<>(999, 500'000'000'000));
+  EXPECT_LT(Moment<>(999), m);
+  EXPECT_EQ(m - Moment<Unit>(999), Duration<>(0, 500'000'000'000));
+  d *= -3;
+  EXPECT_EQ(d, Duration<>(-4, -500'000'000'000));
+  d /= 2;
+  EXPECT_EQ(d.value(), (UnitValue{-2, -250'000'000'000}));
+  EXPECT_EQ(Duration<>(d) / Duration<>(0, 250'000'000'000), -9);
+}
+
+TEST(WideRep, ChronosTest) {
+  using Unit = details::Picos128ScalarUnit;
+  using Default = details::DefaultScalarUnit;
+  static_assert(sizeof(Unit) == 16);
+  static_assert(sizeof(Duration<Unit>) == 16);
+  static_assert(is_scalar_unit_v<Unit>);
+  static_assert(details::has_direct_arithmetic_v<Unit::AdapterT>);
+  static_assert(!details::has_direct_arithmetic_v<Default::AdapterT>);
+
+  testCtors<Unit>();
+  testCtors<Duration<Unit>>();
+  testCtors<Moment<Unit>>();
+
+  // Every value round-trips exactly, across the whole default range.
+  const UnitValue exact[] = {{0, 0}, {1, 0}, {-1, 0}, {0, 1}, {0, -1},
+      {1, 999'999'999'999}, {-1, -999'999'999'999},
+      {Unit::Max, 999'999'999'999}, {Unit::Min, -999'999'999'999}};
+  for (const auto& sss : exact) {
+    Unit u(sss);
+    EXPECT_EQ(u.value(), sss);
+    EXPECT_TRUE(u.isNumber());
+  }
+  static_assert(Unit(-3, -5).value() == UnitValue{-3, -5});
+
+  // Excess subseconds carry, mismatched signs are NaN, and the range
+  // saturates where the default does.
+  EXPECT_EQ(Unit(1, 2 * PicosPerSecond).value(), (UnitValue{3, 0}));
+  EXPECT_EQ(Unit(-1, 2 * PicosPerSecond).value(), (UnitValue{-3, 0}));
+  EXPECT_TRUE(Unit(1, -1).isNaN());
+  EXPECT_TRUE(Unit(Unit::Max, PicosPerSecond).isPositiveInfinity());
+  EXPECT_TRUE(Unit(Unit::Min, -PicosPerSecond).isNegativeInfinity());
+  EXPECT_TRUE(Unit(Unit::InfP).isPositiveInfinity());
+  EXPECT_TRUE(Unit(Unit::InfN).isNegativeInfinity());
+
+  // Direct arithmetic matches the default, including carries, saturation,
+  // and special values.
+  const Unit nan = Unit::getNaN(), infP(Unit::InfP), infN(Unit::InfN);
+  const UnitValue cases[] = {{0, 0}, {1, 500'000'000'000},
+      {-1, -500'000'000'000}, {0, 999'999'999'999}, {0, -999'999'999'999},
+      {Unit::Max, 0}, {Unit::Min, 0}, {Unit::Max, 999'999'999'999},
+      {Unit::NaN, 0}, {Unit::InfP, 0}, {Unit::InfN, 0}};
+  for (const auto& l : cases) {
+    for (const auto& r : cases) {
+      Unit sum(l), diff(l);
+      Default sumD(l), diffD(l);
+      sum += Unit(r);
+      sumD += Default(r);
+      diff -= Unit(r);
+      diffD -= Default(r);
+      EXPECT_EQ(sum.value(), sumD.value());
+      EXPECT_EQ(diff.value(), diffD.value());
+      EXPECT_EQ(Unit(l) <=> Unit(r),
+          Default(l) <=> Default(r));
+    }
+  }
+  EXPECT_TRUE((infP + infN).isNaN());
+  EXPECT_TRUE((nan + Unit(1)).isNaN());
+
+  // Moments and durations opt in by naming the scalar.
+  Moment<Unit> m(1000);
+  m += Duration<Unit>(0, 750'000'000'000);
+  m += Duration<Unit>(0, 750'000'000'000);
+  EXPECT_EQ(m.value(), (UnitValue{1001, 500'000'000'000}));
+  EXPECT_EQ(m, Moment<>(1001, 500'000'000'000));
+  EXPECT_LT(Moment<Unit>(1001), m);
+  m -= Duration<Unit>(2000);
+  EXPECT_EQ(m.value(), (UnitValue{-998, -500'000'000'000}));
+}
+
+TEST(NanosRep, ChronosTest) {
+  using Unit = details::Int64NanosScalarUnit;
+  using Unix = details::UnixNanosScalarUnit;
+  static_assert(sizeof(Unit) == 8);
+  static_assert(sizeof(Moment<Unix>) == 8);
+  static_assert(details::has_direct_arithmetic_v<Unit::AdapterT>);
+  static_assert(details::has_direct_compare_v<Unit::AdapterT>);
+  static_assert(
+      details::has_direct_arithmetic_v<Unix::AdapterT, Unit::AdapterT>);
+  static_assert(!details::has_direct_compare_v<Unix::AdapterT, Unit::AdapterT>);
+  static_assert(!details::has_direct_arithmetic_v<Unit::AdapterT,
+      Unix::AdapterT>);
+
+  testCtors<Unit>();
+  testCtors<Duration<Unit>>();
+
+  // Durations are counted from zero.
+  Duration<Unit> d(1, 500'000'000'000);
+  EXPECT_EQ(d.rep().count(), 1'500'000'000);
+  EXPECT_EQ(Duration<Unit>(-1, -500'000'000'000).rep().count(),
+      -1'500'000'000);
+  EXPECT_EQ(Duration<Unit>(0, 499).rep().count(), 0);
+  EXPECT_EQ(Duration<Unit>(0, -500).rep().count(), -1);
+  EXPECT_EQ(Duration<Unit>(details::Int64NanosRep<>(-7)).value(),
+      (UnitValue{0, -7000}));
+  using NanosAdapter = Unit::AdapterT;
+  EXPECT_TRUE(NanosAdapter(details::Int64NanosRep<>(-5)).isNegative());
+  EXPECT_TRUE(
+      NanosAdapter(details::Int64NanosRep<>(-1'000'000'005)).isNegative());
+  EXPECT_FALSE(NanosAdapter(details::Int64NanosRep<>(5)).isNegative());
+  EXPECT_FALSE(NanosAdapter(details::Int64NanosRep<>(0)).isNegative());
+  EXPECT_TRUE(Duration<Unit>(293 * SecondsPerYear).isPositiveInfinity());
+  EXPECT_TRUE(Duration<Unit>(-293 * SecondsPerYear).isNegativeInfinity());
+
+  // Moments can hold Unix nanoseconds as they arrive.
+  constexpr int64_t stamp = 1'700'000'000'123'456'789;
+  Moment<Unix> m{details::UnixNanosRep(stamp)};
+  EXPECT_EQ(m.rep().count(), stamp);
+  EXPECT_EQ(m.value(),
+      (UnitValue{UnixEpochSeconds + 1'700'000'000, 123'456'789'000}));
+  EXPECT_EQ(m, Moment<>(UnixEpochSeconds + 1'700'000'000, 123'456'789'000));
+  EXPECT_EQ(Moment<Unix>(m.value()).rep().count(), stamp);
+  Moment<Unix> before{details::UnixNanosRep(-1)};
+  EXPECT_EQ(before.value(), (UnitValue{UnixEpochSeconds - 1, 999'999'999'000}));
+  EXPECT_EQ(Moment<Unix>(UnixEpochSeconds).rep().count(), 0);
+  EXPECT_TRUE(Moment<Unix>(0).isNegativeInfinity());
+  EXPECT_TRUE(Moment<Unix>(Category::NaN).isNaN());
+
+  // Same-rep arithmetic stays in the representation, including the epoch
+  // adjustment. Values far from the epoch saturate, and with the Unix epoch,
+  // that includes the difference between two moments.
+  using Near = details::ScalarUnit<details::Int64NanosRep<1000>>;
+  static_assert(std::is_same_v<decltype(Near() + Near()), const Near>);
+  EXPECT_EQ((Near(1010, 5000) + Near(-3, -7000)).value(),
+      (UnitValue{1006, 999'999'998'000}));
+  EXPECT_EQ((Near(1010, 5000) - Near(-3, -7000)).value(),
+      (UnitValue{1013, 12'000}));
+  EXPECT_EQ((Near(990) - Near(1000)).value(), (UnitValue{-10, 0}));
+  Moment<Unix> a(UnixEpochSeconds + 10, 250'000'000'000);
+  Moment<Unix> b(UnixEpochSeconds - 3);
+  EXPECT_TRUE((Unix(a.rep()) - Unix(b.rep())).isNegativeInfinity());
+  EXPECT_TRUE((Unix(a.rep()) + Unix(b.rep())).isPositiveInfinity());
+  EXPECT_EQ(a - b, Duration<>(13, 250'000'000'000));
+  EXPECT_LT(b, a);
+  EXPECT_FALSE(Moment<Unix>(Category::NaN) < a);
+
+  // Moments and durations combine directly, even though only the moment has
+  // an epoch, and the result keeps the representation when they match.
+  m += Duration<Unit>(1, 1000);
+  EXPECT_EQ(m.rep().count(), stamp + 1'000'000'001);
+  m -= Duration<Unit>(2);
+  EXPECT_EQ(m.rep().count(), stamp - 999'999'999);
+  m += Duration<>(0, 1'000);
+  EXPECT_EQ(m.rep().count(), stamp - 999'999'998);
+  m += Duration<Unit>(Category::InfP);
+  EXPECT_TRUE(m.isPositiveInfinity());
+  auto total = d + d;
+  static_assert(std::is_same_v<decltype(total), Duration<Unit>>);
+  EXPECT_EQ(total.rep().count(), 3'000'000'000);
+  auto wide = d + Duration<>(1);
+  static_assert(std::is_same_v<decltype(wide), Duration<>>);
+  EXPECT_EQ(wide.value(), (UnitValue{2, 500'000'000'000}));
+  Duration<Unit> big(std::numeric_limits<details::Int64NanosRep<>>::max());
+  EXPECT_TRUE((big + Duration<Unit>(0, 1000)).isPositiveInfinity());
+  EXPECT_TRUE((Duration<>(big) + Duration<Unit>(0, 1000)).isNumber());
+}
+
+namespace {
+// Values near every boundary that the column kernels handle: carries, sign
+// changes, saturation, and each special value.
+vector<UnitValue> columnEdgeValues() {
+  using T = SecondsTraits<>;
+  constexpr UnitPicos almost = PicosPerSecond - 1;
+  constexpr UnitSeconds half = int64_t(1) << 62;
+  vector<UnitValue> values{{0, 0}, {0, 1}, {0, -1}, {0, almost}, {0, -almost},
+      {1, 0}, {-1, 0}, {1, almost}, {-1, -almost}, {5, 500'000'000'000},
+      {-5, -500'000'000'000}, {T::Max, 0}, {T::Max, almost}, {T::Min, 0},
+      {T::Min, -almost}, {T::Max - 1, almost}, {T::Min + 1, -almost},
+      {half, 0}, {-half, 0}, {-half, -1}, {T::InfP, 0}, {T::InfN, 0},
+      {T::NaN, 0}};
+  return values;
+}
+
+template<ColumnBackend Backend>
+void checkColumnOps(const vector<UnitValue>& values) {
+  if constexpr (ColumnOps<Backend>::available) {
+    using Ops = ColumnOps<Backend>;
+    // Pair every value with every other, in arrays whose lengths aren't a
+    // multiple of any vector width, so that the leftovers are covered, too.
+    size_t n = values.size() * values.size();
+    vector<int64_t> sL(n), ssL(n), sR(n), ssR(n), s(n), ss(n);
+    for (size_t i = 0; i < n; ++i) {
+      const auto& l = values[i / values.size()];
+      const auto& r = values[i % values.size()];
+      sL[i] = l.s, ssL[i] = l.ss, sR[i] = r.s, ssR[i] = r.ss;
+    }
+    Ops::add(sL.data(), ssL.data(), sR.data(), ssR.data(), s.data(),
+        ss.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+      auto expected = Duration<>(UnitValue{sL[i], ssL[i]}) +
+          Duration<>(UnitValue{sR[i], ssR[i]});
+      EXPECT_EQ((UnitValue{s[i], ss[i]}), expected.value()) << i;
+    }
+    Ops::sub(sL.data(), ssL.data(), sR.data(), ssR.data(), s.data(),
+        ss.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+      auto expected = Duration<>(UnitValue{sL[i], ssL[i]}) -
+          Duration<>(UnitValue{sR[i], ssR[i]});
+      EXPECT_EQ((UnitValue{s[i], ss[i]}), expected.value()) << i;
+    }
+    vector<int8_t> cmp(values.size());
+    for (const auto& r : values) {
+      Ops::addValue(sL.data(), ssL.data(), r, s.data(), ss.data(),
+          values.size());
+      Ops::compareValue(sL.data(), ssL.data(), r, cmp.data(), values.size());
+      for (size_t i = 0; i < values.size(); ++i) {
+        Duration<> l(UnitValue{sL[i], ssL[i]});
+        EXPECT_EQ((UnitValue{s[i], ss[i]}), (l + Duration<>(r)).value());
+        auto order = l <=> Duration<>(r);
+        EXPECT_EQ(cmp[i], (order < 0) ? -1 : (order == 0) ? 0 : 1);
+      }
+    }
+  }
+}
+} // namespace
+
+TEST(Column, ChronosTest) {
+  // A sum that lands on the encoding of NaN is an underflow.
+  constexpr UnitSeconds half = int64_t(1) << 62;
+  EXPECT_TRUE((Duration<>(-half) + Duration<>(-half)).isNegativeInfinity());
+
+  const auto values = columnEdgeValues();
+  checkColumnOps<ColumnBackend::Scalar>(values);
+  checkColumnOps<ColumnBackend::Avx2>(values);
+  checkColumnOps<ColumnBackend::Avx512>(values);
+
+  MomentColumn moments;
+  moments.push_back(Moment<>(100, 250'000'000'000));
+  moments.push_back(Moment<details::Int64NanosScalarUnit>(-3));
+  moments.push_back(Moment<>(Category::NaN));
+  moments.push_back(Moment<>(Category::InfP));
+  moments.push_back(Moment<>(0, 999'999'999'999));
+  ASSERT_EQ(moments.size(), 5u);
+  EXPECT_EQ(moments[1], Moment<>(-3));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(moments.seconds()) % 64, 0u);
+
+  MomentColumn shifted = moments;
+  shifted += Duration<>(-3600, -500'000'000'000);
+  EXPECT_EQ(shifted[0], Moment<>(-3500, -250'000'000'000));
+  EXPECT_EQ(shifted[1], Moment<>(-3603, -500'000'000'000));
+  EXPECT_TRUE(shifted[2].isNaN());
+  EXPECT_TRUE(shifted[3].isPositiveInfinity());
+  shifted -= Duration<>(-3600, -500'000'000'000);
+  EXPECT_EQ(shifted[0], moments[0]);
+  EXPECT_EQ(shifted[4], moments[4]);
+
+  DurationColumn deltas = shifted - moments;
+  ASSERT_EQ(deltas.size(), moments.size());
+  EXPECT_EQ(deltas[0], Duration<>(0));
+  EXPECT_TRUE(deltas[2].isNaN());
+  EXPECT_TRUE(deltas[3].isNaN());
+  deltas += Duration<>(1);
+  EXPECT_EQ(deltas[1], Duration<>(1));
+  deltas -= deltas;
+  EXPECT_EQ(deltas[0], Duration<>(0));
+  EXPECT_TRUE(deltas[2].isNaN());
+
+  DurationColumn offsets(moments.size());
+  offsets.set(1, Duration<details::Int64NanosScalarUnit>(2));
+  moments += offsets;
+  EXPECT_EQ(moments[1], Moment<>(-1));
+  moments -= offsets;
+  EXPECT_EQ(moments[1], Moment<>(-3));
+
+  // Columns of different sizes combine where both have values. Updating in
+  // place keeps the rest, and a separate result only has those positions.
+  DurationColumn fewer(2);
+  fewer.set(0, Duration<>(1));
+  fewer.set(1, Duration<>(1));
+  MomentColumn longer = moments;
+  longer += fewer;
+  ASSERT_EQ(longer.size(), moments.size());
+  EXPECT_EQ(longer[1], Moment<>(-2));
+  EXPECT_EQ(longer.value(4), moments.value(4));
+  longer -= fewer;
+  EXPECT_EQ(longer.value(1), moments.value(1));
+  DurationColumn more(moments.size() + 3);
+  longer += more;
+  ASSERT_EQ(longer.size(), moments.size());
+  MomentColumn shorter(2);
+  EXPECT_EQ((shorter - moments).size(), 2u);
+  EXPECT_EQ((moments - shorter).size(), 2u);
+
+  int8_t cmp[5];
+  moments.compare(Moment<>(0), cmp);
+  EXPECT_EQ(cmp[0], 1);
+  EXPECT_EQ(cmp[1], -1);
+  EXPECT_EQ(cmp[2], 1);
+  EXPECT_EQ(cmp[3], 1);
+  EXPECT_EQ(cmp[4], 1);
+  moments.compare(Moment<>(0, 999'999'999'999), cmp);
+  EXPECT_EQ(cmp[4], 0);
+}
+
+namespace {
+// Checks every reduction of a backend against folding the durations in order.
+template<ColumnBackend Backend>
+void checkColumnReductions(const DurationColumn& column) {
+  if constexpr (ColumnOps<Backend>::available) {
+    using Ops = ColumnOps<Backend>;
+    const int64_t* s = column.seconds();
+    const int64_t* ss = column.subseconds();
+    size_t n = column.size();
+    Duration<> total, least(Category::InfP), greatest(Category::InfN);
+    CategoryCounts counts{};
+    bool nan = false;
+    for (size_t i = 0; i < n; ++i) {
+      total += column[i];
+      nan |= column[i].isNaN();
+      if (column[i] < least) least = column[i];
+      if (column[i] > greatest) greatest = column[i];
+      ++counts[static_cast<size_t>(column[i].category())];
+    }
+    if (nan) least = greatest = Duration<>(Category::NaN);
+    EXPECT_EQ(Ops::sum(s, ss, n), total.value());
+    EXPECT_EQ(Ops::minimum(s, ss, n), least.value());
+    EXPECT_EQ(Ops::maximum(s, ss, n), greatest.value());
+    EXPECT_EQ(Ops::countCategories(s, n), counts);
+  }
+}
+
+void checkColumnReductions(const DurationColumn& column) {
+  checkColumnReductions<ColumnBackend::Scalar>(column);
+  checkColumnReductions<ColumnBackend::Avx2>(column);
+  checkColumnReductions<ColumnBackend::Avx512>(column);
+}
+} // namespace
+
+TEST(ColumnReduce, ChronosTest) {
+  mt19937_64 gen(7);
+  uniform_int_distribution<int64_t> secs(-1'000'000, 1'000'000);
+  uniform_int_distribution<int64_t> picos(0, PicosPerSecond - 1);
+  vector<Duration<>> durations(1001);
+  for (auto& d : durations) {
+    int64_t sec = secs(gen), ps = picos(gen);
+    d = Duration<>(sec, sec < 0 ? -ps : ps);
+  }
+  DurationColumn column(durations.begin(), durations.end());
+  ASSERT_EQ(column.size(), durations.size());
+  checkColumnReductions(DurationColumn());
+  checkColumnReductions(column);
+  EXPECT_EQ(DurationColumn().sum(), Duration<>(0));
+  EXPECT_TRUE(DurationColumn().minimum().isPositiveInfinity());
+
+  // Each special value, alone and together.
+  using T = SecondsTraits<>;
+  for (auto special : {T::InfP, T::InfN, T::NaN}) {
+    DurationColumn with = column;
+    with.set(500, Duration<>(UnitValue{special, 0}));
+    checkColumnReductions(with);
+    with.set(3, Duration<>(Category::InfP));
+    checkColumnReductions(with);
+  }
+  DurationColumn opposed = column;
+  opposed.set(10, Duration<>(Category::InfP));
+  opposed.set(990, Duration<>(Category::InfN));
+  checkColumnReductions(opposed);
+  EXPECT_TRUE(opposed.sum().isNaN());
+  EXPECT_EQ(opposed.countCategories(), (CategoryCounts{999, 0, 1, 1}));
+
+  // Running totals that saturate, only to be pulled back into range, give
+  // what adding them up in order gives, which stays infinite.
+  DurationColumn huge = column;
+  huge.set(0, Duration<>(T::Max));
+  huge.set(1, Duration<>(T::Max));
+  huge.set(2, Duration<>(-T::Max));
+  checkColumnReductions(huge);
+  EXPECT_TRUE(huge.sum().isPositiveInfinity());
+  huge.set(700, Duration<>(Category::InfN));
+  checkColumnReductions(huge);
+  EXPECT_TRUE(huge.sum().isNaN());
+
+  // Totals near the limit that don't overflow are exact.
+  DurationColumn near;
+  for (int i = 0; i < 37; ++i)
+    near.push_back(Duration<>(T::Max / 40, -999'999'999'999));
+  checkColumnReductions(near);
+  near.set(36, Duration<>(-1));
+  checkColumnReductions(near);
+
+  MomentColumn moments;
+  moments.push_back(Moment<>(5));
+  moments.push_back(Moment<>(-5, -1));
+  moments.push_back(Moment<>(Category::InfP));
+  EXPECT_EQ(moments.minimum(), Moment<>(-5, -1));
+  EXPECT_TRUE(moments.maximum().isPositiveInfinity());
+}
+
+TEST(RadixSort, ChronosTest) {
+  using T = SecondsTraits<>;
+  // Keys keep the order, put NaN last, and read back exactly.
+  vector<UnitValue> ordered{{T::InfN, 0}, {T::Min, -999'999'999'999},
+      {-1, 0}, {0, -1}, {0, 0}, {0, 1}, {1, 999'999'999'999},
+      {T::Max, 999'999'999'999}, {T::InfP, 0}, {T::NaN, 0}};
+  for (size_t i = 0; i < ordered.size(); ++i)
+    EXPECT_EQ(fromOrderKey(toOrderKey(ordered[i])), ordered[i]);
+  for (size_t i = 1; i < ordered.size(); ++i)
+    EXPECT_LT(toOrderKey(ordered[i - 1]), toOrderKey(ordered[i]));
+
+  auto less = [](const Moment<>& a, const Moment<>& b) {
+    if (a.isNaN()) return false;
+    return b.isNaN() || a < b;
+  };
+  auto same = [](const Moment<>& a, const Moment<>& b) {
+    return a.value() == b.value();
+  };
+  struct Event {
+    Moment<> at;
+    size_t id;
+  };
+
+  // Few distinct seconds, so that there are plenty of ties to keep in order.
+  for (size_t n : {0, 1, 300, 5000, 100'000}) {
+    mt19937_64 gen(n);
+    uniform_int_distribution<int64_t> secs(-50, 50);
+    uniform_int_distribution<int64_t> picos(0, 3);
+    uniform_int_distribution<int> special(0, 99);
+    vector<Moment<>> moments(n);
+    vector<Event> events(n);
+    for (size_t i = 0; i < n; ++i) {
+      int64_t sec = secs(gen), ps = picos(gen) * 250'000'000'000;
+      moments[i] = Moment<>(sec, sec < 0 ? -ps : ps);
+      if (int pick = special(gen); pick < 3)
+        moments[i] =
+            Moment<>(UnitValue{array{T::NaN, T::InfN, T::InfP}[pick], 0});
+      events[i] = Event{moments[i], i};
+    }
+    auto expected = moments;
+    stable_sort(expected.begin(), expected.end(), less);
+    auto expectedEvents = events;
+    stable_sort(expectedEvents.begin(), expectedEvents.end(),
+        [&](const Event& a, const Event& b) { return less(a.at, b.at); });
+
+    auto sorted = moments;
+    radixSort(sorted.begin(), sorted.end());
+    EXPECT_TRUE(equal(sorted.begin(), sorted.end(), expected.begin(), same));
+    sorted = moments;
+    parallelRadixSort(sorted.begin(), sorted.end(), identity{}, 4);
+    EXPECT_TRUE(equal(sorted.begin(), sorted.end(), expected.begin(), same));
+
+    MomentColumn column(moments.begin(), moments.end());
+    radixSort(column);
+    for (size_t i = 0; i < n; ++i)
+      EXPECT_EQ(column.value(i), expected[i].value());
+
+    // Whole records, by projection or by permutation, and stably.
+    auto records = events;
+    parallelRadixSort(records.begin(), records.end(), &Event::at, 4);
+    auto order = radixArgsort(events.begin(), events.end(), &Event::at);
+    ASSERT_EQ(order.size(), n);
+    for (size_t i = 0; i < n; ++i) {
+      EXPECT_EQ(records[i].id, expectedEvents[i].id);
+      EXPECT_EQ(order[i], expectedEvents[i].id);
+    }
+
+    // Records that can only be moved end up in the same places.
+    struct Owned {
+      Moment<> at;
+      unique_ptr<size_t> id;
+    };
+    vector<Owned> owned;
+    for (const Event& event : events)
+      owned.push_back(Owned{event.at, make_unique<size_t>(event.id)});
+    radixSort(owned.begin(), owned.end(), &Owned::at);
+    for (size_t i = 0; i < n; ++i) {
+      ASSERT_TRUE(owned[i].id);
+      EXPECT_EQ(*owned[i].id, expectedEvents[i].id);
+    }
+  }
+
+  // Elements that aren't their own keys are moved rather than rebuilt.
+  using Nanos = Duration<details::Int64NanosScalarUnit>;
+  vector<Nanos> nanos;
+  for (int64_t ns : {5, -3, 0, 7, -3, 1'000'000'001})
+    nanos.push_back(Nanos(details::Int64NanosRep<>(ns)));
+  radixSort(nanos.begin(), nanos.end());
+  EXPECT_TRUE(is_sorted(nanos.begin(), nanos.end()));
+  EXPECT_EQ(nanos.front(), Duration<>(0, -3'000));
+  EXPECT_EQ(nanos.back(), Duration<>(1, 1'000));
+}
+
+TEST(KeyEncoding, ChronosTest) {
+  using T = SecondsTraits<>;
+  // Values in order, across every length of seconds, with the extremes.
+  vector<Moment<>> ordered{Moment<>(Category::InfN),
+      Moment<>(T::Min, -999'999'999'999), Moment<>(T::Min, -1),
+      Moment<>(T::Min)};
+  for (int64_t s = T::Min + 1; s < -1; s /= 251)
+    ordered.insert(ordered.end(),
+        {Moment<>(s, -1), Moment<>(s), Moment<>(s + 1, -999'999'999'999)});
+  ordered.insert(ordered.end(),
+      {Moment<>(-1, -5), Moment<>(-1), Moment<>(0, -999'999'999'999),
+          Moment<>(0, -1), Moment<>(0), Moment<>(0, 1), Moment<>(0, 1 << 20),
+          Moment<>(0, 999'999'999'999)});
+  for (int64_t s = 1; s < T::Max / 251; s *= 251)
+    ordered.insert(ordered.end(), {Moment<>(s), Moment<>(s, 1)});
+  ordered.insert(ordered.end(),
+      {Moment<>(T::Max), Moment<>(T::Max, 999'999'999'999),
+          Moment<>(Category::InfP), Moment<>(Category::NaN)});
+
+  vector<array<uint8_t, KeySize>> fixed;
+  vector<vector<uint8_t>> compact;
+  for (const auto& m : ordered) {
+    fixed.push_back(encodeKey(m));
+    Moment<> back(7);
+    ASSERT_TRUE(decodeKey(fixed.back().data(), back));
+    EXPECT_EQ(back.value(), m.value());
+
+    uint8_t buf[MaxCompactKeySize];
+    size_t len = encodeCompactKey(m, buf);
+    ASSERT_LE(len, MaxCompactKeySize);
+    compact.emplace_back(buf, buf + len);
+    back = Moment<>(7);
+    EXPECT_EQ(decodeCompactKey(buf, len, back), len);
+    EXPECT_EQ(back.value(), m.value());
+    // Nothing shorter is a key.
+    EXPECT_EQ(decodeCompactKey(buf, len - 1, back), 0u);
+  }
+  // Byte order is value order, and nothing is a prefix of anything else.
+  for (size_t i = 1; i < ordered.size(); ++i) {
+    EXPECT_LT(fixed[i - 1], fixed[i]) << i;
+    EXPECT_LT(compact[i - 1], compact[i]) << i;
+    EXPECT_FALSE(equal(compact[i - 1].begin(), compact[i - 1].end(),
+        compact[i].begin(), compact[i].begin() +
+            min(compact[i - 1].size(), compact[i].size())) &&
+        compact[i - 1].size() != compact[i].size()) << i;
+  }
+
+  uint8_t buf[MaxCompactKeySize];
+  EXPECT_EQ(encodeCompactKey(Moment<>(Category::NaN), buf), 1u);
+  EXPECT_EQ(encodeCompactKey(Moment<>(0), buf), 2u);
+  Moment<> now(UnixEpochSeconds + 1'800'000'000);
+  EXPECT_EQ(encodeCompactKey(now, buf), 7u);
+  EXPECT_EQ(encodeCompactKey(now + Duration<>(0, 123'456'789'123), buf), 12u);
+  EXPECT_EQ(encodeKey(Duration<>(-3, -7)), encodeKey(Moment<>(-3, -7)));
+  EXPECT_EQ(encodeCompactKey(Duration<>(-3, -7), buf), 8u);
+  Duration<> d;
+  EXPECT_EQ(decodeCompactKey(buf, 8, d), 8u);
+  EXPECT_EQ(d, Duration<>(-3, -7));
+
+  static_assert([] {
+    uint8_t bytes[MaxCompactKeySize]{};
+    Duration<> back;
+    size_t len = encodeCompactKey(Duration<>(-3, -7), bytes);
+    return decodeCompactKey(bytes, len, back) == len &&
+        back == Duration<>(-3, -7) &&
+        decodeKey(encodeKey(back).data(), back) && back == Duration<>(-3, -7);
+  }());
+
+  // Bytes that aren't keys, including longer ways of writing real ones.
+  Moment<> m(7);
+  auto key = encodeKey(Moment<>(5, 1));
+  key[8] = 1;
+  EXPECT_FALSE(decodeKey(key.data(), m));
+  key = encodeKey(Moment<>(5, 1));
+  key[10] = 0xFF;
+  EXPECT_FALSE(decodeKey(key.data(), m));
+  key = encodeKey(Moment<>(Category::InfP));
+  key[15] ^= 1;
+  EXPECT_FALSE(decodeKey(key.data(), m));
+  const vector<vector<uint8_t>> bad{{}, {0x80}, {0x81, 0x00, 0x00},
+      {0x7E, 0xFF, 0x01, 0x00}, {0x80, 0x01, 0x00}, {0x80, 0x03},
+      {0x80, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00}, {0x89},
+      {0x77}, {0x80, 0xFF, 0xFE}, {0x78, 0x80, 0, 0, 0, 0, 0, 0, 1, 0}};
+  for (const auto& bytes : bad)
+    EXPECT_EQ(decodeCompactKey(bytes.data(), bytes.size(), m), 0u);
+  EXPECT_EQ(m, Moment<>(7));
+}
+
+TEST(RawCompare, ChronosTest) {
+  using Minutes = details::CanonRep<int32_t, int32_t, std::ratio<60, 1>>;
+  static_assert(is_raw_comparable_v<details::DefaultBaseRep>);
+  static_assert(is_raw_comparable_v<details::Unix32Rep>);
+  static_assert(is_raw_comparable_v<Minutes>);
+  static_assert(is_raw_comparable_v<details::Packed96Rep>);
+  static_assert(is_raw_comparable_v<details::Picos128Rep>);
+  static_assert(!is_raw_comparable_v<UnitValue>);
+  static_assert(details::has_direct_compare_v<DefaultAdapter>);
+  static_assert(details::has_direct_compare_v<RepAdapter<details::Unix32Rep>>);
+  static_assert(details::has_direct_compare_v<RepAdapter<details::Packed96Rep>>);
+  static_assert(!details::has_direct_compare_v<DefaultAdapter,
+                RepAdapter<details::Unix32Rep>>);
+
+  // Comparing raw fields agrees with comparing values, for every pair.
+  auto check = [](auto unit, UnitSeconds base) {
+    using Unit = decltype(unit);
+    vector<Unit> units{Unit(Category::NaN), Unit(Category::InfN),
+        Unit(Category::InfP)};
+    for (UnitSeconds s : {0, 1, 59, 60, 61, 120, 86'400})
+      for (UnitPicos ss : {0LL, 1'000LL, 500'000'000'000LL, 999'999'999'000LL})
+        units.insert(units.end(), {Unit(base + s, ss), Unit(base - s, -ss)});
+    for (const auto& a : units) {
+      for (const auto& b : units) {
+        UnitValue l = a.value(), r = b.value();
+        auto expected = (l.s == SecondsTraits<>::NaN ||
+                            r.s == SecondsTraits<>::NaN)
+            ? std::partial_ordering::greater
+            : std::partial_ordering(l <=> r);
+        EXPECT_EQ(a <=> b, expected) << l.s << "." << l.ss << " vs "
+                                     << r.s << "." << r.ss;
+        EXPECT_EQ(a == b, expected == 0);
+      }
+    }
+  };
+  check(details::ScalarUnit<>(), 0);
+  check(details::ScalarUnit<>(), 1'000'000);
+  check(details::ScalarUnit<details::Unix32Rep>(),
+      UnixEpochSeconds + 1'700'000'000);
+  check(details::ScalarUnit<Minutes>(), 0);
+  check(details::ScalarUnit<Minutes>(), 60'000'000);
+  check(details::Packed96ScalarUnit(), 0);
+  check(details::Packed96ScalarUnit(), -60'000'000);
+
+  // Ordered containers take the same path.
+  std::map<Moment<details::ScalarUnit<details::Unix32Rep>>, int> byTime;
+  for (int i = 5; i > 0; --i)
+    byTime[Moment<details::ScalarUnit<details::Unix32Rep>>(
+        UnixEpochSeconds + i, i * 1'000)] = i;
+  int expected = 1;
+  for (const auto& [at, i] : byTime) EXPECT_EQ(i, expected++);
+}
+
+TEST(Hash, ChronosTest) {
+  using Unix32 = details::ScalarUnit<details::Unix32Rep>;
+  static_assert(hashValue(UnitValue{1, 2}) != hashValue(UnitValue{2, 1}));
+  static_assert(ScalarHash()(Moment<>(5)) == hashValue(UnitValue{5, 0}));
+
+  // Equal values hash equally, whatever their representation.
+  const UnitSeconds base = UnixEpochSeconds + 1'700'000'000;
+  for (UnitPicos ss : {0LL, 1'000LL, 999'999'999'000LL}) {
+    Moment<> m(base, ss);
+    Moment<Unix32> u(m);
+    EXPECT_EQ(hash<Moment<>>()(m), hash<Moment<Unix32>>()(u));
+    EXPECT_EQ(hash<details::ScalarUnit<>>()(details::ScalarUnit<>(base, ss)),
+        hash<Moment<>>()(m));
+    EXPECT_EQ(hash<Duration<>>()(Duration<>(-7, -ss)),
+        hashValue(UnitValue{-7, -ss}));
+  }
+  EXPECT_EQ(ScalarHash()(Moment<>(Category::NaN)),
+      ScalarHash()(Moment<Unix32>(Category::NaN)));
+  EXPECT_NE(ScalarHash()(Moment<>(Category::InfP)),
+      ScalarHash()(Moment<>(Category::InfN)));
+
+  // Evenly spaced values, at several spacings, fill about as many of a
+  // power-of-two table's buckets, by the low bits, as random ones would.
+  const size_t Buckets = 1 << 12;
+  for (auto [step, ss] : {pair{1LL, 0LL}, pair{60LL, 0LL}, pair{86'400LL, 0LL},
+           pair{0LL, 1'000LL}, pair{0LL, 1'000'000'000LL}}) {
+    vector<bool> used(Buckets);
+    size_t filled = 0;
+    for (size_t i = 0; i < Buckets; ++i) {
+      auto n = static_cast<int64_t>(i);
+      auto h = hashValue(UnitValue{base + n * step + n * ss / PicosPerSecond,
+          n * ss % PicosPerSecond});
+      if (!used[h & (Buckets - 1)]) used[h & (Buckets - 1)] = true, ++filled;
+    }
+    // Random hashes would fill about 63% of them.
+    EXPECT_GT(filled, Buckets * 6 / 10) << step << " " << ss;
+  }
+
+  // Standard containers take them as keys, and look up across reps.
+  unordered_set<Moment<>> seen;
+  for (int i = 0; i < 100; ++i) seen.insert(Moment<>(base + i % 10));
+  EXPECT_EQ(seen.size(), 10u);
+  unordered_map<Moment<>, int, ScalarHash, equal_to<>> byTime;
+  for (int i = 0; i < 10; ++i) byTime[Moment<>(base + i, i * 1'000)] = i;
+  auto found = byTime.find(Moment<Unix32>(base + 3, 3'000));
+  ASSERT_NE(found, byTime.end());
+  EXPECT_EQ(found->second, 3);
+  EXPECT_FALSE(byTime.contains(Moment<Unix32>(base + 3, 4'000)));
+}
+
+TEST(Parse, ChronosTest) {
+  // Compile-time parsing takes the same path, byte by byte.
+  static_assert([] {
+    Moment<> m;
+    return parseMoment("1970-01-01T00:00:00Z"sv, m) &&
+        m == Moment<>(UnixEpochSeconds);
+  }());
+  // The word-at-a-time reader takes the usual form, both at compile time and
+  // at run time, rather than leaving it all to the byte-at-a-time one.
+  constexpr auto readFast = [](string_view text, details::IsoFields& f) {
+    return details::readIsoFixedFast(
+        text.data(), text.data() + text.size(), f);
+  };
+  static_assert([readFast] {
+    details::IsoFields f{};
+    return readFast("2024-03-15T12:34:56"sv, f) && f.year == 2024 &&
+        f.month == 3 && f.day == 15 && f.hour == 12 && f.minute == 34 &&
+        f.second == 56;
+  }());
+  details::IsoFields fields{};
+  ASSERT_TRUE(readFast("2024-03-15T12:34:56.5Z"sv, fields));
+  EXPECT_EQ(fields.year, 2024);
+  EXPECT_EQ(fields.month, 3);
+  EXPECT_EQ(fields.day, 15);
+  EXPECT_EQ(fields.hour, 12);
+  EXPECT_EQ(fields.minute, 34);
+  EXPECT_EQ(fields.second, 56);
+  EXPECT_FALSE(readFast("2024-03-15 12:34:56"sv, fields));
+  EXPECT_EQ(details::daysFromCivil(1, 1, 1), 0);
+  EXPECT_EQ(details::daysFromCivil(1970, 1, 1), UnixEpochSeconds / 86'400);
+  EXPECT_EQ(details::daysFromCivil(0, 12, 31), -1);
+  EXPECT_EQ(details::daysFromCivil(2000, 3, 1) -
+          details::daysFromCivil(2000, 2, 28), 2);
+
+  auto parse = [](string_view text) {
+    Moment<> m(Category::NaN);
+    ParseResult result = parseMoment(text, m);
+    EXPECT_TRUE(result) << text << ": " << asString(result.error);
+    EXPECT_EQ(result.ptr, text.data() + text.size()) << text;
+    return m;
+  };
+  const UnitSeconds y2k = UnixEpochSeconds + 946'684'800;
+  EXPECT_EQ(parse("2000-01-01T00:00:00Z"), Moment<>(y2k));
+  EXPECT_EQ(parse("2000-01-01T00:00:00"), Moment<>(y2k));
+  EXPECT_EQ(parse("2000-01-01t00:00:00z"), Moment<>(y2k));
+  EXPECT_EQ(parse("2000-01-01 00:00:00+00:00"), Moment<>(y2k));
+  EXPECT_EQ(parse("2000-01-01T05:30:00+05:30"), Moment<>(y2k));
+  EXPECT_EQ(parse("1999-12-31T23:00:00-01:00"), Moment<>(y2k));
+  EXPECT_EQ(parse("0001-01-01T00:00:00Z"), Moment<>(0));
+  EXPECT_EQ(parse("0000-12-31T23:59:59.5Z"), Moment<>(0, -PicosPerSecond / 2));
+  EXPECT_EQ(parse("9999-12-31T23:59:59.999999999999Z"),
+      Moment<>(details::daysFromCivil(10'000, 1, 1) * 86'400 - 1,
+          PicosPerSecond - 1));
+  EXPECT_EQ(parse("2024-02-29T12:34:56.789Z"),
+      Moment<>(UnixEpochSeconds + 1'709'210'096, 789'000'000'000));
+  // Fractions of every length, both with and without room for a word after
+  // them.
+  for (int digits = 1; digits <= 12; ++digits) {
+    string text = "2000-01-01T00:00:00." + string(digits, '7');
+    UnitPicos picos = 0;
+    for (int i = 0; i < 12; ++i) picos = picos * 10 + (i < digits ? 7 : 0);
+    EXPECT_EQ(parse(text), Moment<>(y2k, picos)) << text;
+    EXPECT_EQ(parse(text + "+00:00"), Moment<>(y2k, picos)) << text;
+  }
+  EXPECT_EQ(parse("2000-01-01T00:00:00.000000000001Z"), Moment<>(y2k, 1));
+  // Other reps take the moment as it converts.
+  Moment<details::ScalarUnit<details::Unix32Rep>> unix;
+  EXPECT_TRUE(parseMoment("2000-01-01T00:00:00.5Z"sv, unix));
+  EXPECT_EQ(unix, Moment<>(y2k, PicosPerSecond / 2));
+
+  // Errors say what was wrong and where, and leave the moment alone.
+  auto fail = [](string_view text, ParseError error, size_t at) {
+    Moment<> m(7);
+    ParseResult result = parseMoment(text, m);
+    EXPECT_EQ(result.error, error) << text;
+    EXPECT_EQ(result.ptr - text.data(), static_cast<ptrdiff_t>(at)) << text;
+    EXPECT_EQ(m, Moment<>(7)) << text;
+  };
+  fail("", ParseError::Truncated, 0);
+  fail("2000-01-01", ParseError::Truncated, 10);
+  fail("2000-01-01T00:00:0", ParseError::Truncated, 18);
+  fail("2000-01-01T00:00:00.", ParseError::Truncated, 20);
+  fail("2000-01-01T00:00:00+01", ParseError::Truncated, 22);
+  fail("200a-01-01T00:00:00Z", ParseError::Syntax, 3);
+  fail("2000/01/01T00:00:00Z", ParseError::Syntax, 4);
+  fail("2000-01-01X00:00:00Z", ParseError::Syntax, 10);
+  fail("2000-01-01T00-00:00Z", ParseError::Syntax, 13);
+  fail("2000-01-01T00:00:00.Z", ParseError::Syntax, 20);
+  fail("2000-01-01T00:00:00+0100", ParseError::Syntax, 22);
+  fail("2000-13-01T00:00:00Z", ParseError::Month, 5);
+  fail("2000-00-01T00:00:00Z", ParseError::Month, 5);
+  fail("2001-02-29T00:00:00Z", ParseError::Day, 8);
+  fail("1900-02-29T00:00:00Z", ParseError::Day, 8);
+  fail("2000-04-31T00:00:00Z", ParseError::Day, 8);
+  fail("2000-01-00T00:00:00Z", ParseError::Day, 8);
+  fail("2000-01-01T24:00:00Z", ParseError::Hour, 11);
+  fail("2000-01-01T00:60:00Z", ParseError::Minute, 14);
+  fail("2000-01-01T23:59:60Z", ParseError::Second, 17);
+  fail("2000-01-01T00:00:00.1234567890123Z", ParseError::Fraction, 20);
+  fail("2000-01-01T00:00:00.1234567890123", ParseError::Fraction, 20);
+  fail("2000-01-01T00:00:00+24:00", ParseError::Offset, 19);
+  fail("2000-01-01T00:00:00-00:60", ParseError::Offset, 19);
+  EXPECT_EQ(asString(ParseError::Fraction), "Fraction"sv);
+
+  // Whatever follows is left for the caller, as with std::from_chars.
+  string_view text = "2000-01-01T00:00:00Z, next";
+  Moment<> m;
+  EXPECT_EQ(parseMoment(text, m).ptr, text.data() + 20);
+
+  // Batches.
+  MomentColumn column;
+  text = "2000-01-01T00:00:00Z\n2000-01-01T00:00:01.5+00:00\n"
+         "2000-01-01T00:00:02\n";
+  ParseResult result = parseMoments(text, '\n', column);
+  EXPECT_TRUE(result);
+  EXPECT_EQ(result.ptr, text.data() + text.size());
+  ASSERT_EQ(column.size(), 3u);
+  EXPECT_EQ(column[1], Moment<>(y2k + 1, PicosPerSecond / 2));
+  EXPECT_EQ(column[2], Moment<>(y2k + 2));
+  vector<Moment<>> moments;
+  text = "2000-01-01T00:00:00Z,2000-01-01T00:00:01Z;2000-01-01T00:00:02Z";
+  result = parseMoments(text, ',', moments);
+  EXPECT_EQ(result.error, ParseError::Syntax);
+  EXPECT_EQ(result.ptr, text.data() + 41);
+  EXPECT_EQ(moments.size(), 2u);
+  moments.clear();
+  text = "2000-01-01T00:00:00Z,,2000-01-01T00:00:01Z";
+  EXPECT_EQ(parseMoments(text, ',', moments).error, ParseError::Syntax);
+  EXPECT_EQ(moments.size(), 1u);
+}
+
+TEST(Format, ChronosTest) {
+  auto format = [](const auto& item, Precision precision = Precision::Picos) {
+    char buffer[MaxIsoChars];
+    auto [ptr, ec] = toChars(buffer, buffer + sizeof(buffer), item, precision);
+    EXPECT_EQ(ec, errc());
+    return string(buffer, ptr);
+  };
+  static_assert([] {
+    char buffer[MaxIsoChars]{};
+    auto result = toChars(buffer, buffer + sizeof(buffer),
+        Moment<>(UnixEpochSeconds), Precision::Seconds);
+    return string_view(buffer, result.ptr) == "1970-01-01T00:00:00Z";
+  }());
+
+  // Decimal seconds, for durations and scalars.
+  EXPECT_EQ(format(Duration<>(0)), "0.000000000000");
+  EXPECT_EQ(format(Duration<>(1, 250'000'000'000)), "1.250000000000");
+  EXPECT_EQ(format(Duration<>(-1, -250'000'000'000), Precision::Millis),
+      "-1.250");
+  EXPECT_EQ(format(Duration<>(0, -1), Precision::Picos), "-0.000000000001");
+  EXPECT_EQ(format(Duration<>(0, -1), Precision::Nanos), "-0.000000000");
+  EXPECT_EQ(format(Duration<>(12, 999'999'999'999), Precision::Micros),
+      "12.999999");
+  EXPECT_EQ(format(Duration<>(-120), Precision::Seconds), "-120");
+  EXPECT_EQ(format(details::ScalarUnit<>(7, 5), static_cast<Precision>(1)),
+      "7.0");
+  EXPECT_EQ(format(Duration<>(SecondsTraits<>::Min, -(PicosPerSecond - 1))),
+      "-9223372036854775806.999999999999");
+  EXPECT_EQ(format(Duration<>(SecondsTraits<>::Min, -(PicosPerSecond - 1)))
+                .size(),
+      MaxDecimalChars);
+  EXPECT_EQ(format(Duration<>(Category::NaN)), "NaN");
+  EXPECT_EQ(format(Duration<>(Category::InfN)), "-Inf");
+  EXPECT_EQ(format(Moment<>(Category::InfP)), "+Inf");
+
+  // ISO 8601 for moments, which parse back.
+  const UnitSeconds leapDay = UnixEpochSeconds + 1'709'210'096;
+  EXPECT_EQ(format(Moment<>(leapDay, 789'000'000'000), Precision::Millis),
+      "2024-02-29T12:34:56.789Z");
+  EXPECT_EQ(format(Moment<>(leapDay, 789'000'000'000), Precision::Seconds),
+      "2024-02-29T12:34:56Z");
+  EXPECT_EQ(format(Moment<>(0)), "0001-01-01T00:00:00.000000000000Z");
+  EXPECT_EQ(format(Moment<>(0, -1), Precision::Nanos),
+      "0000-12-31T23:59:59.999999999Z");
+  EXPECT_EQ(format(Moment<>(-SecondsPerDay * 366 - 1), Precision::Seconds),
+      "-0001-12-31T23:59:59Z");
+  EXPECT_EQ(format(Moment<>(details::daysFromCivil(10'000, 1, 1) *
+                       SecondsPerDay), Precision::Seconds),
+      "+10000-01-01T00:00:00Z");
+  EXPECT_EQ(format(Moment<>(SecondsTraits<>::Min, -(PicosPerSecond - 1)))
+                .size(),
+      MaxIsoChars);
+  EXPECT_LE(format(Moment<>(SecondsTraits<>::Max, PicosPerSecond - 1)).size(),
+      MaxIsoChars);
+  EXPECT_EQ(format(Moment<details::ScalarUnit<details::Unix32Rep>>(
+                       Moment<>(leapDay, 500'000'000'000)),
+                Precision::Millis),
+      "2024-02-29T12:34:56.500Z");
+  mt19937_64 gen(42);
+  uniform_int_distribution<int64_t> secs(0, 10'000 * SecondsPerYear);
+  uniform_int_distribution<int64_t> picos(0, PicosPerSecond - 1);
+  for (int i = 0; i < 10'000; ++i) {
+    Moment<> m(secs(gen), picos(gen)), back;
+    string text = format(m);
+    ASSERT_TRUE(parseMoment(text, back)) << text;
+    EXPECT_EQ(back, m) << text;
+    // Civil dates agree with walking the days.
+    auto date = details::civilFromDays(m.seconds() / SecondsPerDay);
+    EXPECT_EQ(details::daysFromCivil(date.year, date.month, date.day),
+        m.seconds() / SecondsPerDay);
+  }
+
+  // Buffers that are too small are left alone.
+  char small[20];
+  fill(begin(small), end(small), '#');
+  auto result = toChars(small, small + 19, Moment<>(leapDay, 1));
+  EXPECT_EQ(result.ec, errc::value_too_large);
+  EXPECT_EQ(result.ptr, small + 19);
+  EXPECT_EQ(small[0], '#');
+  result = toChars(small, small + 20, Moment<>(leapDay), Precision::Seconds);
+  EXPECT_EQ(result.ec, errc());
+  EXPECT_EQ(string(small, result.ptr), "2024-02-29T12:34:56Z");
+  result = toChars(small, small + 2, Duration<>(-1), Precision::Seconds);
+  EXPECT_EQ(string(small, result.ptr), "-1");
+
+#ifdef __cpp_lib_format
+  EXPECT_EQ(std::format("{}", Duration<>(1)), "1.000000000000");
+  EXPECT_EQ(std::format("{:.3}", Moment<>(leapDay, 789'000'000'000)),
+      "2024-02-29T12:34:56.789Z");
+  EXPECT_EQ(std::format("[{:.0}]", Duration<>(Category::NaN)), "[NaN]");
+#endif
+}
+
+TEST(IsoFormatter, ChronosTest) {
+  // Agrees with toChars, through changes of second, precision, and sign, and
+  // special values in between, which must not disturb the cache.
+  const UnitSeconds base = UnixEpochSeconds + 1'709'210'096;
+  vector<Moment<>> moments{Moment<>(base, 1), Moment<>(base, 999'999'999'999),
+      Moment<>(Category::NaN), Moment<>(base, 5), Moment<>(base + 1),
+      Moment<>(Category::InfP), Moment<>(base + 1, 7), Moment<>(base),
+      Moment<>(0, -1), Moment<>(-1), Moment<>(0), Moment<>(Category::InfN),
+      Moment<>(SecondsTraits<>::Min, -1), Moment<>(SecondsTraits<>::Min),
+      Moment<>(SecondsTraits<>::Max, PicosPerSecond - 1),
+      Moment<>(base + 86'400 * 365)};
+  for (int i = 0; i < 1'000; ++i) {
+    moments.push_back(
+        Moment<>(base + i / 300, i * 3'333'333'333LL % PicosPerSecond));
+  }
+  IsoFormatter formatter;
+  for (auto precision : {Precision::Picos, Precision::Seconds,
+           Precision::Millis, static_cast<Precision>(1)}) {
+    for (const auto& m : moments) {
+      char expected[MaxIsoChars], cached[MaxIsoChars];
+      auto e = toChars(expected, expected + MaxIsoChars, m, precision);
+      auto c = formatter.toChars(cached, cached + MaxIsoChars, m, precision);
+      EXPECT_EQ(string(cached, c.ptr), string(expected, e.ptr));
+    }
+  }
+
+  // Short buffers work as they do for toChars.
+  char small[24];
+  fill(begin(small), end(small), '#');
+  auto result = formatter.toChars(small, small + 23, Moment<>(base, 1),
+      Precision::Millis);
+  EXPECT_EQ(result.ec, errc::value_too_large);
+  EXPECT_EQ(small[0], '#');
+  result = formatter.toChars(small, small + 24, Moment<>(base, 1),
+      Precision::Millis);
+  EXPECT_EQ(string(small, result.ptr), "2024-02-29T12:34:56.000Z");
+  Moment<details::ScalarUnit<details::Unix32Rep>> unix(Moment<>(base + 1));
+  result = formatter.toChars(small, small + 24, unix, Precision::Seconds);
+  EXPECT_EQ(string(small, result.ptr), "2024-02-29T12:34:57Z");
+}
+
+namespace {
+// Whether the factory gives a constant for the count, rather than failing to
+// compile.
+template<typename Period, int64_t Count>
+concept ConstantDurationOf = requires {
+  typename std::integral_constant<bool, durationOf<Period>(Count).isNaN()>;
+};
+} // namespace
+
+TEST(Literals, ChronosTest) {
+  // Exact, and usable in constant expressions.
+  static_assert(250_ms == Duration<>(0, 250'000'000'000));
+  static_assert(1.5_s == Duration<>(1, 500'000'000'000));
+  static_assert(-5_min == Duration<>(-300));
+  static_assert(2_h == Duration<>(7'200));
+  static_assert(1'000_ps == 1_ns);
+  static_assert(0.001_us == 1_ns);
+  static_assert(1.250000000000000_ms == 1'250_us);
+  static_assert(0.000000000001_s == 1_ps);
+  static_assert(0_s == Duration<>(0));
+  EXPECT_EQ(-1.000000000001_s, Duration<>(-1, -1));
+
+  // The largest that fit, in the widest and narrowest units.
+  constexpr auto maxSeconds = 9'223'372'036'854'775'806_s;
+  EXPECT_EQ(maxSeconds, Duration<>(SecondsTraits<>::Max));
+  EXPECT_EQ(18'446'744'073'709'551'615_ps,
+      Duration<>(18'446'744, 73'709'551'615));
+  EXPECT_EQ(2'562'047'788'015'215_h,
+      Duration<>(2'562'047'788'015'215 * 3'600));
+
+  // The factories agree with the literals, and take any whole number of
+  // picoseconds as the period.
+  EXPECT_EQ(durationOf<std::milli>(250), 250_ms);
+  EXPECT_EQ(durationOf<std::micro>(-1'500), -1.5_ms);
+  EXPECT_EQ(durationOf(-7), -7_s);
+  EXPECT_EQ(durationOf<std::ratio<86'400>>(2), 48_h);
+  EXPECT_EQ(durationOf<std::pico>(INT64_MIN),
+      Duration<>(-9'223'372, -36'854'775'808));
+  static_assert(durationOf<std::nano>(5) == 5_ns);
+
+  // Counts too large for the seconds saturate, as arithmetic does.
+  EXPECT_EQ(durationOf<std::ratio<3'600>>(INT64_MAX).category(),
+      Category::InfP);
+  EXPECT_EQ(durationOf<std::ratio<3'600>>(INT64_MIN).category(),
+      Category::InfN);
+  EXPECT_EQ(durationOf<std::ratio<2>>(INT64_MAX / 2).category(),
+      Category::Num);
+  EXPECT_EQ(durationOf<std::ratio<2>>(INT64_MAX / 2 + 1).category(),
+      Category::InfP);
+  // In a constant expression, they fail to compile instead.
+  static_assert(ConstantDurationOf<std::ratio<2>, INT64_MAX / 2>);
+  static_assert(!ConstantDurationOf<std::ratio<2>, INT64_MAX / 2 + 1>);
+  static_assert(!ConstantDurationOf<std::ratio<3'600>, INT64_MIN>);
+
+  // Literals that aren't exact, such as 1.5_ps, or don't fit, such as
+  // 9'223'372'036'854'775'807_s, or aren't decimal, such as 0x10_s, don't
+  // compile.
+}
+
+TEST(Civil, ChronosTest) {
+  // Known dates, including leap days and the turns of centuries.
+  struct Known {
+    int64_t days;
+    CivilDate date;
+  };
+  for (auto [days, date] : {Known{0, {1, 1, 1}}, Known{-1, {0, 12, 31}},
+           Known{-366, {0, 1, 1}}, Known{719'162, {1970, 1, 1}},
+           Known{730'178, {2000, 2, 29}}, Known{730'179, {2000, 3, 1}},
+           Known{693'654, {1900, 3, 1}}, Known{738'944, {2024, 2, 29}},
+           Known{-719'893, {-1970, 1, 1}}}) {
+    CivilDate c = details::civilFromDays(days);
+    EXPECT_EQ(c.year, date.year);
+    EXPECT_EQ(c.month, date.month);
+    EXPECT_EQ(c.day, date.day);
+    EXPECT_EQ(details::daysFromCivil(date.year, date.month, date.day), days);
+  }
+
+  // Each day follows the one before, across several eras on both sides of
+  // the epoch, and round trips.
+  CivilDate prev = details::civilFromDays(-400'000);
+  for (int64_t days = -399'999; days < 1'000'000; ++days) {
+    CivilDate c = details::civilFromDays(days);
+    if (c.day != 1) {
+      EXPECT_TRUE(c.year == prev.year && c.month == prev.month &&
+          c.day == prev.day + 1);
+    } else if (c.month != 1) {
+      EXPECT_TRUE(c.year == prev.year && c.month == prev.month + 1 &&
+          prev.day == details::daysInMonth(prev.year, prev.month));
+    } else {
+      EXPECT_TRUE(c.year == prev.year + 1 && prev.month == 12 &&
+          prev.day == 31);
+    }
+    EXPECT_EQ(details::daysFromCivil(c.year, c.month, c.day), days);
+    prev = c;
+  }
+
+  // Moments round trip, to the picosecond, through the ends of the range.
+  using T = SecondsTraits<>;
+  CivilTime t{};
+  for (auto m : {Moment<>(UnixEpochSeconds + 1'709'210'096, 789),
+           Moment<>(0), Moment<>(0, -1), Moment<>(-1, -5), Moment<>(T::Max),
+           Moment<>(T::Max, PicosPerSecond - 1), Moment<>(T::Min),
+           Moment<>(T::Min, 1 - PicosPerSecond)}) {
+    EXPECT_TRUE(toCivil(m, t));
+    EXPECT_EQ(fromCivil(t), m);
+  }
+  EXPECT_TRUE(toCivil(Moment<>(UnixEpochSeconds + 1'709'210'096, 789), t));
+  EXPECT_EQ(t.year, 2024);
+  EXPECT_EQ(t.month, 2);
+  EXPECT_EQ(t.day, 29);
+  EXPECT_EQ(t.hour, 12);
+  EXPECT_EQ(t.minute, 34);
+  EXPECT_EQ(t.second, 56);
+  EXPECT_EQ(t.picos, 789);
+  EXPECT_TRUE(toCivil(Moment<>(0, -1), t));
+  EXPECT_EQ(t.year, 0);
+  EXPECT_EQ(t.second, 59);
+  EXPECT_EQ(t.picos, PicosPerSecond - 1);
+  EXPECT_FALSE(toCivil(Moment<>(Category::NaN), t));
+  EXPECT_FALSE(toCivil(Moment<>(Category::InfN), t));
+  EXPECT_EQ(fromCivil(CivilTime{1970, 1, 1, 0, 0, 0, 0}),
+      Moment<>(UnixEpochSeconds));
+  EXPECT_EQ(fromCivil<details::ScalarUnit<details::Unix32Rep>>(
+                CivilTime{2024, 2, 29, 12, 34, 56, 0}),
+      Moment<>(UnixEpochSeconds + 1'709'210'096));
+
+  // Fields out of range, including leap seconds, are NaN, and years out of
+  // range saturate.
+  for (auto bad : {CivilTime{2023, 2, 29, 0, 0, 0, 0},
+           CivilTime{2024, 13, 1, 0, 0, 0, 0},
+           CivilTime{2024, 0, 1, 0, 0, 0, 0},
+           CivilTime{2024, 4, 31, 0, 0, 0, 0},
+           CivilTime{2024, 1, 1, 24, 0, 0, 0},
+           CivilTime{2024, 1, 1, 0, 60, 0, 0},
+           CivilTime{2024, 1, 1, 0, 0, 60, 0},
+           CivilTime{2024, 1, 1, 0, 0, 0, -1},
+           CivilTime{2024, 1, 1, 0, 0, 0, PicosPerSecond}}) {
+    EXPECT_EQ(fromCivil(bad).category(), Category::NaN);
+  }
+  EXPECT_TRUE(toCivil(Moment<>(T::Max, PicosPerSecond - 1), t));
+  ++t.second;
+  EXPECT_EQ(fromCivil(t).category(), Category::InfP);
+  EXPECT_TRUE(toCivil(Moment<>(T::Min), t));
+  --t.second;
+  t.picos = 1;
+  EXPECT_EQ(fromCivil(t), Moment<>(T::Min, 1 - PicosPerSecond));
+  t.picos = 0;
+  EXPECT_EQ(fromCivil(t).category(), Category::InfN);
+  EXPECT_EQ(fromCivil(CivilTime{INT64_MAX, 1, 1, 0, 0, 0, 0}).category(),
+      Category::InfP);
+  EXPECT_EQ(fromCivil(CivilTime{INT64_MIN, 1, 1, 0, 0, 0, 0}).category(),
+      Category::InfN);
+
+  // The batch form agrees with toCivil, in blocks of present dates, blocks
+  // with a value too far out, and blocks with special values.
+  MomentColumn column;
+  mt19937_64 gen(42);
+  uniform_int_distribution<int64_t> secs(0, (int64_t{1} << 39) - 1);
+  uniform_int_distribution<int64_t> picos(0, PicosPerSecond - 1);
+  for (int i = 0; i < 1'000; ++i)
+    column.push_back(Moment<>(secs(gen), picos(gen)));
+  for (auto m : {Moment<>(0, -1), Moment<>(int64_t{1} << 39),
+           Moment<>((int64_t{1} << 39) - 1, PicosPerSecond - 1),
+           Moment<>(Category::NaN), Moment<>(T::Min), Moment<>(T::Max),
+           Moment<>(Category::InfP), Moment<>(0)}) {
+    column.push_back(m);
+    for (int i = 0; i < 20; ++i)
+      column.push_back(Moment<>(secs(gen), picos(gen)));
+  }
+  vector<int64_t> years(column.size());
+  vector<uint8_t> months(column.size()), days(column.size());
+  civilDates(column.seconds(), column.subseconds(), years.data(),
+      months.data(), days.data(), column.size());
+  for (size_t i = 0; i < column.size(); ++i) {
+    if (!toCivil(column[i], t)) t = CivilTime{};
+    EXPECT_EQ(years[i], t.year);
+    EXPECT_EQ(months[i], t.month);
+    EXPECT_EQ(days[i], t.day);
+  }
+}
+
+TEST(Calendar, ChronosTest) {
+  auto at = [](int64_t year, int month, int day, UnitPicos picos = 0) {
+    return fromCivil(CivilTime{year, month, day, 12, 34, 56, picos});
+  };
+
+  // Days past the end of the month are clamped, and the time of day is kept.
+  EXPECT_EQ(addMonths(at(2024, 1, 31, 7), 1), at(2024, 2, 29, 7));
+  EXPECT_EQ(addMonths(at(2023, 1, 31), 1), at(2023, 2, 28));
+  EXPECT_EQ(addMonths(at(2024, 3, 31), -1), at(2024, 2, 29));
+  EXPECT_EQ(addMonths(at(2024, 1, 31), 3), at(2024, 4, 30));
+  EXPECT_EQ(addMonths(at(2024, 11, 15), 2), at(2025, 1, 15));
+  EXPECT_EQ(addMonths(at(2024, 1, 15), -13), at(2022, 12, 15));
+  EXPECT_EQ(addMonths(at(2024, 1, 15), 0), at(2024, 1, 15));
+  EXPECT_EQ(addMonths(at(1, 1, 1), -1), at(0, 12, 1));
+  EXPECT_EQ(addMonths(at(0, 12, 1), -13), at(-1, 11, 1));
+  EXPECT_EQ(addMonths(Moment<>(0, -1), 1),
+      Moment<>(31 * SecondsPerDay) - Duration<>(0, 1));
+  EXPECT_EQ(addYears(at(2024, 2, 29), 1), at(2025, 2, 28));
+  EXPECT_EQ(addYears(at(2024, 2, 29), 4), at(2028, 2, 29));
+  EXPECT_EQ(addYears(at(2024, 2, 29), -100), at(1924, 2, 29));
+  EXPECT_EQ(addYears(at(2000, 2, 29), 100), at(2100, 2, 28));
+  Moment<details::ScalarUnit<details::Unix32Rep>> unix(at(2024, 1, 31));
+  EXPECT_EQ(addMonths(unix, 1), at(2024, 2, 29));
+
+  // 2024-03-01 was a Friday.
+  EXPECT_EQ(addWeekdays(at(2024, 3, 1), 1), at(2024, 3, 4));
+  EXPECT_EQ(addWeekdays(at(2024, 3, 2), 1), at(2024, 3, 4));
+  EXPECT_EQ(addWeekdays(at(2024, 3, 3), 1), at(2024, 3, 4));
+  EXPECT_EQ(addWeekdays(at(2024, 3, 2), -1), at(2024, 3, 1));
+  EXPECT_EQ(addWeekdays(at(2024, 3, 3), -1), at(2024, 3, 1));
+  EXPECT_EQ(addWeekdays(at(2024, 3, 4), -1), at(2024, 3, 1));
+  EXPECT_EQ(addWeekdays(at(2024, 3, 3), 0), at(2024, 3, 3));
+  EXPECT_EQ(addWeekdays(at(2024, 3, 6), 5), at(2024, 3, 13));
+  EXPECT_EQ(addWeekdays(at(2024, 3, 6), 7), at(2024, 3, 15));
+  EXPECT_EQ(addWeekdays(at(2024, 3, 6), -8), at(2024, 2, 23));
+
+  // Weekdays agree with stepping a day at a time, from every day of the week,
+  // on both sides of the epoch.
+  for (int64_t from = -14; from < 14; ++from) {
+    for (int64_t count = -30; count <= 30; ++count) {
+      int64_t step = count > 0 ? 1 : -1;
+      int64_t expected = from;
+      auto isWeekday = [](int64_t d) { return (d % 7 + 7) % 7 < 5; };
+      if (count > 0)
+        while (!isWeekday(expected)) --expected;
+      else if (count < 0)
+        while (!isWeekday(expected)) ++expected;
+      for (int64_t left = count; left != 0; left -= step) {
+        expected += step;
+        while (!isWeekday(expected)) expected += step;
+      }
+      Duration<> time(3'600, 5);
+      EXPECT_EQ(addWeekdays(Moment<>(from * SecondsPerDay) + time, count),
+          Moment<>(expected * SecondsPerDay) + time)
+          << from << " " << count;
+    }
+  }
+
+  // Special values are unchanged, and the range saturates.
+  using T = SecondsTraits<>;
+  for (auto cat : {Category::NaN, Category::InfN, Category::InfP}) {
+    EXPECT_EQ(addMonths(Moment<>(cat), 1).category(), cat);
+    EXPECT_EQ(addYears(Moment<>(cat), -1).category(), cat);
+    EXPECT_EQ(addWeekdays(Moment<>(cat), 1).category(), cat);
+  }
+  EXPECT_EQ(addMonths(Moment<>(T::Max), 1).category(), Category::InfP);
+  EXPECT_EQ(addMonths(Moment<>(T::Min), -1).category(), Category::InfN);
+  EXPECT_EQ(addYears(at(2024, 1, 1), INT64_MAX).category(), Category::InfP);
+  EXPECT_EQ(addYears(at(2024, 1, 1), INT64_MIN).category(), Category::InfN);
+  EXPECT_EQ(addMonths(at(2024, 1, 1), INT64_MIN).category(), Category::InfN);
+  EXPECT_EQ(addWeekdays(at(2024, 1, 1), INT64_MAX).category(), Category::InfP);
+  EXPECT_EQ(addYears(at(2024, 1, 1), 292'000'000'000).category(),
+      Category::Num);
+  EXPECT_EQ(addYears(at(2024, 1, 1), 293'000'000'000).category(),
+      Category::InfP);
+
+  // Columns give what each moment does.
+  MomentColumn column;
+  mt19937_64 gen(42);
+  uniform_int_distribution<int64_t> secs(
+      -SecondsPerYear, 3'000 * SecondsPerYear);
+  uniform_int_distribution<int64_t> picos(0, PicosPerSecond - 1);
+  for (int i = 0; i < 2'000; ++i) {
+    // Runs on the same day, as the cache expects, and scattered moments.
+    int64_t s = i % 4 ? column.seconds()[i - 1] + 60 : secs(gen);
+    column.push_back(Moment<>(s, s < 0 ? -picos(gen) : picos(gen)));
+  }
+  for (auto m : {Moment<>(Category::NaN), Moment<>(T::Max), Moment<>(T::Min),
+           Moment<>(Category::InfN), Moment<>(0)})
+    column.push_back(m);
+  for (int64_t count : {int64_t{1}, int64_t{-13}, int64_t{1'000},
+           int64_t{INT64_MAX}}) {
+    MomentColumn months = column, years = column, weekdays = column;
+    addMonths(months, count);
+    addYears(years, count);
+    addWeekdays(weekdays, count);
+    for (size_t i = 0; i < column.size(); ++i) {
+      EXPECT_EQ(months.value(i), addMonths(column[i], count).value());
+      EXPECT_EQ(years.value(i), addYears(column[i], count).value());
+      EXPECT_EQ(weekdays.value(i), addWeekdays(column[i], count).value());
+    }
+  }
+}
+
+namespace {
+// Writes TZif data, of version 2, for transitions at Unix seconds to the types
+// with the given offsets, and a rule for after them.
+vector<unsigned char> makeTzif(const vector<pair<int64_t, uint8_t>>& times,
+    const vector<int32_t>& offsets, const string& rule, uint32_t leaps = 0) {
+  vector<unsigned char> out;
+  auto put = [&](uint64_t value, int bytes) {
+    for (int i = bytes - 1; i >= 0; --i)
+      out.push_back(static_cast<unsigned char>(value >> (8 * i)));
+  };
+  for (int timeBytes : {4, 8}) {
+    out.insert(out.end(), {'T', 'Z', 'i', 'f', '2'});
+    out.insert(out.end(), 15, 0);
+    for (uint64_t count : {uint64_t{0}, uint64_t{0}, uint64_t{leaps},
+             uint64_t{times.size()}, uint64_t{offsets.size()}, uint64_t{4}})
+      put(count, 4);
+    for (auto [at, type] : times) put(static_cast<uint64_t>(at), timeBytes);
+    for (auto [at, type] : times) put(type, 1);
+    for (int32_t offset : offsets) {
+      put(static_cast<uint32_t>(offset), 4);
+      put(0, 1);
+      put(0, 1);
+    }
+    out.insert(out.end(), {'Z', 'Z', 'Z', 0});
+    for (uint32_t i = 0; i < leaps; ++i) put(0, timeBytes), put(0, 4);
+  }
+  out.push_back('\n');
+  out.insert(out.end(), rule.begin(), rule.end());
+  out.push_back('\n');
+  return out;
+}
+
+Moment<> utc(int64_t year, int month, int day, int hour, int minute = 0) {
+  return fromCivil(CivilTime{year, month, day, hour, minute, 0, 0});
+}
+} // namespace
+
+TEST(TimeZone, ChronosTest) {
+  // New York, with local mean time until 1883, then the rule from 2007 on,
+  // with the transitions of 2007 given.
+  const int32_t Lmt = -17'762, Est = -18'000, Edt = -14'400;
+  auto data = makeTzif({{-2'717'650'800, 1}, {1'173'596'400, 2},
+                           {1'194'156'000, 1}},
+      {Lmt, Est, Edt}, "EST5EDT,M3.2.0,M11.1.0");
+  TimeZone zone;
+  ASSERT_EQ(zone.readTzif(data.data(), data.size()), ZoneError::None);
+  struct Expected {
+    Moment<> at;
+    int32_t offset;
+  };
+  const vector<Expected> newYork{{utc(1800, 1, 1, 0), Lmt},
+      {utc(1883, 11, 18, 16, 59), Lmt}, {utc(1883, 11, 18, 17), Est},
+      {utc(2007, 3, 11, 6, 59), Est}, {utc(2007, 3, 11, 7), Edt},
+      {utc(2024, 3, 10, 6, 59), Est}, {utc(2024, 3, 10, 7), Edt},
+      {utc(2024, 11, 3, 5, 59), Edt}, {utc(2024, 11, 3, 6), Est},
+      {utc(2025, 1, 1, 0), Est}, {utc(2399, 12, 31, 23), Est},
+      {utc(2400, 3, 12, 7), Edt}, {utc(3024, 3, 14, 6, 59), Est},
+      {utc(3024, 3, 14, 7), Edt}, {utc(9999, 11, 7, 5, 59), Edt},
+      {utc(9999, 11, 7, 6), Est}, {Moment<>(SecondsTraits<>::Max), Est},
+      {Moment<>(SecondsTraits<>::Min), Lmt}};
+  for (auto [at, offset] : newYork) {
+    EXPECT_EQ(zone.offset(at), Duration<>(offset));
+    EXPECT_EQ(zone.toLocal(at), at + Duration<>(offset));
+  }
+  EXPECT_EQ(zone.offset(Moment<>(Category::NaN)), Duration<>());
+  EXPECT_EQ(zone.toLocal(Moment<>(Category::InfN)).category(),
+      Category::InfN);
+  CivilTime t{};
+  EXPECT_TRUE(toCivil(zone.toLocal(utc(2024, 7, 4, 16)), t));
+  EXPECT_EQ(t.hour, 12);
+
+  // Sydney, where the rule spans the new year, and a fixed offset with a
+  // quoted name.
+  TimeZone sydney, india;
+  data = makeTzif({}, {36'000}, "AEST-10AEDT,M10.1.0,M4.1.0/3");
+  ASSERT_EQ(sydney.readTzif(data.data(), data.size()), ZoneError::None);
+  EXPECT_EQ(sydney.offset(utc(2024, 1, 1, 0)), Duration<>(39'600));
+  EXPECT_EQ(sydney.offset(utc(2024, 4, 6, 15, 59)), Duration<>(39'600));
+  EXPECT_EQ(sydney.offset(utc(2024, 4, 6, 16)), Duration<>(36'000));
+  EXPECT_EQ(sydney.offset(utc(2024, 10, 5, 15, 59)), Duration<>(36'000));
+  EXPECT_EQ(sydney.offset(utc(2024, 10, 5, 16)), Duration<>(39'600));
+  EXPECT_EQ(sydney.offset(utc(5000, 1, 1, 0)), Duration<>(39'600));
+  data = makeTzif({{-3'645'237'208, 1}}, {21'208, 19'800}, "<+0530>-5:30");
+  ASSERT_EQ(india.readTzif(data.data(), data.size()), ZoneError::None);
+  EXPECT_EQ(india.offset(utc(1800, 1, 1, 0)), Duration<>(21'208));
+  EXPECT_EQ(india.offset(utc(2024, 1, 1, 0)), Duration<>(19'800));
+  EXPECT_EQ(india.offset(Moment<>(SecondsTraits<>::Max)), Duration<>(19'800));
+  EXPECT_EQ(TimeZone().offset(utc(2024, 1, 1, 0)), Duration<>());
+
+  // Bad data is rejected, and leaves the zone as it was.
+  auto check = [&](vector<unsigned char> bad, ZoneError error) {
+    EXPECT_EQ(india.readTzif(bad.data(), bad.size()), error);
+    EXPECT_EQ(india.offset(utc(2024, 1, 1, 0)), Duration<>(19'800));
+  };
+  data = makeTzif({{0, 1}}, {0, 3'600}, "CET-1");
+  check(vector<unsigned char>(data.begin(), data.end() - 1), ZoneError::Format);
+  check(vector<unsigned char>(data.begin(), data.begin() + 60),
+      ZoneError::Format);
+  data[0] = 'X';
+  check(data, ZoneError::Format);
+  check(makeTzif({{0, 2}}, {0, 3'600}, "CET-1"), ZoneError::Format);
+  check(makeTzif({{10, 1}, {10, 0}}, {0, 3'600}, "CET-1"), ZoneError::Format);
+  check(makeTzif({}, {0}, "CET-1CEST,M3.5.0"), ZoneError::Rule);
+  check(makeTzif({}, {0}, "CET-1CEST,M3.6.0,M10.5.0/3"), ZoneError::Rule);
+  check(makeTzif({}, {0}, "C-1"), ZoneError::Rule);
+  check(makeTzif({}, {0}, "UTC0", 1), ZoneError::LeapSeconds);
+  EXPECT_EQ(india.loadTzif("no/such/zone"), ZoneError::File);
+
+  // The image can be used in place, and gives the same offsets.
+  vector<uint64_t> image((zone.imageSize() + 7) / 8);
+  memcpy(image.data(), zone.imageData(), zone.imageSize());
+  TimeZone viewed;
+  ASSERT_EQ(viewed.viewImage(image.data(), zone.imageSize()), ZoneError::None);
+  for (auto [at, offset] : newYork)
+    EXPECT_EQ(viewed.offset(at), Duration<>(offset));
+  TimeZone moved(std::move(viewed));
+  EXPECT_EQ(moved.offset(utc(2024, 7, 1, 0)), Duration<>(Edt));
+  EXPECT_EQ(viewed.offset(utc(2024, 7, 1, 0)), Duration<>());
+  EXPECT_EQ(viewed.viewImage(image.data(), zone.imageSize() - 8),
+      ZoneError::Image);
+  EXPECT_EQ(viewed.viewImage(reinterpret_cast<char*>(image.data()) + 4,
+                zone.imageSize() - 8),
+      ZoneError::Image);
+  image[0] ^= 1;
+  EXPECT_EQ(viewed.viewImage(image.data(), zone.imageSize()),
+      ZoneError::Image);
+
+  // Cursors and columns agree with looking up each moment, in time order and
+  // out of it.
+  MomentColumn column;
+  mt19937_64 gen(42);
+  uniform_int_distribution<int64_t> hours(0, 24 * 3);
+  Moment<> at = utc(2020, 1, 1, 0);
+  for (int i = 0; i < 5'000; ++i)
+    column.push_back(at += Duration<>(hours(gen) * 3'600 + 1, -1));
+  for (auto [when, offset] : newYork) column.push_back(when);
+  column.push_back(Moment<>(Category::NaN));
+  column.push_back(Moment<>(SecondsTraits<>::Max, PicosPerSecond - 1));
+  column.push_back(Moment<>(SecondsTraits<>::Min, 1 - PicosPerSecond));
+  ZoneCursor cursor(zone);
+  MomentColumn local = column;
+  toLocal(zone, local);
+  for (size_t i = 0; i < column.size(); ++i) {
+    EXPECT_EQ(cursor.offset(column[i]), zone.offset(column[i]));
+    EXPECT_EQ(local.value(i), zone.toLocal(column[i]).value());
+  }
+
+  // The zones installed on this machine, if there are any.
+  TimeZone paris;
+  if (paris.loadTzif("/usr/share/zoneinfo/Europe/Paris") == ZoneError::None) {
+    EXPECT_EQ(paris.offset(utc(2024, 3, 31, 0, 59)), Duration<>(3'600));
+    EXPECT_EQ(paris.offset(utc(2024, 3, 31, 1)), Duration<>(7'200));
+    EXPECT_EQ(paris.offset(utc(1944, 8, 25, 12)), Duration<>(7'200));
+  }
+}
+
+TEST(LeapSeconds, ChronosTest) {
+  const LeapSeconds leaps;
+  EXPECT_EQ(leaps.size(), 28u);
+  EXPECT_EQ(leaps.expires(), utc(2027, 6, 28, 0));
+  // Leaps are announced about six months ahead, and the list is extended
+  // each time one isn't, so it always reaches at least that far past the
+  // last one.
+  const details::LeapDate& newest = std::end(details::BuiltinLeaps)[-1];
+  EXPECT_GE(leaps.expires(),
+      utc(newest.year, newest.month, 1, 0) + Duration<>(183 * SecondsPerDay));
+
+  // The offset before the first leap, around some, and after the last.
+  EXPECT_EQ(leaps.offset(utc(1900, 1, 1, 0).seconds()), 10);
+  EXPECT_EQ(leaps.offset(utc(1972, 6, 30, 23, 59).seconds() + 59), 10);
+  EXPECT_EQ(leaps.offset(utc(1972, 7, 1, 0).seconds()), 11);
+  EXPECT_EQ(leaps.offset(utc(2016, 12, 31, 23).seconds()), 36);
+  EXPECT_EQ(leaps.offset(utc(2017, 1, 1, 0).seconds()), 37);
+  EXPECT_EQ(leaps.offset(SecondsTraits<>::Max), 37);
+
+  // POSIX to TAI and back, with fractions, before the epoch, and past the
+  // range.
+  const Duration<> half(0, PicosPerSecond / 2);
+  for (Moment<> posix : {utc(2024, 5, 1, 12) + half, utc(1970, 1, 1, 0),
+           utc(1999, 1, 1, 0) - half, utc(-500, 3, 1, 0) - half,
+           Moment<>(SecondsTraits<>::Min) + half}) {
+    Moment<> tai = leaps.toTai(posix);
+    EXPECT_EQ(tai, posix + Duration<>(leaps.offset(posix.seconds() -
+                               (posix.subseconds() < 0))));
+    EXPECT_EQ(leaps.toPosix(tai), posix);
+  }
+  EXPECT_EQ(leaps.toTai(utc(2024, 1, 1, 0)),
+      utc(2024, 1, 1, 0) + Duration<>(37));
+  EXPECT_EQ(leaps.toTai(Moment<>(SecondsTraits<>::Max)).category(),
+      Category::InfP);
+  EXPECT_EQ(leaps.toPosix(Moment<>(SecondsTraits<>::Min)).category(),
+      Category::InfN);
+  EXPECT_EQ(leaps.toTai(Moment<>(Category::NaN)).category(), Category::NaN);
+
+  // The leap second at the end of 2016 is 23:59:60 in UTC, and holds at
+  // 23:59:59 in POSIX time.
+  Moment<> before = fromCivil(CivilTime{2016, 12, 31, 23, 59, 59, 0});
+  Moment<> leap = leaps.fromUtc(CivilTime{2016, 12, 31, 23, 59, 60, 250});
+  EXPECT_EQ(leap, leaps.toTai(before) + Duration<>(1, 250));
+  EXPECT_EQ(leaps.toTai(utc(2017, 1, 1, 0)) + Duration<>(0, 250),
+      leap + Duration<>(1));
+  EXPECT_EQ(leaps.toPosix(leap), before + Duration<>(0, 250));
+  CivilTime t{};
+  ASSERT_TRUE(leaps.toUtc(leap, t));
+  EXPECT_EQ(t.year, 2016);
+  EXPECT_EQ(t.second, 60);
+  EXPECT_EQ(t.picos, 250);
+  ASSERT_TRUE(leaps.toUtc(leap + Duration<>(1), t));
+  EXPECT_EQ(t.year, 2017);
+  EXPECT_EQ(t.second, 0);
+  ASSERT_TRUE(leaps.toUtc(leaps.toTai(before), t));
+  EXPECT_EQ(t.second, 59);
+  EXPECT_FALSE(leaps.toUtc(Moment<>(Category::InfP), t));
+  EXPECT_EQ(leaps.fromUtc(CivilTime{2016, 12, 31, 23, 59, 59, 0}),
+      leaps.toTai(before));
+  EXPECT_EQ(leaps.fromUtc(CivilTime{2017, 12, 31, 23, 59, 60, 0}).category(),
+      Category::NaN);
+  EXPECT_EQ(leaps.fromUtc(CivilTime{2016, 12, 31, 23, 58, 60, 0}).category(),
+      Category::NaN);
+
+  // The list installed on this machine, if there is one, agrees with the one
+  // compiled in until whichever of them expires first.
+  LeapSeconds loaded;
+  if (loaded.loadList("/usr/share/zoneinfo/leap-seconds.list") ==
+      LeapError::None) {
+    Moment<> until = std::min(loaded.expires(), leaps.expires());
+    for (int year = 1960; utc(year, 1, 1, 0) < until; ++year)
+      EXPECT_EQ(loaded.offset(utc(year, 1, 1, 0).seconds()),
+          leaps.offset(utc(year, 1, 1, 0).seconds()));
+  }
+  EXPECT_EQ(loaded.loadList("no/such/list"), LeapError::File);
+
+  // A list of its own, with a removed second, which no UTC time reads.
+  LeapSeconds custom;
+  ASSERT_EQ(custom.readList("# Made up\n"
+                            "3600000000\t40\t# 2014\n"
+                            "3700000000 41\r\n"
+                            "3800000000 40\n"
+                            "#@ 3900000000\n"),
+      LeapError::None);
+  EXPECT_EQ(custom.size(), 3u);
+  Moment<> ntp = utc(1900, 1, 1, 0);
+  EXPECT_EQ(custom.expires(), ntp + Duration<>(3'900'000'000));
+  EXPECT_EQ(custom.toTai(ntp + Duration<>(3'799'999'999)),
+      ntp + Duration<>(3'800'000'040));
+  EXPECT_EQ(custom.toTai(ntp + Duration<>(3'800'000'000)),
+      ntp + Duration<>(3'800'000'040));
+  EXPECT_EQ(custom.toPosix(ntp + Duration<>(3'800'000'040)),
+      ntp + Duration<>(3'800'000'000));
+  EXPECT_EQ(custom.toPosix(ntp + Duration<>(3'700'000'040)),
+      ntp + Duration<>(3'699'999'999));
+  ASSERT_EQ(custom.readList("3600000000 40\n"), LeapError::None);
+  EXPECT_EQ(custom.expires(), ntp + Duration<>(3'600'000'000));
+
+  // Bad lists are rejected, and leave the table as it was.
+  for (auto [text, error] : {pair{"", LeapError::Size},
+           pair{"# Nothing\n", LeapError::Size},
+           pair{"3600000000\n", LeapError::Format},
+           pair{"3600000000 40 1\n", LeapError::Format},
+           pair{"x 40\n", LeapError::Format},
+           pair{"-1 40\n", LeapError::Format},
+           pair{"99999999999999999999 40\n", LeapError::Format},
+           pair{"#@ soon\n3600000000 40\n", LeapError::Format},
+           pair{"3600000000 40\n3600000000 41\n", LeapError::Order},
+           pair{"3600000000 40\n3500000000 41\n", LeapError::Order},
+           pair{"3600000000 40\n3700000000 42\n", LeapError::Order}}) {
+    EXPECT_EQ(custom.readList(text), error) << text;
+    EXPECT_EQ(custom.size(), 1u);
+  }
+  string tooMany;
+  for (int i = 0; i <= 64; ++i)
+    tooMany += to_string(3'000'000'000 + i * 1'000) + ' ' +
+        to_string(10 + i % 2) + '\n';
+  EXPECT_EQ(custom.readList(tooMany), LeapError::Size);
+  EXPECT_EQ(asString(LeapError::Order), "Order");
+
+  // Columns agree with converting each moment, both in whole blocks of
+  // recent times and in mixed ones.
+  MomentColumn column;
+  mt19937_64 gen(7);
+  uniform_int_distribution<int64_t> seconds(0, 400'000'000);
+  for (int i = 0; i < 64; ++i)
+    column.push_back(utc(2017, 1, 1, 0) + Duration<>(seconds(gen), -1));
+  for (int i = 0; i < 1'000; ++i)
+    column.push_back(utc(1960, 1, 1, 0) + Duration<>(seconds(gen) * 5, 3));
+  column.push_back(leap);
+  column.push_back(Moment<>(Category::NaN));
+  column.push_back(Moment<>(SecondsTraits<>::Max, PicosPerSecond - 1));
+  column.push_back(Moment<>(SecondsTraits<>::Max - 20));
+  column.push_back(Moment<>(SecondsTraits<>::Min, 1 - PicosPerSecond));
+  column.push_back(Moment<>(1) + Duration<>(0, -5));
+  MomentColumn tai = column, posix = column;
+  leaps.toTai(tai);
+  leaps.toPosix(posix);
+  for (size_t i = 0; i < column.size(); ++i) {
+    EXPECT_EQ(tai.value(i), leaps.toTai(column[i]).value()) << i;
+    EXPECT_EQ(posix.value(i), leaps.toPosix(column[i]).value()) << i;
+  }
+}
+
+TEST(Clock, ChronosTest) {
+  // The kernel clocks agree with the C library, and with each other. The C
+  // library may read a coarser clock, which lags by up to a tick, so the
+  // bound after is a second further out.
+  Moment<> before(UnixEpochSeconds + time(nullptr));
+  Moment<> realtime = now();
+  Moment<> after(UnixEpochSeconds + time(nullptr) + 2);
+  EXPECT_GE(realtime, before);
+  EXPECT_LE(realtime, after);
+  EXPECT_GE(realtime.subseconds(), 0);
+  EXPECT_EQ(realtime.subseconds() % 1'000, 0);
+  // TAI is ahead by the current offset, whether the kernel has it or not.
+  Moment<> utcNow = now();
+  Moment<> taiNow = now<ClockSource::Tai>();
+  const Duration<> offset(details::BuiltinLeapSeconds.offset(utcNow.seconds()));
+  EXPECT_EQ(offset, Duration<>(37));
+  EXPECT_GE(taiNow - utcNow, offset - Duration<>(0, PicosPerSecond / 10));
+  EXPECT_LE(taiNow - utcNow, offset + Duration<>(0, PicosPerSecond / 10));
+  Moment<> monotonic = now<ClockSource::Monotonic>();
+  EXPECT_GE(now<ClockSource::Monotonic>(), monotonic);
+  EXPECT_LT(monotonic, realtime);
+
+  // The counter tracks its reference closely, before and after calibrating
+  // again, and falls back to it where it isn't invariant.
+  for (ClockSource source : {ClockSource::Realtime, ClockSource::Monotonic}) {
+    TscClock clock(source, Duration<>(0, PicosPerSecond / 100));
+    const Duration<> slack(0, PicosPerSecond / 100);
+    Moment<> reading = clock.now();
+    Moment<> reference = source == ClockSource::Realtime
+        ? now()
+        : now<ClockSource::Monotonic>();
+    EXPECT_LE(reading, reference);
+    EXPECT_LT(reference - reading, slack);
+    if (!clock.invariant()) continue;
+    EXPECT_GT(clock.scale(), 0u);
+    Duration<> drift = clock.recalibrate();
+    EXPECT_LT(drift, slack);
+    EXPECT_GT(drift, Duration<>() - slack);
+
+    // Reading through a few periods, each of which calibrates again.
+    Moment<> last = clock.now();
+    const Moment<> end = last + Duration<>(0, PicosPerSecond / 20);
+    while (last < end) {
+      Moment<> next = clock.now();
+      ASSERT_GT(next, last - slack);
+      last = next;
+    }
+  }
+  // A bad period is taken as a second.
+  TscClock taiClock(ClockSource::Tai, Duration<>(Category::NaN));
+  Duration<> lag = now<ClockSource::Tai>() - taiClock.now();
+  EXPECT_LT(lag, Duration<>(1));
+  EXPECT_GT(lag, Duration<>(-1));
+}
+
+TEST(CoarseClock, ChronosTest) {
+  // Readings are truncated to the millisecond, lag the kernel clock by little
+  // more than the interval, and keep up with it.
+  const Duration<> millisecond(0, PicosPerSecond / 1'000);
+  const Duration<> slack(0, PicosPerSecond / 5);
+  CoarseClock clock;
+  EXPECT_TRUE(clock.running());
+  Moment<> first = clock.now();
+  Moment<> kernel = now();
+  EXPECT_LE(first, kernel);
+  EXPECT_LT(kernel - first, slack);
+  EXPECT_EQ(first.subseconds() % (PicosPerSecond / 1'000), 0);
+  this_thread::sleep_for(chrono::milliseconds(20));
+  Moment<> later = clock.now();
+  EXPECT_GT(later, first + millisecond);
+  EXPECT_LT(now() - later, slack);
+
+  // Once stopped, it reads the kernel clock, at the same precision.
+  clock.stop();
+  EXPECT_FALSE(clock.running());
+  clock.stop();
+  Moment<> stopped = clock.now();
+  EXPECT_GE(stopped, later);
+  EXPECT_EQ(stopped.subseconds() % (PicosPerSecond / 1'000), 0);
+
+  // Whole seconds, from the monotonic clock, and bad settings, which are
+  // taken as a millisecond and no truncation.
+  CoarseClock seconds(ClockSource::Monotonic, Duration<>(0, 1'000),
+      Duration<>(1));
+  EXPECT_EQ(seconds.now().subseconds(), 0);
+  EXPECT_LE(seconds.now(), now<ClockSource::Monotonic>());
+  CoarseClock bad(ClockSource::Tai, Duration<>(Category::NaN),
+      Duration<>(0) - millisecond);
+  EXPECT_LT(now<ClockSource::Tai>() - bad.now(), slack);
+
+  // Readers on other threads never see it go back.
+  vector<thread> readers;
+  atomic<bool> backward{false};
+  for (int i = 0; i < 4; ++i)
+    readers.emplace_back([&] {
+      Moment<> last = seconds.now();
+      for (int j = 0; j < 100'000; ++j) {
+        Moment<> next = seconds.now();
+        if (next < last) backward = true;
+        last = next;
+      }
+    });
+  for (thread& reader : readers) reader.join();
+  EXPECT_FALSE(backward);
+}
+
+TEST(Interop, ChronosTest) {
+  using namespace std::chrono;
+  using T = SecondsTraits<>;
+  const Duration<> oneAndHalf(1, PicosPerSecond / 2);
+  const Duration<> minusHalf = Duration<>(0, -PicosPerSecond / 2);
+
+  // Standard periods, both ways, exactly.
+  EXPECT_EQ(fromChrono(nanoseconds(1'500'000'000)), oneAndHalf);
+  EXPECT_EQ(fromChrono(nanoseconds(-500'000'000)), minusHalf);
+  EXPECT_EQ(fromChrono(milliseconds(-1'500)), Duration<>(0) - oneAndHalf);
+  EXPECT_EQ(fromChrono(hours(3)), Duration<>(10'800));
+  EXPECT_EQ(fromChrono(duration<int32_t, pico>(7)), Duration<>(0, 7));
+  using Quarters = duration<int64_t, ratio<1, 4>>;
+  EXPECT_EQ(fromChrono(Quarters(-5)),
+      Duration<>(-1) + Duration<>(0, -PicosPerSecond / 4));
+  EXPECT_EQ(toChrono<nanoseconds>(oneAndHalf), nanoseconds(1'500'000'000));
+  EXPECT_EQ(toChrono<microseconds>(minusHalf), microseconds(-500'000));
+  EXPECT_EQ(toChrono<seconds>(oneAndHalf), seconds(1));
+  EXPECT_EQ(toChrono<seconds>(Duration<>(0) - oneAndHalf), seconds(-1));
+  EXPECT_EQ(toChrono<minutes>(Duration<>(-179)), minutes(-2));
+  using Picos = duration<int64_t, pico>;
+  EXPECT_EQ(toChrono<Picos>(Duration<>(0, 3)), Picos(3));
+  EXPECT_EQ(toChrono<duration<double>>(oneAndHalf), duration<double>(1.5));
+  EXPECT_EQ(fromChrono(duration<double, milli>(-1.5)),
+      Duration<>(0, -PicosPerSecond / 1'000 * 3 / 2));
+
+  // Out of range, both ways, and the special values.
+  EXPECT_EQ(fromChrono(seconds(T::Max)), Duration<>(T::Max));
+  EXPECT_EQ(fromChrono(seconds(-T::Max)), Duration<>(-T::Max));
+  EXPECT_EQ(fromChrono(minutes(INT64_MAX / 30)).category(), Category::InfP);
+  EXPECT_EQ(fromChrono(nanoseconds::max()).category(), Category::InfP);
+  EXPECT_EQ(fromChrono(nanoseconds(-INT64_MAX)).category(), Category::InfN);
+  EXPECT_EQ(fromChrono(nanoseconds::min()).category(), Category::NaN);
+  EXPECT_EQ(fromChrono(duration<double>(1e30)).category(), Category::InfP);
+  EXPECT_EQ(fromChrono(duration<double>(-INFINITY)).category(),
+      Category::InfN);
+  EXPECT_EQ(fromChrono(duration<double>(NAN)).category(), Category::NaN);
+  EXPECT_EQ(toChrono<nanoseconds>(Duration<>(T::Max)), nanoseconds::max());
+  EXPECT_EQ(toChrono<nanoseconds>(Duration<>(-9'223'372'036, -1)),
+      nanoseconds(-9'223'372'036'000'000'000));
+  EXPECT_EQ(toChrono<nanoseconds>(Duration<>(9'223'372'036, 854'775'807'000)),
+      nanoseconds(INT64_MAX));
+  EXPECT_EQ(toChrono<nanoseconds>(Duration<>(9'223'372'036, 854'775'808'000)),
+      nanoseconds::max());
+  using Millis32 = duration<int32_t, milli>;
+  EXPECT_EQ(toChrono<Millis32>(Duration<>(-3'000'000)), Millis32(-INT32_MAX));
+  EXPECT_EQ(toChrono<nanoseconds>(Duration<>(Category::InfN)),
+      nanoseconds(-INT64_MAX));
+  EXPECT_EQ(toChrono<nanoseconds>(Duration<>(Category::NaN)),
+      nanoseconds::min());
+  EXPECT_TRUE(isnan(toChrono<duration<double>>(Duration<>(Category::NaN))
+                        .count()));
+  for (nanoseconds ns : {nanoseconds(0), nanoseconds(-1), nanoseconds::max(),
+           nanoseconds::min(), nanoseconds(-INT64_MAX), nanoseconds(12'345)})
+    EXPECT_EQ(toChrono<nanoseconds>(fromChrono(ns)), ns);
+
+  // Time points, from the Unix epoch for the system clock.
+  Moment<> moment = utc(2024, 2, 29, 12) + Duration<>(0, 123'456'000'000);
+  auto sys = toChrono<sys_time<nanoseconds>>(moment);
+  EXPECT_EQ(sys.time_since_epoch(),
+      nanoseconds(1'709'208'000'123'456'000));
+  EXPECT_EQ(fromChrono(sys), moment);
+  EXPECT_EQ(fromChrono(time_point_cast<seconds>(sys)), utc(2024, 2, 29, 12));
+  EXPECT_LT(fromChrono(system_clock::now()) - now(), Duration<>(1));
+  auto steady = toChrono<steady_clock::time_point>(Moment<>(5));
+  EXPECT_EQ(steady.time_since_epoch(), seconds(5));
+
+  // POSIX structures, as moments and as durations, with the fraction kept
+  // from zero up.
+  timespec ts{1'709'208'000, 123'456'000};
+  EXPECT_EQ(fromTimespec(ts), moment);
+  EXPECT_EQ(fromTimespec<Duration<>>(timespec{-2, 500'000'000}),
+      Duration<>(-1) + minusHalf);
+  EXPECT_EQ(fromTimespec(timespec{0, NanosPerSecond}).category(),
+      Category::NaN);
+  EXPECT_EQ(fromTimespec(timespec{0, -1}).category(), Category::NaN);
+  EXPECT_EQ(fromTimespec(timespec{INT64_MAX, 0}).category(), Category::InfP);
+  EXPECT_EQ(fromTimespec<Duration<>>(timespec{INT64_MIN, 1}).category(),
+      Category::InfN);
+  EXPECT_EQ(fromTimespec<Duration<>>(timespec{T::Min - 1, 1}),
+      Duration<>(T::Min, 1 - PicosPerSecond + 999));
+  timespec back{};
+  ASSERT_TRUE(toTimespec(moment + Duration<>(0, 999), back));
+  EXPECT_EQ(back.tv_sec, ts.tv_sec);
+  EXPECT_EQ(back.tv_nsec, ts.tv_nsec);
+  ASSERT_TRUE(toTimespec(Duration<>(-1) + minusHalf, back));
+  EXPECT_EQ(back.tv_sec, -2);
+  EXPECT_EQ(back.tv_nsec, 500'000'000);
+  ASSERT_TRUE(toTimespec(Moment<>(Category::InfP), back));
+  EXPECT_EQ(back.tv_sec, numeric_limits<time_t>::max());
+  EXPECT_EQ(back.tv_nsec, NanosPerSecond - 1);
+  ASSERT_TRUE(toTimespec(Duration<>(Category::InfN), back));
+  EXPECT_EQ(back.tv_sec, numeric_limits<time_t>::min());
+  ASSERT_TRUE(toTimespec(Moment<>(UnitValue{T::Min, 0}), back));
+  EXPECT_EQ(back.tv_sec, numeric_limits<time_t>::min());
+  EXPECT_EQ(back.tv_nsec, 0);
+  ASSERT_TRUE(toTimespec(Moment<>(UnitValue{T::Max, 0}), back));
+  EXPECT_EQ(back.tv_sec, T::Max - UnixEpochSeconds);
+  EXPECT_FALSE(toTimespec(Moment<>(Category::NaN), back));
+#if __has_include(<sys/time.h>)
+  timeval tv{1'709'208'000, 123'456};
+  EXPECT_EQ(fromTimeval(tv), moment);
+  EXPECT_EQ(fromTimeval(timeval{0, MicrosPerSecond}).category(),
+      Category::NaN);
+  timeval tvBack{};
+  ASSERT_TRUE(toTimeval(moment + Duration<>(0, 999'999), tvBack));
+  EXPECT_EQ(tvBack.tv_sec, tv.tv_sec);
+  EXPECT_EQ(tvBack.tv_usec, tv.tv_usec);
+  ASSERT_TRUE(toTimeval(Duration<>(0) - oneAndHalf, tvBack));
+  EXPECT_EQ(tvBack.tv_sec, -2);
+  EXPECT_EQ(tvBack.tv_usec, 500'000);
+  using TimevalSeconds = decltype(timeval::tv_sec);
+  ASSERT_TRUE(toTimeval(Moment<>(UnitValue{T::Min, 0}), tvBack));
+  EXPECT_EQ(tvBack.tv_sec, numeric_limits<TimevalSeconds>::min());
+  EXPECT_EQ(tvBack.tv_usec, 0);
+#endif
+
+  // Arrays of timespecs agree with converting each, in whole blocks of
+  // recent times and in mixed ones, and convert back.
+  vector<timespec> stamps;
+  mt19937_64 gen(11);
+  uniform_int_distribution<time_t> secs(1'600'000'000, 1'800'000'000);
+  uniform_int_distribution<long> nanos(0, NanosPerSecond - 1);
+  for (int i = 0; i < 100; ++i) stamps.push_back({secs(gen), nanos(gen)});
+  for (timespec edge : {timespec{-1, 5}, timespec{0, -1},
+           timespec{INT64_MAX, 0}, timespec{INT64_MIN, 0},
+           timespec{int64_t{1} << 40, 0}})
+    stamps.push_back(edge);
+  for (int i = 0; i < 20; ++i) stamps.push_back({secs(gen), nanos(gen)});
+  MomentColumn column;
+  fromTimespecs(stamps.data(), stamps.size(), column);
+  ASSERT_EQ(column.size(), stamps.size());
+  for (size_t i = 0; i < stamps.size(); ++i)
+    EXPECT_EQ(column.value(i), fromTimespec(stamps[i]).value()) << i;
+  vector<timespec> round(stamps.size());
+  toTimespecs(column.seconds(), column.subseconds(), round.data(),
+      column.size());
+  for (size_t i = 0; i < 100; ++i) {
+    EXPECT_EQ(round[i].tv_sec, stamps[i].tv_sec);
+    EXPECT_EQ(round[i].tv_nsec, stamps[i].tv_nsec);
+  }
+  EXPECT_EQ(round[101].tv_sec, 0);
+  EXPECT_EQ(round[101].tv_nsec, 0);
+}